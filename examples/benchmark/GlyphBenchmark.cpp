@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/System/Clock.hpp>
+#include <iomanip>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+
+namespace
+{
+    // Character size of the glyphs
+    const unsigned int characterSize = 30;
+
+    // Number of characters of each run of text
+    const std::size_t runLength = 4096;
+
+    // Number of timed passes over each run
+    const int repeatCount = 200;
+
+    // Build a run of text cycling through the code points of the given ranges
+    std::vector<sf::Uint32> makeRun(const sf::Uint32 ranges[][2], std::size_t rangeCount)
+    {
+        std::vector<sf::Uint32> codePoints;
+        for (std::size_t i = 0; i < rangeCount; ++i)
+            for (sf::Uint32 codePoint = ranges[i][0]; codePoint <= ranges[i][1]; ++codePoint)
+                codePoints.push_back(codePoint);
+
+        std::vector<sf::Uint32> run(runLength);
+        for (std::size_t i = 0; i < runLength; ++i)
+            run[i] = codePoints[(i * 7) % codePoints.size()];
+
+        return run;
+    }
+
+    // Measure the average time of Font::getGlyph, in nanoseconds per character
+    double measureGlyphs(const sf::Font& font, const std::vector<sf::Uint32>& run, float& checksum)
+    {
+        sf::Clock clock;
+        for (int pass = 0; pass < repeatCount; ++pass)
+            for (std::size_t i = 0; i < run.size(); ++i)
+                checksum += font.getGlyph(run[i], characterSize, false).advance;
+
+        return clock.getElapsedTime().asMicroseconds() * 1000.0 / (static_cast<double>(run.size()) * repeatCount);
+    }
+
+    // Measure the average time of Font::getKerning, in nanoseconds per pair of characters
+    double measureKerning(const sf::Font& font, const std::vector<sf::Uint32>& run, float& checksum)
+    {
+        sf::Clock clock;
+        for (int pass = 0; pass < repeatCount; ++pass)
+            for (std::size_t i = 1; i < run.size(); ++i)
+                checksum += font.getKerning(run[i - 1], run[i], characterSize);
+
+        return clock.getElapsedTime().asMicroseconds() * 1000.0 / (static_cast<double>(run.size() - 1) * repeatCount);
+    }
+
+    // Measure and print the costs of a run of text
+    void benchmark(const sf::Font& font, const char* name, const std::vector<sf::Uint32>& run)
+    {
+        float checksum = 0;
+
+        // The first pass loads the glyphs and the kerning pairs, the next ones only look them up
+        sf::Clock clock;
+        for (std::size_t i = 0; i < run.size(); ++i)
+            checksum += font.getGlyph(run[i], characterSize, false).advance;
+        for (std::size_t i = 1; i < run.size(); ++i)
+            checksum += font.getKerning(run[i - 1], run[i], characterSize);
+        double firstPass = clock.getElapsedTime().asMicroseconds() / 1000.0;
+
+        double glyphs  = measureGlyphs(font, run, checksum);
+        double kerning = measureKerning(font, run, checksum);
+
+        std::cout << std::setw(10) << name
+                  << std::setw(14) << glyphs
+                  << std::setw(14) << kerning
+                  << std::setw(14) << firstPass
+                  << "   (checksum " << checksum << ")" << std::endl;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \param argc Number of arguments
+/// \param argv Arguments: optional path of the font to use
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    // Load the font
+    const char* filename = (argc > 1) ? argv[1] : "resources/sansation.ttf";
+    sf::Font font;
+    if (!font.loadFromFile(filename))
+        return EXIT_FAILURE;
+
+    // Printable ASCII and Latin-1 supplement
+    const sf::Uint32 latin1[][2] = {{0x20, 0x7E}, {0xA0, 0xFF}};
+
+    // Latin extended-A, Greek and Cyrillic
+    const sf::Uint32 others[][2] = {{0x100, 0x17F}, {0x391, 0x3C9}, {0x410, 0x44F}};
+
+    std::cout << "Cost of the glyph lookups of " << filename << " at size " << characterSize << std::endl;
+    std::cout << "(runs of " << runLength << " characters, " << repeatCount << " passes)" << std::endl << std::endl;
+
+    std::cout << std::setw(10) << "run"
+              << std::setw(14) << "getGlyph"
+              << std::setw(14) << "getKerning"
+              << std::setw(14) << "first pass"
+              << std::endl;
+    std::cout << std::setw(10) << ""
+              << std::setw(14) << "(ns/char)"
+              << std::setw(14) << "(ns/pair)"
+              << std::setw(14) << "(ms)"
+              << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    benchmark(font, "latin-1", makeRun(latin1, sizeof(latin1) / sizeof(*latin1)));
+    benchmark(font, "other", makeRun(others, sizeof(others) / sizeof(*others)));
+
+    return EXIT_SUCCESS;
+}
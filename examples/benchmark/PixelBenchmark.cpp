@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/PixelKernels.hpp>
+#include <SFML/System/Clock.hpp>
+#include <iomanip>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+
+namespace
+{
+    // Size of the arrays processed by each call (a 1024x1024 image)
+    const std::size_t pixelCount = 1024 * 1024;
+
+    // Number of timed calls of each routine
+    const int repeatCount = 50;
+
+    // Routines to measure
+    enum Routine
+    {
+        Fill,
+        Mask,
+        Blend,
+        Reverse,
+        Premultiply,
+        Downsample,
+        RoutineCount
+    };
+
+    const char* routineNames[RoutineCount] = {"fill", "mask", "blend", "reverse", "premultiply", "downsample"};
+
+    // Implementations to compare
+    const sf::priv::PixelKernelSet sets[] = {sf::priv::ScalarKernels, sf::priv::Sse2Kernels, sf::priv::Avx2Kernels, sf::priv::NeonKernels};
+    const char* setNames[] = {"scalar", "sse2", "avx2", "neon"};
+    const std::size_t setCount = sizeof(sets) / sizeof(*sets);
+
+    // Call a routine once on the whole array
+    void run(Routine routine, std::vector<sf::Uint8>& destination, const std::vector<sf::Uint8>& source)
+    {
+        switch (routine)
+        {
+            case Fill :
+                sf::priv::fillPixels(&destination[0], pixelCount, sf::Color(10, 20, 30, 40));
+                break;
+
+            case Mask :
+                sf::priv::maskPixels(&destination[0], pixelCount, sf::Color(10, 20, 30, 40), 0);
+                break;
+
+            case Blend :
+                sf::priv::blendPixels(&destination[0], &source[0], pixelCount);
+                break;
+
+            case Reverse :
+                sf::priv::reversePixels(&destination[0], pixelCount);
+                break;
+
+            case Premultiply :
+                sf::priv::premultiplyPixels(&destination[0], pixelCount);
+                break;
+
+            case Downsample :
+                // The source is read as a single pair of rows
+                sf::priv::downsamplePixels(&destination[0], &source[0], &source[pixelCount * 2], pixelCount / 4);
+                break;
+
+            default :
+                break;
+        }
+    }
+
+    // Measure the average time of a routine, in nanoseconds per pixel
+    double measure(Routine routine, std::vector<sf::Uint8>& destination, const std::vector<sf::Uint8>& source)
+    {
+        // Warm the caches and the branch predictors up first
+        run(routine, destination, source);
+
+        sf::Clock clock;
+        for (int i = 0; i < repeatCount; ++i)
+            run(routine, destination, source);
+
+        return clock.getElapsedTime().asMicroseconds() * 1000.0 / (static_cast<double>(pixelCount) * repeatCount);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    // Fill the source with arbitrary pixels, with all kinds of alpha values
+    std::vector<sf::Uint8> source(pixelCount * 4);
+    for (std::size_t i = 0; i < source.size(); ++i)
+        source[i] = static_cast<sf::Uint8>((i * 2654435761u) >> 13);
+    std::vector<sf::Uint8> destination(source);
+
+    sf::priv::PixelKernelSet best = sf::priv::getPixelKernelSet();
+
+    std::cout << "Time per pixel, in nanoseconds, of each implementation of the pixel routines" << std::endl;
+    std::cout << "(" << pixelCount << " pixels per call, " << repeatCount << " calls)" << std::endl << std::endl;
+
+    std::cout << std::setw(12) << "";
+    for (std::size_t i = 0; i < setCount; ++i)
+        std::cout << std::setw(10) << setNames[i];
+    std::cout << std::endl;
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (int routine = 0; routine < RoutineCount; ++routine)
+    {
+        std::cout << std::setw(12) << routineNames[routine];
+        for (std::size_t i = 0; i < setCount; ++i)
+        {
+            if (sf::priv::setPixelKernelSet(sets[i]))
+                std::cout << std::setw(10) << measure(static_cast<Routine>(routine), destination, source);
+            else
+                std::cout << std::setw(10) << "-";
+        }
+        std::cout << std::endl;
+    }
+
+    sf::priv::setPixelKernelSet(best);
+    std::cout << std::endl << "Implementation selected by default: " << setNames[best] << std::endl;
+
+    return EXIT_SUCCESS;
+}
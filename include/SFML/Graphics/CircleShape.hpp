@@ -74,9 +74,12 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Set the number of points of the circle
     ///
+    /// If the adaptive point count is enabled, this is the
+    /// maximum number of points of the circle.
+    ///
     /// \param count New number of points of the circle
     ///
-    /// \see getPointCount
+    /// \see getPointCount, setAdaptivePointCount
     ///
     ////////////////////////////////////////////////////////////
     void setPointCount(unsigned int count);
@@ -84,6 +87,9 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Get the number of points of the shape
     ///
+    /// If the adaptive point count is enabled, this is the
+    /// number of points used the last time the circle was drawn.
+    ///
     /// \return Number of points of the shape
     ///
     /// \see setPointCount
@@ -91,6 +97,36 @@ public :
     ////////////////////////////////////////////////////////////
     virtual unsigned int getPointCount() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the adaptive point count
+    ///
+    /// When the adaptive point count is enabled, the number
+    /// of points of the circle is chosen every time it is drawn,
+    /// from its radius in pixels on the render target: small or
+    /// far away circles use fewer points, while keeping their
+    /// edges within half a pixel of a perfect circle. The number
+    /// set with setPointCount is then the maximum number of points.
+    /// This should not be enabled for regular polygons, whose
+    /// number of sides would change.
+    /// The adaptive point count is disabled by default.
+    ///
+    /// \param adaptive True to enable the adaptive point count, false to disable it
+    ///
+    /// \see isAdaptivePointCount
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAdaptivePointCount(bool adaptive);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the adaptive point count is enabled or not
+    ///
+    /// \return True if the adaptive point count is enabled, false if not
+    ///
+    /// \see setAdaptivePointCount
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isAdaptivePointCount() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Get a point of the shape
     ///
@@ -105,11 +141,22 @@ public :
 
 private :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the circle to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    float        m_radius;     ///< Radius of the circle
-    unsigned int m_pointCount; ///< Number of points composing the circle
+    float                m_radius;             ///< Radius of the circle
+    unsigned int         m_pointCount;         ///< Number of points composing the circle
+    bool                 m_adaptive;           ///< Is the number of points chosen from the size on screen?
+    mutable unsigned int m_adaptivePointCount; ///< Number of points chosen the last time the circle was drawn
 };
 
 } // namespace sf
@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_COMMANDLIST_HPP
+#define SFML_COMMANDLIST_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <vector>
+#include <cstddef>
+
+
+namespace sf
+{
+class VertexArray;
+class VertexBuffer;
+
+////////////////////////////////////////////////////////////
+/// \brief List of drawing commands, recorded without
+///        OpenGL and replayed later on a render target
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API CommandList : public Drawable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty list.
+    ///
+    ////////////////////////////////////////////////////////////
+    CommandList();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record the clearing of the target with a single color
+    ///
+    /// \param color Fill color to use to clear the render target
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear(const Color& color = Color(0, 0, 0, 255));
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record a change of the current view
+    ///
+    /// The view is copied, and applies to the commands
+    /// recorded after this one.
+    ///
+    /// \param view New view to use
+    ///
+    ////////////////////////////////////////////////////////////
+    void setView(const View& view);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record the drawing of primitives defined by an array of vertices
+    ///
+    /// The vertices are copied into the list.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const Vertex* vertices, unsigned int vertexCount,
+              PrimitiveType type, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record the drawing of a vertex array
+    ///
+    /// The vertices are copied into the list.
+    ///
+    /// \param vertices Vertex array to draw
+    /// \param states   Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const VertexArray& vertices, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record the drawing of a range of the primitives stored in a vertex buffer
+    ///
+    /// The buffer is not copied, it must exist until the list
+    /// is replayed and its contents are the ones that it has
+    /// at that time.
+    ///
+    /// \param vertexBuffer Vertex buffer containing the primitives
+    /// \param firstVertex  Index of the first vertex to draw
+    /// \param vertexCount  Number of vertices to draw
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const VertexBuffer& vertexBuffer, unsigned int firstVertex,
+              unsigned int vertexCount, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the recorded commands
+    ///
+    /// The memory used by the list is kept, so that a list
+    /// recorded again every frame doesn't allocate.
+    ///
+    ////////////////////////////////////////////////////////////
+    void reset();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of recorded commands
+    ///
+    /// \return Number of commands in the list
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCommandCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the list is empty or not
+    ///
+    /// \return True if no command was recorded
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isEmpty() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replay the commands of the list on a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Render states, whose transform is combined with the recorded ones
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Types of commands
+    ///
+    ////////////////////////////////////////////////////////////
+    enum CommandType
+    {
+        Clear,           ///< Clear the target
+        SetView,         ///< Change the view
+        DrawVertices,    ///< Draw vertices stored in the list
+        DrawVertexBuffer ///< Draw a range of a vertex buffer
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Recorded command
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Command
+    {
+        CommandType         type;          ///< Type of the command
+        RenderStates        states;        ///< Render states of the draw commands
+        PrimitiveType       primitiveType; ///< Type of primitives of DrawVertices commands
+        const VertexBuffer* vertexBuffer;  ///< Vertex buffer of DrawVertexBuffer commands
+        unsigned int        first;         ///< Index of the first vertex, or of the view of SetView commands
+        unsigned int        count;         ///< Number of vertices to draw
+        Color               color;         ///< Color of Clear commands
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Command> m_commands; ///< Recorded commands, in order
+    std::vector<Vertex>  m_vertices; ///< Vertices of the DrawVertices commands
+    std::vector<View>    m_views;    ///< Views of the SetView commands
+};
+
+} // namespace sf
+
+
+#endif // SFML_COMMANDLIST_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::CommandList
+/// \ingroup graphics
+///
+/// OpenGL calls can only be made from the thread where the
+/// render target's context is active, which makes it hard to
+/// spread the preparation of a frame over several threads.
+/// sf::CommandList records drawing commands (vertices with
+/// their render states, view changes, clears) without making
+/// any OpenGL call, so that it can be filled from any thread.
+/// The rendering thread then replays the lists by drawing
+/// them, in the order that it chooses.
+///
+/// Recording only copies data: a list can be recorded by one
+/// thread while other threads record other lists, and while
+/// the rendering thread draws the previous frame. A single
+/// list must not be used by several threads at the same time.
+///
+/// The vertices are copied into the list, but the textures,
+/// shaders and vertex buffers are referenced: they must stay
+/// alive until the list is replayed, and are used with the
+/// state (texture contents, shader parameters) that they have
+/// at that time.
+///
+/// When the list is drawn, its commands are executed in order:
+/// the recorded render states are used, combined with the
+/// transform given to draw; the recorded views are applied
+/// to the target, and the target's view is restored
+/// afterwards. Consecutive draw commands are batched by the
+/// render target like any other draw calls.
+///
+/// Usage example:
+/// \code
+/// // on each worker thread
+/// lists[i].reset();
+/// lists[i].setView(camera);
+/// for (each entity of the thread's part of the world)
+///     lists[i].draw(entity.vertices, 4, sf::Quads, entity.texture);
+///
+/// // on the rendering thread, once the workers are done
+/// window.clear();
+/// for (std::size_t i = 0; i < lists.size(); ++i)
+///     window.draw(lists[i]);
+/// window.display();
+/// \endcode
+///
+/// \see sf::RenderTarget
+///
+////////////////////////////////////////////////////////////
@@ -34,7 +34,6 @@
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/String.hpp>
-#include <map>
 #include <string>
 #include <vector>
 
@@ -142,6 +141,69 @@ public :
     ////////////////////////////////////////////////////////////
     const Glyph& getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a set of glyphs in advance
+    ///
+    /// Loading glyphs on demand, when a text first displays
+    /// them, costs a rasterization and a texture upload per
+    /// glyph in the middle of a frame. This function loads all
+    /// the missing glyphs of \a characters at once, typically
+    /// during a loading screen: they are rasterized in a row,
+    /// packed together and sent to the texture in a single upload.
+    ///
+    /// Call it once per character size (and style) to preload.
+    ///
+    /// If the glyphs don't fit in the texture of the font, they
+    /// are not preloaded; they are still loaded on demand later,
+    /// when the texture has room for them.
+    ///
+    /// \param characters    Characters whose glyphs must be loaded
+    /// \param characterSize Reference character size
+    /// \param bold          Load the bold versions or the regular ones?
+    ///
+    /// \return True if all the glyphs are loaded, false if they couldn't be preloaded
+    ///
+    /// \see getGlyph, saveGlyphCache
+    ///
+    ////////////////////////////////////////////////////////////
+    bool preloadGlyphs(const String& characters, unsigned int characterSize, bool bold = false) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Save the loaded glyphs to a cache file
+    ///
+    /// The file stores the texture of the glyphs and their
+    /// metrics, so that loadGlyphCache can restore them on the
+    /// next run without rasterizing anything. It is bound to
+    /// the font face and to the distance field mode that were
+    /// used to create it.
+    ///
+    /// \param filename Path of the cache file to write
+    ///
+    /// \return True if saving was successful
+    ///
+    /// \see loadGlyphCache, preloadGlyphs
+    ///
+    ////////////////////////////////////////////////////////////
+    bool saveGlyphCache(const std::string& filename) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Restore the glyphs saved by saveGlyphCache
+    ///
+    /// The glyphs loaded so far are replaced by those of the
+    /// cache. The font must be loaded first, with the same
+    /// face and distance field mode as when the cache was saved:
+    /// the kerning, the line spacing and the glyphs missing from
+    /// the cache still come from the font file.
+    ///
+    /// \param filename Path of the cache file to read
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see saveGlyphCache
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadGlyphCache(const std::string& filename);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the kerning offset of two glyphs
     ///
@@ -180,6 +242,11 @@ public :
     /// are requested, thus it is not very relevant. It is mainly
     /// used internally by sf::Text.
     ///
+    /// The glyphs of all the character sizes are packed into
+    /// the same texture, so that texts which use the same font
+    /// can be drawn together. The texture grows when it is full;
+    /// its previous contents are copied by the graphics card.
+    ///
     /// \param characterSize Reference character size
     ///
     /// \return Texture containing the glyphs of the requested size
@@ -188,48 +255,101 @@ public :
     const Texture& getTexture(unsigned int characterSize) const;
 
     ////////////////////////////////////////////////////////////
-    /// \brief Overload of assignment operator
+    /// \brief Enable or disable the distance field mode
     ///
-    /// \param right Instance to assign
+    /// In distance field mode, the glyphs are rasterized once,
+    /// at \a referenceSize, into a single texture which stores
+    /// in each pixel the distance to the outline of the glyph
+    /// instead of its coverage. sf::Text then scales them to
+    /// its character size and renders them with a dedicated
+    /// shader, which keeps the edges sharp at any scale and
+    /// applies the bold style and the outline without loading
+    /// new glyphs.
     ///
-    /// \return Reference to self
+    /// In this mode, getGlyph ignores the character size and the
+    /// bold flag: it returns the glyphs of the reference size.
+    ///
+    /// Changing the mode discards the glyphs loaded so far, so
+    /// it should be chosen before the font is used by texts.
+    /// The distance field mode is disabled by default.
+    ///
+    /// The mode can't be enabled if the system doesn't support
+    /// the shader (see isDistanceFieldAvailable): the glyphs then
+    /// remain rasterized at each character size.
+    ///
+    /// \param distanceField True to enable the distance field mode, false to disable it
+    /// \param referenceSize Character size at which the glyphs are rasterized
+    ///
+    /// \return True if the mode was changed, false if it is not supported
+    ///
+    /// \see isDistanceField, getDistanceFieldSize
     ///
     ////////////////////////////////////////////////////////////
-    Font& operator =(const Font& right);
+    bool setDistanceField(bool distanceField, unsigned int referenceSize = 64);
 
-private :
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the distance field mode is enabled or not
+    ///
+    /// \return True if the distance field mode is enabled, false if not
+    ///
+    /// \see setDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isDistanceField() const;
 
     ////////////////////////////////////////////////////////////
-    /// \brief Structure defining a row of glyphs
+    /// \brief Get the character size of the distance field glyphs
+    ///
+    /// \return Reference character size, or 0 if the distance field mode is disabled
+    ///
+    /// \see setDistanceField, getDistanceFieldSpread
     ///
     ////////////////////////////////////////////////////////////
-    struct Row
-    {
-        Row(unsigned int rowTop, unsigned int rowHeight) : width(0), top(rowTop), height(rowHeight) {}
+    unsigned int getDistanceFieldSize() const;
 
-        unsigned int width;  ///< Current width of the row
-        unsigned int top;    ///< Y position of the row into the texture
-        unsigned int height; ///< Height of the row
-    };
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the range of the distances stored in the distance field
+    ///
+    /// The alpha channel of the glyphs texture maps the distances
+    /// from -spread (0, outside) to +spread (255, inside) around
+    /// the outlines, which are at 128. Effects such as outlines
+    /// can't extend further than this distance.
+    ///
+    /// \return Spread of the distance field, in pixels of the reference size
+    ///
+    /// \see getDistanceFieldSize
+    ///
+    ////////////////////////////////////////////////////////////
+    float getDistanceFieldSpread() const;
 
     ////////////////////////////////////////////////////////////
-    // Types
+    /// \brief Tell whether or not the system supports the distance field mode
+    ///
+    /// The distance fields are rendered by a GLSL 1.30 program,
+    /// which requires OpenGL 3.0 and uniform buffer objects.
+    ///
+    /// \return True if the distance field mode is supported, false otherwise
+    ///
     ////////////////////////////////////////////////////////////
-    typedef std::map<Uint32, Glyph> GlyphTable; ///< Table mapping a codepoint to its glyph
+    static bool isDistanceFieldAvailable();
 
     ////////////////////////////////////////////////////////////
-    /// \brief Structure defining a page of glyphs
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
     ///
     ////////////////////////////////////////////////////////////
-    struct Page
-    {
-        Page();
+    Font& operator =(const Font& right);
+
+private :
 
-        GlyphTable       glyphs;  ///< Table mapping code points to their corresponding glyph
-        sf::Texture      texture; ///< Texture containing the pixels of the glyphs
-        unsigned int     nextRow; ///< Y position of the next new row in the texture
-        std::vector<Row> rows;    ///< List containing the position of all the existing rows
-    };
+    ////////////////////////////////////////////////////////////
+    /// \brief Page of glyphs, shared by all the character sizes
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Page;
 
     ////////////////////////////////////////////////////////////
     /// \brief Free all the internal resources
@@ -249,17 +369,55 @@ private :
     ////////////////////////////////////////////////////////////
     Glyph loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Rasterize a glyph into the pixel buffer
+    ///
+    /// The size of the pixels is stored in the texture rectangle
+    /// of the returned glyph, whose position is left to 0.
+    ///
+    /// \param codePoint     Unicode code point of the character to rasterize
+    /// \param characterSize Reference character size
+    /// \param bold          Rasterize the bold version or the regular one?
+    ///
+    /// \return The glyph corresponding to \a codePoint and \a characterSize
+    ///
+    ////////////////////////////////////////////////////////////
+    Glyph rasterizeGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the page of glyphs, creating it if necessary
+    ///
+    /// \return Page of glyphs
+    ///
+    ////////////////////////////////////////////////////////////
+    Page& getPage() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Find a suitable rectangle within the texture for a glyph
     ///
-    /// \param page   Page of glyphs to search in
+    /// The texture is enlarged if it has no room left.
+    ///
     /// \param width  Width of the rectangle
     /// \param height Height of the rectangle
     ///
     /// \return Found rectangle within the texture
     ///
     ////////////////////////////////////////////////////////////
-    IntRect findGlyphRect(Page& page, unsigned int width, unsigned int height) const;
+    IntRect findGlyphRect(unsigned int width, unsigned int height) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Convert the coverage of a glyph to a distance field
+    ///
+    /// The coverage is read from the alpha channel of the pixel
+    /// buffer, which is replaced by the distance field. The
+    /// buffer must have room for the field around the glyph.
+    ///
+    /// \param width  Width of the pixel buffer
+    /// \param height Height of the pixel buffer
+    /// \param spread Range of the distances stored in the field
+    ///
+    ////////////////////////////////////////////////////////////
+    void computeDistanceField(unsigned int width, unsigned int height, float spread) const;
 
     ////////////////////////////////////////////////////////////
     /// \brief Make sure that the given size is the current one
@@ -271,20 +429,16 @@ private :
     ////////////////////////////////////////////////////////////
     bool setCurrentSize(unsigned int characterSize) const;
 
-    ////////////////////////////////////////////////////////////
-    // Types
-    ////////////////////////////////////////////////////////////
-    typedef std::map<unsigned int, Page> PageTable; ///< Table mapping a character size to its page (texture)
-
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    void*                      m_library;     ///< Pointer to the internal library interface (it is typeless to avoid exposing implementation details)
-    void*                      m_face;        ///< Pointer to the internal font face (it is typeless to avoid exposing implementation details)
-    void*                      m_streamRec;   ///< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
-    int*                       m_refCount;    ///< Reference counter used by implicit sharing
-    mutable PageTable          m_pages;       ///< Table containing the glyphs pages by character size
-    mutable std::vector<Uint8> m_pixelBuffer; ///< Pixel buffer holding a glyph's pixels before being written to the texture
+    void*                      m_library;           ///< Pointer to the internal library interface (it is typeless to avoid exposing implementation details)
+    void*                      m_face;              ///< Pointer to the internal font face (it is typeless to avoid exposing implementation details)
+    void*                      m_streamRec;         ///< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
+    int*                       m_refCount;          ///< Reference counter used by implicit sharing
+    mutable Page*              m_page;              ///< Page containing the glyphs of all the character sizes
+    mutable std::vector<Uint8> m_pixelBuffer;       ///< Pixel buffer holding a glyph's pixels before being written to the texture
+    unsigned int               m_distanceFieldSize; ///< Character size of the distance field glyphs (0 if the mode is disabled)
 };
 
 } // namespace sf
@@ -351,6 +505,20 @@ private :
 /// text1.setStyle(sf::Text::Italic);
 /// \endcode
 ///
+/// Texts that are scaled continuously, or displayed at many
+/// different sizes, are better served by the distance field mode:
+/// the glyphs are loaded once, at a reference size, and sf::Text
+/// renders them sharply at any size with a dedicated shader, which
+/// also applies the bold style and the outline.
+/// \code
+/// if (sf::Font::isDistanceFieldAvailable())
+///     font.setDistanceField(true);
+///
+/// sf::Text title("Title", font, 120);
+/// title.setOutlineThickness(3);
+/// title.setOutlineColor(sf::Color::Black);
+/// \endcode
+///
 /// Apart from loading font files, and passing them to instances
 /// of sf::Text, you should normally not have to deal directly
 /// with this class. However, it may be useful to access the
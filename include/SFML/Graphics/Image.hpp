@@ -30,6 +30,7 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Export.hpp>
 #include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/ImageView.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <string>
 #include <vector>
@@ -37,6 +38,11 @@
 
 namespace sf
 {
+namespace priv
+{
+    class ImageLoadRequest;
+}
+
 class InputStream;
 
 ////////////////////////////////////////////////////////////
@@ -47,6 +53,15 @@ class SFML_GRAPHICS_API Image
 {
 public :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Function releasing a buffer of pixels adopted by an image
+    ///
+    /// The first argument is the buffer to release, the second
+    /// one is the user data that was given to Image::adopt.
+    ///
+    ////////////////////////////////////////////////////////////
+    typedef void (*PixelsDeleter)(Uint8* pixels, void* userData);
+
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
@@ -55,6 +70,23 @@ public :
     ////////////////////////////////////////////////////////////
     Image();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// If \a copy has an asynchronous load in progress, the new
+    /// image will receive its result as well.
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    Image(const Image& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~Image();
+
     ////////////////////////////////////////////////////////////
     /// \brief Create the image and fill it with a unique color
     ///
@@ -80,6 +112,34 @@ public :
     ////////////////////////////////////////////////////////////
     void create(unsigned int width, unsigned int height, const Uint8* pixels);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the image from an array of pixels, without copying them
+    ///
+    /// Unlike create, this function doesn't copy the pixels: the
+    /// image uses the given buffer directly as its storage. The
+    /// \a pixels array must contain tightly packed 32-bits RGBA
+    /// pixels, and have the given \a width and \a height.
+    ///
+    /// When the image no longer needs the buffer (it is destroyed,
+    /// created again or loaded from another source), \a deleter
+    /// is called with \a pixels and \a userData to release it.
+    /// If \a deleter is null, the buffer remains owned by the
+    /// caller, who must keep it alive as long as the image uses it.
+    ///
+    /// If \a pixels is null or the size is zero, an empty image
+    /// is created (and the buffer is released immediately).
+    ///
+    /// \param width    Width of the image
+    /// \param height   Height of the image
+    /// \param pixels   Array of pixels to adopt
+    /// \param deleter  Function releasing the buffer, or null to keep ownership
+    /// \param userData User data passed to \a deleter
+    ///
+    /// \see create
+    ///
+    ////////////////////////////////////////////////////////////
+    void adopt(unsigned int width, unsigned int height, Uint8* pixels, PixelsDeleter deleter, void* userData = NULL);
+
     ////////////////////////////////////////////////////////////
     /// \brief Load the image from a file on disk
     ///
@@ -132,6 +192,59 @@ public :
     ////////////////////////////////////////////////////////////
     bool loadFromStream(InputStream& stream);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Start loading the image from a file on disk in the background
+    ///
+    /// The file is decoded by a pool of worker threads, so that
+    /// many images can be loaded in parallel. This function
+    /// returns immediately: the image keeps its current contents
+    /// until waitForLoad is called, which is where the decoded
+    /// pixels are given to the image (without any copy).
+    /// Use isLoading to know whether waitForLoad would block.
+    ///
+    /// Since OpenGL resources must be created in the thread that
+    /// owns the context, the typical usage is to start loading all
+    /// the images, then upload them to textures in the main thread
+    /// as they become available.
+    ///
+    /// Starting a new load of any kind cancels the pending one.
+    ///
+    /// \param filename Path of the image file to load
+    ///
+    /// \see isLoading, waitForLoad, loadFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    void loadFromFileAsync(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether an asynchronous load is still in progress
+    ///
+    /// This function never blocks. When it returns false,
+    /// waitForLoad returns immediately.
+    ///
+    /// \return True if the file is still being decoded
+    ///
+    /// \see loadFromFileAsync, waitForLoad
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isLoading() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Finish the pending asynchronous load
+    ///
+    /// This function blocks until the file started with
+    /// loadFromFileAsync is decoded, then assigns its pixels
+    /// to the image. If the decoding failed, the image is
+    /// left unchanged. If no load is pending, this function
+    /// does nothing and returns true.
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromFileAsync, isLoading
+    ///
+    ////////////////////////////////////////////////////////////
+    bool waitForLoad();
+
     ////////////////////////////////////////////////////////////
     /// \brief Save the image to a file on disk
     ///
@@ -178,6 +291,8 @@ public :
     /// static image from several others, but if you need this
     /// kind of feature in real-time you'd better use sf::RenderTexture.
     ///
+    /// The source can be another sf::Image, or any array of
+    /// pixels described by a sf::ImageView.
     /// If \a sourceRect is empty, the whole image is copied.
     /// If \a applyAlpha is set to true, the transparency of
     /// source pixels is applied. If it is false, the pixels are
@@ -190,7 +305,7 @@ public :
     /// \param applyAlpha Should the copy take in account the source transparency?
     ///
     ////////////////////////////////////////////////////////////
-    void copy(const Image& source, unsigned int destX, unsigned int destY, const IntRect& sourceRect = IntRect(0, 0, 0, 0), bool applyAlpha = false);
+    void copy(const ImageView& source, unsigned int destX, unsigned int destY, const IntRect& sourceRect = IntRect(0, 0, 0, 0), bool applyAlpha = false);
 
     ////////////////////////////////////////////////////////////
     /// \brief Change the color of a pixel
@@ -252,13 +367,68 @@ public :
     ////////////////////////////////////////////////////////////
     void flipVertically();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Multiply the color components of all the pixels by their alpha
+    ///
+    /// After this call, the RGB components of each pixel are
+    /// scaled by its alpha (rounded to the nearest integer),
+    /// which is the representation expected by blending modes
+    /// working with premultiplied alpha.
+    ///
+    ////////////////////////////////////////////////////////////
+    void premultiplyAlpha();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Image& operator =(const Image& right);
+
 private :
 
+    friend class TextureReadback;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a pointer to the pixels, wherever they are stored
+    ///
+    /// \return Pointer to the pixels, or NULL if the image is empty
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint8* getPixelData();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a read-only pointer to the pixels, wherever they are stored
+    ///
+    /// \return Pointer to the pixels, or NULL if the image is empty
+    ///
+    ////////////////////////////////////////////////////////////
+    const Uint8* getPixelData() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release the storage of the pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void releasePixels();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Forget the pending asynchronous load, if any
+    ///
+    ////////////////////////////////////////////////////////////
+    void cancelLoad();
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Vector2u           m_size;   ///< Image size
-    std::vector<Uint8> m_pixels; ///< Pixels of the image
+    Vector2u                m_size;        ///< Image size
+    std::vector<Uint8>      m_pixels;      ///< Pixels of the image, when the image owns them
+    Uint8*                  m_adopted;     ///< Pixels of the image, when they were adopted (NULL otherwise)
+    PixelsDeleter           m_deleter;     ///< Function releasing the adopted pixels
+    void*                   m_deleterData; ///< User data passed to the deleter
+    priv::ImageLoadRequest* m_request;     ///< Pending asynchronous load, if any
 };
 
 } // namespace sf
@@ -313,6 +483,22 @@ private :
 ///     return -1;
 /// \endcode
 ///
-/// \see sf::Texture
+/// Many images can be decoded in parallel with loadFromFileAsync,
+/// while textures are created in the thread that owns the
+/// OpenGL context:
+/// \code
+/// std::vector<sf::Image> images(filenames.size());
+/// for (std::size_t i = 0; i < filenames.size(); ++i)
+///     images[i].loadFromFileAsync(filenames[i]);
+///
+/// std::vector<sf::Texture> textures(filenames.size());
+/// for (std::size_t i = 0; i < filenames.size(); ++i)
+/// {
+///     if (images[i].waitForLoad())
+///         textures[i].loadFromImage(images[i]);
+/// }
+/// \endcode
+///
+/// \see sf::Texture, sf::ImageView
 ///
 ////////////////////////////////////////////////////////////
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_IMAGEVIEW_HPP
+#define SFML_IMAGEVIEW_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Config.hpp>
+#include <cstddef>
+#include <string>
+
+
+namespace sf
+{
+class Image;
+
+////////////////////////////////////////////////////////////
+/// \brief Non-owning reference to an array of RGBA pixels
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API ImageView
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty view.
+    ///
+    ////////////////////////////////////////////////////////////
+    ImageView();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the view from an array of pixels
+    ///
+    /// The \a viewPixels array is assumed to contain 32-bits RGBA
+    /// pixels. Rows may be separated by padding bytes, in
+    /// which case \a viewStride gives the number of bytes between
+    /// the beginning of two consecutive rows; it must be a
+    /// multiple of 4. A stride of 0 means that the rows
+    /// are tightly packed (width * 4 bytes).
+    ///
+    /// \param viewPixels Pointer to the first pixel
+    /// \param viewWidth  Width of the view, in pixels
+    /// \param viewHeight Height of the view, in pixels
+    /// \param viewStride Number of bytes between two rows (0 for tightly packed rows)
+    ///
+    ////////////////////////////////////////////////////////////
+    ImageView(const Uint8* viewPixels, unsigned int viewWidth, unsigned int viewHeight, std::size_t viewStride = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the view from a whole image
+    ///
+    /// The view becomes invalid if the image is modified
+    /// (resized, reloaded) or destroyed.
+    ///
+    /// \param image Image to view
+    ///
+    ////////////////////////////////////////////////////////////
+    ImageView(const Image& image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a view of a sub-rectangle of this view
+    ///
+    /// The rectangle is clamped to the bounds of the view.
+    /// The new view shares the pixels and the stride of this one.
+    ///
+    /// \param area Area to view, in pixels
+    ///
+    /// \return View of the area
+    ///
+    ////////////////////////////////////////////////////////////
+    ImageView getSubView(const IntRect& area) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the view contains no pixel
+    ///
+    /// \return True if the view is empty
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isEmpty() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Save the pixels of the view to a file on disk
+    ///
+    /// The same rules as Image::saveToFile apply.
+    ///
+    /// \param filename Path of the file to save
+    ///
+    /// \return True if saving was successful
+    ///
+    /// \see Image::saveToFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool saveToFile(const std::string& filename) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    const Uint8* pixels; ///< Pointer to the first pixel
+    unsigned int width;  ///< Width of the view, in pixels
+    unsigned int height; ///< Height of the view, in pixels
+    std::size_t  stride; ///< Number of bytes between the beginning of two consecutive rows
+};
+
+} // namespace sf
+
+
+#endif // SFML_IMAGEVIEW_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::ImageView
+/// \ingroup graphics
+///
+/// sf::ImageView describes pixels that live somewhere else:
+/// in a sf::Image, in the output buffer of a video decoder,
+/// in a frame received from the network, etc. It doesn't own
+/// or copy anything, so the pixels must stay alive as long
+/// as the view is used.
+///
+/// Unlike sf::Image, the rows of an image view don't have
+/// to be tightly packed: the stride gives the distance
+/// between two rows, which also allows to describe a
+/// sub-rectangle of a bigger image without copying it.
+///
+/// Views can be passed directly to sf::Texture::update,
+/// sf::Image::copy and saved to a file, which avoids the
+/// intermediate copy into a sf::Image.
+///
+/// Usage example:
+/// \code
+/// // Upload a decoded video frame whose rows are padded to 64 bytes
+/// sf::ImageView frame(decoder.getPixels(), decoder.getWidth(), decoder.getHeight(), decoder.getStride());
+/// texture.update(frame);
+///
+/// // Copy the top-left quarter of the frame into an image
+/// image.copy(frame.getSubView(sf::IntRect(0, 0, frame.width / 2, frame.height / 2)), 0, 0);
+/// \endcode
+///
+/// \see sf::Image, sf::Texture
+///
+////////////////////////////////////////////////////////////
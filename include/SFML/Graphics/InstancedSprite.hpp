@@ -0,0 +1,313 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_INSTANCEDSPRITE_HPP
+#define SFML_INSTANCEDSPRITE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Transformable.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <vector>
+#include <cstddef>
+
+
+namespace sf
+{
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Many copies of a textured quad, drawn in a single
+///        draw call with hardware instancing
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API InstancedSprite : public Drawable, public Transformable, GlResource
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty instanced sprite with no source texture.
+    ///
+    ////////////////////////////////////////////////////////////
+    InstancedSprite();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the instanced sprite from a source texture
+    ///
+    /// \param texture Source texture
+    ///
+    /// \see setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit InstancedSprite(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    InstancedSprite(const InstancedSprite& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~InstancedSprite();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the source texture of the instances
+    ///
+    /// The \a texture argument refers to a texture that must
+    /// exist as long as the instanced sprite uses it. Indeed,
+    /// the instanced sprite doesn't store its own copy of the
+    /// texture, but rather keeps a pointer to the one that you
+    /// passed to this function.
+    ///
+    /// \param texture New texture
+    ///
+    /// \see getTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the source texture of the instances
+    ///
+    /// If the instanced sprite has no source texture, a NULL
+    /// pointer is returned.
+    ///
+    /// \return Pointer to the instances' texture
+    ///
+    /// \see setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture* getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an instance
+    ///
+    /// The instance is a quad of the size of \a textureRect,
+    /// which displays this area of the texture; its position,
+    /// rotation and scale are defined by \a transform, relative
+    /// to the instanced sprite's own transform. Only the 2D
+    /// affine part of the transform (scale, rotation, shearing
+    /// and translation) is kept.
+    ///
+    /// \param transform   Transform of the instance
+    /// \param textureRect Area of the texture displayed by the instance
+    /// \param color       Global color of the instance
+    ///
+    /// \return Index of the new instance
+    ///
+    /// \see setInstance
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t append(const Transform& transform, const IntRect& textureRect, const Color& color = Color::White);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change an existing instance
+    ///
+    /// Only the modified instances are sent to the graphics
+    /// card when the instanced sprite is drawn. If \a index is
+    /// out of range, this function does nothing.
+    ///
+    /// \param index       Index of the instance to change
+    /// \param transform   New transform of the instance
+    /// \param textureRect New area of the texture displayed by the instance
+    /// \param color       New global color of the instance
+    ///
+    /// \see append
+    ///
+    ////////////////////////////////////////////////////////////
+    void setInstance(std::size_t index, const Transform& transform, const IntRect& textureRect, const Color& color = Color::White);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the number of instances
+    ///
+    /// If \a instanceCount is greater than the current number
+    /// of instances, new empty instances are added; if it is
+    /// less, the instances at the end are removed.
+    ///
+    /// \param instanceCount New number of instances
+    ///
+    ////////////////////////////////////////////////////////////
+    void resize(std::size_t instanceCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the instances
+    ///
+    /// The storage allocated in the graphics card is kept, so
+    /// that refilling the instanced sprite is cheap.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of instances
+    ///
+    /// \return Number of instances
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getInstanceCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    InstancedSprite& operator =(const InstancedSprite& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports instanced rendering
+    ///
+    /// If this function returns false, instanced sprites are
+    /// not drawn.
+    ///
+    /// \return True if instanced rendering is supported, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private :
+
+    friend class RenderTarget;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the instanced sprite to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mark a range of instances as modified
+    ///
+    /// \param begin First modified instance
+    /// \param end   One past the last modified instance
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidate(std::size_t begin, std::size_t end);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Send the instances modified since the last draw
+    ///        to the graphics card
+    ///
+    /// \return OpenGL identifier of the instance buffer, or 0 on failure
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int update() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Per-instance attributes, as stored in the instance buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Instance
+    {
+        float transform[6];   ///< Rows of the 2D affine transform (a, b, tx and c, d, ty)
+        float textureRect[4]; ///< Area of the texture (left, top, width, height)
+        Uint8 color[4];       ///< Global color (r, g, b, a)
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    const Texture*        m_texture;        ///< Texture of the instances
+    std::vector<Instance> m_instances;      ///< Instances, as stored in system memory
+    mutable unsigned int  m_buffer;         ///< OpenGL identifier of the instance buffer
+    mutable std::size_t   m_bufferCapacity; ///< Number of instances that the instance buffer can hold
+    mutable std::size_t   m_dirtyBegin;     ///< First instance modified since the last upload
+    mutable std::size_t   m_dirtyEnd;       ///< One past the last instance modified since the last upload
+};
+
+} // namespace sf
+
+
+#endif // SFML_INSTANCEDSPRITE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::InstancedSprite
+/// \ingroup graphics
+///
+/// sf::InstancedSprite draws many copies of a textured quad,
+/// each with its own transform, texture rectangle and color,
+/// in a single draw call. The instances are stored in a buffer
+/// in the graphics card memory, with 44 bytes per instance,
+/// and only the instances that changed are sent again; the
+/// quads themselves are generated by the graphics card. This
+/// is much cheaper than building four sf::Vertex per quad on
+/// the CPU when drawing thousands of particles or bullets.
+///
+/// Usage example:
+/// \code
+/// sf::InstancedSprite particles(texture);
+/// for (std::size_t i = 0; i < 10000; ++i)
+/// {
+///     sf::Transform transform;
+///     transform.translate(positions[i]).rotate(angles[i]);
+///     particles.append(transform, sf::IntRect(0, 0, 8, 8), colors[i]);
+/// }
+///
+/// // in the main loop: update the moving particles and draw them
+/// particles.setInstance(i, transform, sf::IntRect(0, 0, 8, 8), colors[i]);
+/// window.draw(particles);
+/// \endcode
+///
+/// Instanced sprites are drawn with a built-in program which
+/// requires OpenGL 3.1 (or the equivalent extensions); use
+/// isAvailable() to check whether they are supported. A custom
+/// shader can be given in the render states instead, it must
+/// then read the instance attributes and the per-draw states
+/// the same way as the built-in program:
+/// \code
+/// #version 140
+///
+/// layout(std140) uniform sf_Frame { mat4 sf_ViewMatrix; vec4 sf_Viewport; float sf_Time; };
+/// layout(std140) uniform sf_Draw  { mat4 sf_Transform; mat4 sf_TextureMatrix; float sf_Textured; };
+///
+/// in vec3 sf_InstanceRow0;        // a, b, tx
+/// in vec3 sf_InstanceRow1;        // c, d, ty
+/// in vec4 sf_InstanceTextureRect; // left, top, width, height, in pixels
+/// in vec4 sf_InstanceColor;       // normalized color
+/// \endcode
+/// The corner of the quad being processed is given by
+/// gl_VertexID (0 to 3, drawn as a triangle strip).
+///
+/// \see sf::Sprite, sf::RenderTarget::drawInstanced
+///
+////////////////////////////////////////////////////////////
@@ -37,12 +37,17 @@
 #include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/PrimitiveType.hpp>
 #include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/UniformBlock.hpp>
+#include <SFML/System/Clock.hpp>
 #include <SFML/System/NonCopyable.hpp>
+#include <vector>
 
 
 namespace sf
 {
 class Drawable;
+class VertexBuffer;
+class InstancedSprite;
 
 ////////////////////////////////////////////////////////////
 /// \brief Base class for all render targets (window, texture, ...)
@@ -52,6 +57,39 @@ class SFML_GRAPHICS_API RenderTarget : NonCopyable
 {
 public :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Rendering statistics gathered during a frame
+    ///
+    /// The "breaks" counters tell why a pending batch had to be
+    /// sent to the graphics card before it could grow further;
+    /// they are only incremented when batching is enabled.
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Statistics
+    {
+        ////////////////////////////////////////////////////////////
+        /// \brief Default constructor
+        ///
+        /// Sets all the counters to zero.
+        ///
+        ////////////////////////////////////////////////////////////
+        Statistics();
+
+        ////////////////////////////////////////////////////////////
+        // Member data
+        ////////////////////////////////////////////////////////////
+        unsigned int drawCalls;       ///< Number of calls to draw() that submitted vertices
+        unsigned int batches;         ///< Number of draw commands actually sent to OpenGL
+        unsigned int vertices;        ///< Number of vertices actually sent to OpenGL
+        unsigned int textureBreaks;   ///< Batches broken by a texture change
+        unsigned int blendModeBreaks; ///< Batches broken by a blend mode change
+        unsigned int shaderBreaks;    ///< Batches broken by a shader or shader parameter change
+        unsigned int primitiveBreaks; ///< Batches broken by an incompatible primitive type
+        unsigned int viewBreaks;      ///< Batches broken by a view change
+        unsigned int overflowBreaks;  ///< Batches broken because the batch buffer was full
+        unsigned int explicitBreaks;  ///< Batches broken by flush(), display(), clear(), vertex buffers or GL states functions
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Destructor
     ///
@@ -272,6 +310,141 @@ public :
     void draw(const Vertex* vertices, unsigned int vertexCount,
               PrimitiveType type, const RenderStates& states = RenderStates::Default);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives stored in a vertex buffer
+    ///
+    /// \param vertexBuffer Vertex buffer containing the primitives
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const VertexBuffer& vertexBuffer, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw a range of the primitives stored in a vertex buffer
+    ///
+    /// The range is clamped to the size of the buffer.
+    ///
+    /// \param vertexBuffer Vertex buffer containing the primitives
+    /// \param firstVertex  Index of the first vertex to draw
+    /// \param vertexCount  Number of vertices to draw
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const VertexBuffer& vertexBuffer, unsigned int firstVertex,
+              unsigned int vertexCount, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw all the instances of an instanced sprite
+    ///
+    /// The instances are drawn in a single draw call, with the
+    /// built-in instancing program or the shader of \a states
+    /// if there is one (see sf::InstancedSprite for the inputs
+    /// that it must declare). Nothing is drawn if
+    /// sf::InstancedSprite::isAvailable() returns false.
+    ///
+    /// Unlike draw, this function ignores the transform and
+    /// texture of \a sprite: they must be set in \a states.
+    ///
+    /// \param sprite Instanced sprite to draw
+    /// \param states Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawInstanced(const InstancedSprite& sprite, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives textured with a distance field
+    ///
+    /// The alpha channel of the texture of \a states is read as a
+    /// distance field (see sf::Font::setDistanceField): the built-in
+    /// distance field program fills the pixels whose value is above
+    /// \a edge with the color of the vertices, and those whose value
+    /// is between \a edge - \a outline and \a edge with \a outlineColor.
+    /// The edges are antialiased according to the on-screen scale,
+    /// so they remain sharp at any size. The values are in the range
+    /// [0, 1] of the alpha channel.
+    ///
+    /// If \a states contains a shader, it is used instead of the
+    /// built-in program. If the built-in program is not supported
+    /// (see sf::Font::isDistanceFieldAvailable), the pixels whose
+    /// value is below \a edge are discarded by the alpha test:
+    /// the edges are aliased and the outline is not drawn.
+    ///
+    /// \param vertices     Pointer to the vertices
+    /// \param vertexCount  Number of vertices in the array
+    /// \param type         Type of primitives to draw
+    /// \param edge         Value of the distance field on the outline of the shapes
+    /// \param outline      Width of the outline, in values of the distance field
+    /// \param outlineColor Color of the outline
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawDistanceField(const Vertex* vertices, unsigned int vertexCount, PrimitiveType type,
+                           float edge, float outline, const Color& outlineColor,
+                           const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable automatic batching of draw calls
+    ///
+    /// When batching is enabled, consecutive draws that share the
+    /// same texture, blend mode and shader are transformed on the
+    /// CPU and accumulated into a single vertex stream, which is
+    /// sent to the graphics card as one draw command when the
+    /// render states change, when the view changes, on display()
+    /// or on an explicit call to flush().
+    ///
+    /// Strips, fans and quads are converted to independent lines
+    /// and triangles so that sprites, shapes and texts can all
+    /// be merged together.
+    ///
+    /// Since the actual rendering is deferred, modifying or
+    /// destroying a texture used by pending draws, or changing
+    /// a parameter of their shader, draws them first; each draw
+    /// uses the texture contents and shader parameters that
+    /// were current when it was submitted.
+    ///
+    /// Batching is disabled by default.
+    ///
+    /// \param enabled True to enable batching, false to disable it
+    ///
+    /// \see isBatchingEnabled, flush
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBatchingEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether automatic batching is enabled or not
+    ///
+    /// \return True if batching is enabled
+    ///
+    /// \see setBatchingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isBatchingEnabled() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the pending batch, if any
+    ///
+    /// This function is called automatically whenever needed;
+    /// you only have to call it yourself if you mix SFML drawing
+    /// with your own OpenGL calls.
+    ///
+    /// \see setBatchingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    void flush();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the rendering statistics of the last frame
+    ///
+    /// The statistics are accumulated between two calls to
+    /// display(), so the returned values describe the last
+    /// complete frame.
+    ///
+    /// \return Statistics of the last frame
+    ///
+    ////////////////////////////////////////////////////////////
+    const Statistics& getStatistics() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the size of the rendering region of the target
     ///
@@ -365,8 +538,97 @@ protected :
     ////////////////////////////////////////////////////////////
     void initialize(Shader* shader);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Finish the current frame
+    ///
+    /// The derived classes must call this function when they
+    /// display their contents, after the pending batch has
+    /// been flushed. It publishes the statistics of the frame,
+    /// starts a new set of counters and schedules the update of
+    /// the per-frame uniform block for the next draw.
+    ///
+    ////////////////////////////////////////////////////////////
+    void finishFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Forget the OpenGL states cached by the target
+    ///
+    /// The derived classes must call this function when the
+    /// states of their context may have been changed by another
+    /// target sharing it, so that they are set again before the
+    /// next draw.
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidateGLStates();
+
 private:
 
+    friend class Shader;
+    friend class Texture;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reasons for flushing the pending batch
+    ///
+    ////////////////////////////////////////////////////////////
+    enum FlushCause
+    {
+        TextureChange,   ///< The texture changed
+        BlendModeChange, ///< The blend mode changed
+        ShaderChange,    ///< The shader changed
+        PrimitiveChange, ///< The primitive type cannot be merged with the batch
+        ViewChange,      ///< The view changed
+        Overflow,        ///< The batch buffer is full
+        ExplicitFlush    ///< Flush requested by the user or the target itself
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives immediately, without batching
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawPrimitives(const Vertex* vertices, unsigned int vertexCount,
+                        PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add primitives to the pending batch
+    ///
+    /// The vertices are pre-transformed and converted to the
+    /// list primitive type of the batch. The pending batch is
+    /// flushed first if it is not compatible with \a states.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void batchPrimitives(const Vertex* vertices, unsigned int vertexCount,
+                         PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply the render states needed by a draw
+    ///
+    /// This function sets the view, the blending mode, the texture
+    /// and the shader of \a states, if they differ from the cached
+    /// ones. The transform is not applied.
+    ///
+    /// \param states Render states to apply
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyStates(const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the pending batch and record why it was drawn
+    ///
+    /// \param cause Reason for flushing the batch
+    ///
+    ////////////////////////////////////////////////////////////
+    void flushBatch(FlushCause cause);
+
     ////////////////////////////////////////////////////////////
     /// \brief Apply the current view
     ///
@@ -397,6 +659,44 @@ private:
     ////////////////////////////////////////////////////////////
     void applyTexture(const Texture* texture);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply a new shader
+    ///
+    /// \param shader Shader to apply
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyShader(const Shader* shader);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the built-in program used to draw instanced sprites
+    ///
+    /// The program is created the first time it is requested.
+    ///
+    /// \return Instancing program, or NULL if it failed to compile
+    ///
+    ////////////////////////////////////////////////////////////
+    const Shader* getInstancingShader();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the built-in program used to draw distance fields
+    ///
+    /// The program is created the first time it is requested.
+    ///
+    /// \return Distance field program, or NULL if it failed to compile
+    ///
+    ////////////////////////////////////////////////////////////
+    Shader* getDistanceFieldShader();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the matrix which converts texture coordinates
+    ///        from pixels to the normalized range
+    ///
+    /// \param texture Texture to compute the matrix for
+    /// \param matrix  Matrix to update, which must be initialized to identity
+    ///
+    ////////////////////////////////////////////////////////////
+    static void getTextureMatrix(const Texture& texture, float* matrix);
+
     ////////////////////////////////////////////////////////////
     /// \brief Activate the target for rendering
     ///
@@ -427,14 +727,55 @@ private:
         Vertex    vertexCache[VertexCacheSize]; ///< Pre-transformed vertices cache
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Pending geometry of the automatic batching
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Batch
+    {
+        enum {MaxVertexCount = 65536};
+
+        std::vector<Vertex> vertices;  ///< Pre-transformed vertices waiting to be drawn
+        PrimitiveType       type;      ///< Primitive type of the batch (Points, Lines or Triangles)
+        BlendMode           blendMode; ///< Blending mode of the batch
+        const Texture*      texture;   ///< Texture of the batch
+        Uint64              textureId; ///< Cache identifier of the texture when the batch was started
+        const Shader*       shader;    ///< Shader of the batch
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Parameters of the built-in distance field program
+    ///
+    ////////////////////////////////////////////////////////////
+    struct DistanceFieldStyle
+    {
+        float edge;         ///< Value of the distance field on the outline
+        float outline;      ///< Width of the outline
+        Color outlineColor; ///< Color of the outline
+    };
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    View        m_defaultView;  ///< Default view
-    View        m_view;         ///< Current view
-    StatesCache m_cache;        ///< Render states cache
-    
-    Shader*     m_shader;       ///< Current shader
+    View         m_defaultView;      ///< Default view
+    View         m_view;             ///< Current view
+    StatesCache  m_cache;            ///< Render states cache
+
+    Shader*      m_shader;           ///< Current shader
+
+    bool         m_batchingEnabled;  ///< Are draw calls batched?
+    Batch        m_batch;            ///< Pending batch
+    Statistics   m_statistics;       ///< Statistics of the current frame
+    Statistics   m_lastStatistics;   ///< Statistics of the last complete frame
+
+    UniformBlock m_frameBlock;       ///< Per-frame states shared by all the shaders ("sf_Frame" block)
+    Clock        m_clock;            ///< Time elapsed since the creation of the target
+
+    UniformBlock m_drawBlock;        ///< Per-draw states of the instanced draws ("sf_Draw" block)
+    Shader*      m_instancingShader; ///< Built-in program drawing the instanced sprites
+
+    Shader*            m_distanceFieldShader; ///< Built-in program drawing the distance fields
+    DistanceFieldStyle m_distanceFieldStyle;  ///< Parameters currently set to the distance field program
 };
 
 } // namespace sf
@@ -465,6 +806,22 @@ private:
 /// OpenGL states are not messed up by calling the
 /// pushGLStates/popGLStates functions.
 ///
+/// When a lot of small entities are drawn every frame, the cost
+/// of issuing one OpenGL draw command per entity quickly becomes
+/// the bottleneck. Render targets can merge consecutive draws that
+/// use the same render states into a single draw command; see
+/// setBatchingEnabled and getStatistics:
+/// \code
+/// window.setBatchingEnabled(true);
+/// ...
+/// for (std::size_t i = 0; i < sprites.size(); ++i)
+///     window.draw(sprites[i]); // all sprites share the same texture
+/// window.display();
+///
+/// const sf::RenderTarget::Statistics& stats = window.getStatistics();
+/// std::cout << stats.batches << " batches for " << stats.drawCalls << " draws" << std::endl;
+/// \endcode
+///
 /// \see sf::RenderWindow, sf::RenderTexture, sf::View
 ///
 ////////////////////////////////////////////////////////////
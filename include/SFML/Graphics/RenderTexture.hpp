@@ -31,6 +31,7 @@
 #include <SFML/Graphics/Export.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Window/ContextSettings.hpp>
 
 
 namespace sf
@@ -38,6 +39,7 @@ namespace sf
 namespace priv
 {
     class RenderTextureImpl;
+    struct RenderTextureContext;
 }
 
 ////////////////////////////////////////////////////////////
@@ -85,6 +87,34 @@ public :
     ////////////////////////////////////////////////////////////
     bool create(unsigned int width, unsigned int height, sf::Shader* shader, bool depthBuffer = false);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the render-texture with advanced settings
+    ///
+    /// This overload lets you request an antialiased render-texture:
+    /// if \a settings.antialiasingLevel is not 0, the drawings are
+    /// rendered to a multisampled buffer with this number of
+    /// samples (or the maximum supported by the system), which
+    /// is resolved into the target texture by display().
+    /// A depth buffer is created if \a settings.depthBits is
+    /// not 0; the other members of \a settings are ignored.
+    ///
+    /// The \a format argument sets the pixel format of the
+    /// target texture, for example RGBA16F for high dynamic
+    /// range rendering (see Texture::create). The target
+    /// of a Depth render-texture is its depth buffer, it is
+    /// meant for OpenGL rendering with depth testing enabled.
+    ///
+    /// \param width    Width of the render-texture
+    /// \param height   Height of the render-texture
+    /// \param shader   Default shader of the render-texture
+    /// \param settings Depth buffer and antialiasing settings
+    /// \param format   Pixel format of the target texture
+    ///
+    /// \return True if creation has been successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(unsigned int width, unsigned int height, sf::Shader* shader, const ContextSettings& settings, Texture::PixelFormat format = Texture::RGBA8);
+
     ////////////////////////////////////////////////////////////
     /// \brief Enable or disable texture smoothing
     ///
@@ -148,6 +178,22 @@ public :
     ////////////////////////////////////////////////////////////
     bool setActive(bool active = true);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Generate a mipmap using the current texture data
+    ///
+    /// This function is similar to Texture::generateMipmap and operates
+    /// on the texture used as the target for drawing.
+    /// Be aware that any draw operation may modify the base level image data.
+    /// For this reason, calling this function only makes sense after all
+    /// drawing is completed and display has been called. Not calling display
+    /// after subsequent drawing will lead to undefined behavior if a mipmap
+    /// had been previously generated.
+    ///
+    /// \return True if mipmap generation was successful, false if unsuccessful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool generateMipmap();
+
     ////////////////////////////////////////////////////////////
     /// \brief Update the contents of the target texture
     ///
@@ -156,6 +202,10 @@ public :
     /// function is mandatory at the end of rendering. Not calling
     /// it may leave the texture in an undefined state.
     ///
+    /// The pending batch, if any, is drawn first, and the frame
+    /// of the rendering statistics ends here (see
+    /// RenderTarget::getStatistics).
+    ///
     ////////////////////////////////////////////////////////////
     void display();
 
@@ -188,6 +238,23 @@ public :
 
 private :
 
+    friend class RenderTexturePool;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the render-texture in a shared OpenGL context
+    ///
+    /// \param width         Width of the render-texture
+    /// \param height        Height of the render-texture
+    /// \param shader        Default shader of the render-texture
+    /// \param settings      Depth buffer and antialiasing settings
+    /// \param format        Pixel format of the target texture
+    /// \param sharedContext Context shared with other render-textures (NULL for a private one)
+    ///
+    /// \return True if creation has been successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(unsigned int width, unsigned int height, sf::Shader* shader, const ContextSettings& settings, Texture::PixelFormat format, priv::RenderTextureContext* sharedContext);
+
     ////////////////////////////////////////////////////////////
     /// \brief Activate the target for rendering
     ///
@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_RENDERTEXTUREPOOL_HPP
+#define SFML_RENDERTEXTUREPOOL_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+    struct RenderTextureContext;
+}
+
+class RenderTexture;
+class Shader;
+
+////////////////////////////////////////////////////////////
+/// \brief Pool of transient render textures, recycled
+///        from one frame to the next
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API RenderTexturePool : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Usage statistics of the pool during a frame
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Statistics
+    {
+        ////////////////////////////////////////////////////////////
+        /// \brief Default constructor
+        ///
+        /// Sets all the counters to zero.
+        ///
+        ////////////////////////////////////////////////////////////
+        Statistics();
+
+        ////////////////////////////////////////////////////////////
+        // Member data
+        ////////////////////////////////////////////////////////////
+        unsigned int acquired;  ///< Number of render textures handed out by acquire()
+        unsigned int reused;    ///< Number of requests served by an existing render texture
+        unsigned int created;   ///< Number of render textures created to serve a request
+        unsigned int destroyed; ///< Number of render textures destroyed because they were not used anymore
+        unsigned int available; ///< Number of render textures waiting in the pool at the end of the frame
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the pool
+    ///
+    /// \param shader Default shader of the render textures created by the pool
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit RenderTexturePool(Shader* shader);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// Destroys all the render textures of the pool, including
+    /// the ones which were not released.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~RenderTexturePool();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a render texture from the pool
+    ///
+    /// If a released render texture with the same size, depth
+    /// buffer setting and pixel format is available, it is reused; its
+    /// view is reset to the default one, and it is neither
+    /// smooth nor repeated. Otherwise a new render texture
+    /// is created. The contents of the returned texture are
+    /// undefined: clear it before drawing.
+    ///
+    /// The render texture belongs to the pool, and must be
+    /// given back with release() when it is not needed anymore.
+    ///
+    /// \param width       Width of the render texture
+    /// \param height      Height of the render texture
+    /// \param depthBuffer Do you want the render texture to have a depth buffer?
+    /// \param format      Pixel format of the render texture
+    ///
+    /// \return Pointer to the render texture, or NULL if it couldn't be created
+    ///
+    /// \see release
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderTexture* acquire(unsigned int width, unsigned int height, bool depthBuffer = false, Texture::PixelFormat format = Texture::RGBA8);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Give a render texture back to the pool
+    ///
+    /// The render texture may be returned by a later call to
+    /// acquire(), so it must not be used after this call.
+    ///
+    /// \param texture Render texture returned by acquire()
+    ///
+    /// \see acquire
+    ///
+    ////////////////////////////////////////////////////////////
+    void release(RenderTexture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start a new frame
+    ///
+    /// This function publishes the statistics of the frame
+    /// that ends, and destroys the render textures that have
+    /// not been used for more than the maximum number of idle
+    /// frames. Call it once per frame, for example after
+    /// displaying the window.
+    ///
+    /// \see setMaxIdleFrames, getStatistics
+    ///
+    ////////////////////////////////////////////////////////////
+    void nextFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the number of frames a released render
+    ///        texture is kept before being destroyed
+    ///
+    /// The default value is 2.
+    ///
+    /// \param frames Maximum number of idle frames
+    ///
+    /// \see getMaxIdleFrames
+    ///
+    ////////////////////////////////////////////////////////////
+    void setMaxIdleFrames(unsigned int frames);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of frames a released render
+    ///        texture is kept before being destroyed
+    ///
+    /// \return Maximum number of idle frames
+    ///
+    /// \see setMaxIdleFrames
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getMaxIdleFrames() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destroy the render textures waiting in the pool
+    ///
+    /// The render textures which are currently acquired are
+    /// not affected.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the statistics of the last complete frame
+    ///
+    /// \return Statistics of the frame ended by the last call to nextFrame()
+    ///
+    /// \see nextFrame
+    ///
+    ////////////////////////////////////////////////////////////
+    const Statistics& getStatistics() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Render texture owned by the pool
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        RenderTexture*       texture;     ///< The render texture
+        unsigned int         width;       ///< Width requested at creation
+        unsigned int         height;      ///< Height requested at creation
+        bool                 depthBuffer; ///< Has the render texture a depth buffer?
+        Texture::PixelFormat format;      ///< Pixel format of the render texture
+        bool                 used;        ///< Is the render texture currently acquired?
+        Uint64               lastFrame;   ///< Last frame in which the render texture was acquired
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destroy the released render textures which have
+    ///        been idle for at least a number of frames
+    ///
+    /// \param idleFrames Minimum number of idle frames of the render textures to destroy
+    ///
+    ////////////////////////////////////////////////////////////
+    void evict(Uint64 idleFrames);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Shader*                     m_shader;         ///< Default shader of the render textures
+    priv::RenderTextureContext* m_context;        ///< OpenGL context shared by all the FBO render textures
+    std::vector<Entry>          m_entries;        ///< Render textures owned by the pool
+    Uint64                      m_frame;          ///< Index of the current frame
+    unsigned int                m_maxIdleFrames;  ///< Number of idle frames before a released render texture is destroyed
+    Statistics                  m_statistics;     ///< Statistics of the current frame
+    Statistics                  m_lastStatistics; ///< Statistics of the last complete frame
+};
+
+} // namespace sf
+
+
+#endif // SFML_RENDERTEXTUREPOOL_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::RenderTexturePool
+/// \ingroup graphics
+///
+/// Post-processing chains and other multi-pass effects need
+/// intermediate render textures that only live during a part
+/// of a frame. Creating them on the fly is expensive: each
+/// sf::RenderTexture allocates a texture, a frame buffer
+/// object and its own OpenGL context.
+///
+/// sf::RenderTexturePool keeps the render textures that are
+/// released, and hands them out again to the next requests
+/// with the same size, depth buffer setting and pixel format, so that
+/// a chain which needs the same targets every frame stops
+/// allocating anything after the first frame. Render textures
+/// that are not used anymore are destroyed after a few frames.
+///
+/// When frame buffer objects are supported, all the render
+/// textures of a pool are created in a single OpenGL context
+/// instead of one context each, which also makes switching
+/// between them much cheaper. As a consequence, the render
+/// textures of a pool must all be used in the same thread.
+///
+/// The statistics of the last frame tell how many requests
+/// were served by existing render textures, which is useful
+/// to tune the maximum number of idle frames.
+///
+/// Usage example:
+/// \code
+/// sf::RenderTexturePool pool(NULL);
+///
+/// while (window.isOpen())
+/// {
+///     sf::RenderTexture* blur = pool.acquire(width / 2, height / 2);
+///     blur->clear();
+///     blur->draw(scene, &blurShader);
+///     blur->display();
+///
+///     window.clear();
+///     window.draw(sf::Sprite(blur->getTexture()));
+///     window.display();
+///
+///     pool.release(*blur);
+///     pool.nextFrame();
+/// }
+/// \endcode
+///
+/// \see sf::RenderTexture
+///
+////////////////////////////////////////////////////////////
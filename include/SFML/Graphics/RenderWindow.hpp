@@ -138,10 +138,13 @@ public :
     /// You can also draw things directly to a texture with the
     /// sf::RenderTexture class.
     ///
+    /// The pending draws, if any, are drawn before the contents
+    /// are read.
+    ///
     /// \return Image containing the captured contents
     ///
     ////////////////////////////////////////////////////////////
-    Image capture() const;
+    Image capture();
 
 protected:
 
@@ -164,6 +167,27 @@ protected:
     ////////////////////////////////////////////////////////////
     virtual void onResize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called before the window contents are displayed
+    ///
+    /// This function draws the pending batch, if any, and ends
+    /// the frame of the rendering statistics (see
+    /// RenderTarget::getStatistics). Being called by
+    /// Window::display, it also runs when the window is
+    /// displayed through a sf::Window reference.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onDisplay();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called before the window contents are read
+    ///
+    /// This function draws the pending batch, if any, so that
+    /// the contents copied by sf::Texture::update are complete.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onCapture();
+
 private :
 
     ////////////////////////////////////////////////////////////
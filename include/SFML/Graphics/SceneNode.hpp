@@ -0,0 +1,459 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_SCENENODE_HPP
+#define SFML_SCENENODE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Transformable.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <vector>
+#include <cstddef>
+
+
+namespace sf
+{
+namespace priv
+{
+    class SceneGrid;
+}
+
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Node of a hierarchy of transformable objects,
+///        drawn with view culling
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API SceneNode : public Drawable, public Transformable, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates a node with no parent and no children.
+    ///
+    ////////////////////////////////////////////////////////////
+    SceneNode();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// The node is detached from its parent, and its
+    /// children become the roots of their own scenes.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual ~SceneNode();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Attach a child to the node
+    ///
+    /// The child is detached from its previous parent first.
+    /// The node doesn't take ownership of the child, which
+    /// must exist as long as it's attached. The children are
+    /// drawn after their parent, in the order of attachment.
+    /// A node can't be attached to itself or to one of its
+    /// descendants.
+    ///
+    /// \param child Node to attach
+    ///
+    /// \see detachChild
+    ///
+    ////////////////////////////////////////////////////////////
+    void attachChild(SceneNode& child);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Detach a child from the node
+    ///
+    /// The child becomes the root of its own scene.
+    /// This function does nothing if \a child is not
+    /// a child of the node.
+    ///
+    /// \param child Node to detach
+    ///
+    /// \see attachChild
+    ///
+    ////////////////////////////////////////////////////////////
+    void detachChild(SceneNode& child);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the parent of the node
+    ///
+    /// \return Pointer to the parent, or NULL if the node is the root of its scene
+    ///
+    ////////////////////////////////////////////////////////////
+    SceneNode* getParent() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of children of the node
+    ///
+    /// \return Number of children
+    ///
+    /// \see getChild
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getChildCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a child of the node
+    ///
+    /// The result is undefined if \a index is out of range.
+    ///
+    /// \param index Index of the child, in range [0 .. getChildCount() - 1]
+    ///
+    /// \return Reference to the index-th child
+    ///
+    /// \see getChildCount
+    ///
+    ////////////////////////////////////////////////////////////
+    SceneNode& getChild(std::size_t index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the transform of the node in the world
+    ///
+    /// The world transform combines the transform of the
+    /// node with the ones of all its ancestors. The part
+    /// that comes from the ancestors below the root is cached,
+    /// and only recomputed after one of them changed.
+    ///
+    /// \return World transform of the node
+    ///
+    ////////////////////////////////////////////////////////////
+    Transform getWorldTransform() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the local bounding rectangle of the node
+    ///
+    /// The bounding rectangle is used to decide whether
+    /// the node is visible. The default implementation returns
+    /// an empty rectangle, which means that the node has no
+    /// known bounds: it is never culled.
+    /// Derived classes must call invalidateBounds when the
+    /// result of this function changes.
+    ///
+    /// \return Local bounding rectangle of the node
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual FloatRect getLocalBounds() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the global bounding rectangle of the node
+    ///
+    /// \return Bounding rectangle of the node, in world coordinates
+    ///
+    ////////////////////////////////////////////////////////////
+    FloatRect getGlobalBounds() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the sorting of the nodes by texture
+    ///
+    /// When enabled, the visible nodes of the scene are drawn
+    /// grouped by texture (see getTexture), so that the render
+    /// target can batch them together. Nodes that share a
+    /// texture keep their relative order, but their order
+    /// relatively to other nodes is lost: this should only be
+    /// used when the nodes don't overlap, or when the order
+    /// doesn't matter.
+    /// This setting is only used by the root of a scene.
+    /// It is disabled by default.
+    ///
+    /// \param sort True to sort the nodes by texture
+    ///
+    /// \see isSortedByTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSortByTexture(bool sort);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the nodes are sorted by texture or not
+    ///
+    /// \return True if the nodes are sorted by texture
+    ///
+    /// \see setSortByTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isSortedByTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the size of the cells of the spatial index
+    ///
+    /// The nodes are located with a grid of square cells,
+    /// in the coordinate system of the root node. The cells
+    /// should be a few times larger than a typical node,
+    /// and a fraction of the view.
+    /// This setting is only used by the root of a scene.
+    /// The default size is 256.
+    ///
+    /// \param size New size of the cells
+    ///
+    /// \see getCellSize
+    ///
+    ////////////////////////////////////////////////////////////
+    void setCellSize(float size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the cells of the spatial index
+    ///
+    /// \return Size of the cells
+    ///
+    /// \see setCellSize
+    ///
+    ////////////////////////////////////////////////////////////
+    float getCellSize() const;
+
+protected :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the content of the node
+    ///
+    /// This function is called for each visible node when the
+    /// scene is drawn; \a states already contains the world
+    /// transform of the node. The default implementation
+    /// draws nothing.
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void drawCurrent(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture used to draw the node
+    ///
+    /// This is only used to sort the nodes when the scene
+    /// is sorted by texture. The default implementation
+    /// returns NULL.
+    ///
+    /// \return Texture used by drawCurrent, or NULL
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual const Texture* getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Notify the node that its local bounds changed
+    ///
+    /// This function must be called by derived classes everytime
+    /// the result of getLocalBounds changes, so that the node
+    /// is relocated in the spatial index of its scene.
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidateBounds();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Invalidate the cached transforms when the node moves
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onTransformChange();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the node and its descendants
+    ///
+    /// When the node is the root of its scene, only the nodes
+    /// that overlap the current view are drawn. Otherwise the
+    /// whole subtree is drawn, without culling.
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the subtree of the node, without culling
+    ///
+    /// \param target Render target to draw to
+    /// \param states Render states, containing the transform of the parent
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawSubtree(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the root of the node's scene
+    ///
+    /// \return Root node
+    ///
+    ////////////////////////////////////////////////////////////
+    SceneNode& getRoot() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the transform of the node relative to the root
+    ///
+    /// \return Transform combining the node and its ancestors, except the root
+    ///
+    ////////////////////////////////////////////////////////////
+    const Transform& getSceneTransform() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Invalidate the scene transform of the node and its descendants
+    ///
+    /// \param root Root of the node's scene
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidate(SceneNode& root);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Register the node and its descendants in a scene
+    ///
+    /// \param root Root of the scene
+    ///
+    ////////////////////////////////////////////////////////////
+    void addToScene(SceneNode& root);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unregister the node and its descendants from a scene
+    ///
+    /// \param root Root of the scene
+    ///
+    ////////////////////////////////////////////////////////////
+    void removeFromScene(SceneNode& root);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unregister the node and its descendants from the index of a scene
+    ///
+    /// \param root Root of the scene
+    ///
+    ////////////////////////////////////////////////////////////
+    void unregister(SceneNode& root);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bring the spatial index and the draw order of the scene up to date
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateScene() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Number the node and its descendants in draw order
+    ///
+    /// \param order Next number, incremented for each node
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateOrder(std::size_t& order) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compare two nodes by draw order
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool compareOrder(const SceneNode* left, const SceneNode* right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compare two nodes by texture, then by draw order
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool compareTexture(const SceneNode* left, const SceneNode* right);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    SceneNode*                            m_parent;                   ///< Parent of the node
+    std::vector<SceneNode*>               m_children;                 ///< Children of the node, in draw order
+    mutable Transform                     m_sceneTransform;           ///< Transform relative to the root
+    mutable bool                          m_sceneTransformNeedUpdate; ///< Does the scene transform need to be recomputed?
+    mutable bool                          m_boundsNeedUpdate;         ///< Is the node waiting to be relocated in the index?
+    mutable bool                          m_registered;               ///< Is the node registered in the index?
+    mutable FloatRect                     m_sceneBounds;              ///< Bounds of the node relative to the root, as registered
+    mutable IntRect                       m_cells;                    ///< Cells of the index in which the node is registered
+    mutable std::size_t                   m_order;                    ///< Position of the node in draw order
+    mutable const Texture*                m_sortTexture;              ///< Texture of the node, while sorting
+    mutable priv::SceneGrid*              m_grid;                     ///< Spatial index of the scene (root only)
+    mutable std::vector<SceneNode*>       m_dirtyNodes;               ///< Nodes to relocate in the index (root only)
+    mutable std::vector<const SceneNode*> m_visibleNodes;             ///< Nodes to draw, rebuilt every frame (root only)
+    mutable bool                          m_orderNeedUpdate;          ///< Does the draw order need to be recomputed (root only)?
+    bool                                  m_sortByTexture;            ///< Are the nodes sorted by texture (root only)?
+    float                                 m_cellSize;                 ///< Size of the cells of the index (root only)
+};
+
+} // namespace sf
+
+
+#endif // SFML_SCENENODE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::SceneNode
+/// \ingroup graphics
+///
+/// sf::SceneNode organizes the objects of a large world in a
+/// hierarchy: each node is positioned, rotated and scaled
+/// relatively to its parent, so that moving a node moves its
+/// whole subtree.
+///
+/// The root of a hierarchy (the node which has no parent)
+/// represents a scene. When it is drawn, only the nodes whose
+/// bounds overlap the current view are drawn, so that the
+/// objects which are off-screen cost almost nothing:
+/// \li the transforms of the nodes are cached, and only
+///     recomputed when the node or one of its ancestors moves
+/// \li the bounds of the nodes are kept in a spatial index,
+///     and only updated when they change
+/// \li moving the root itself (to scroll the world, for
+///     example) doesn't invalidate anything
+///
+/// sf::SceneNode draws nothing by itself: derived classes
+/// override drawCurrent to draw their content, and
+/// getLocalBounds to give its bounds.
+///
+/// Usage example:
+/// \code
+/// class SpriteNode : public sf::SceneNode
+/// {
+/// public :
+///
+///     SpriteNode(const sf::Texture& texture) : m_sprite(texture) {}
+///
+///     virtual sf::FloatRect getLocalBounds() const {return m_sprite.getLocalBounds();}
+///
+/// private :
+///
+///     virtual void drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const {target.draw(m_sprite, states);}
+///     virtual const sf::Texture* getTexture() const {return m_sprite.getTexture();}
+///
+///     sf::Sprite m_sprite;
+/// };
+///
+/// sf::SceneNode world;
+/// world.setSortByTexture(true);
+/// std::vector<SpriteNode*> trees;
+/// for (int i = 0; i < 10000; ++i)
+/// {
+///     trees.push_back(new SpriteNode(treeTexture));
+///     trees.back()->setPosition(positions[i]);
+///     world.attachChild(*trees.back());
+/// }
+///
+/// // in the main loop: only the visible trees are drawn
+/// window.draw(world);
+/// \endcode
+///
+/// \see sf::Transformable, sf::Drawable
+///
+////////////////////////////////////////////////////////////
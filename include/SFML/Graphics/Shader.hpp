@@ -43,6 +43,7 @@
 namespace sf
 {
 class InputStream;
+class RenderTarget;
 class Texture;
 
 ////////////////////////////////////////////////////////////
@@ -72,6 +73,16 @@ public :
     struct CurrentTextureType {};
     static CurrentTextureType CurrentTexture;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Handle to a parameter of the shader
+    ///
+    /// Handles are retrieved with getUniformHandle, and remain
+    /// valid until the shader is loaded again. The value -1
+    /// represents an invalid handle.
+    ///
+    ////////////////////////////////////////////////////////////
+    typedef int UniformHandle;
+
 public :
 
     ////////////////////////////////////////////////////////////
@@ -161,6 +172,8 @@ public :
     /// a C-like language dedicated to OpenGL shaders; you'll
     /// probably need to read a good documentation for it before
     /// writing your own shaders.
+    /// An empty source means that the corresponding shader
+    /// is not part of the program.
     ///
     /// \param vertexShader   String containing the source code of the vertex shader
     /// \param geometryShader String containing the source code of the geometry shader
@@ -452,6 +465,121 @@ public :
     ////////////////////////////////////////////////////////////
     virtual void setParameter(const std::string& name, CurrentTextureType);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the handle of a parameter of the shader
+    ///
+    /// Setting a parameter through its handle avoids looking up
+    /// its name every time, which makes it the preferred way to
+    /// change parameters that are updated very often (like
+    /// per-object parameters).
+    ///
+    /// Example:
+    /// \code
+    /// sf::Shader::UniformHandle offset = shader.getUniformHandle("offset");
+    /// ...
+    /// shader.setParameter(offset, 2.f);
+    /// \endcode
+    ///
+    /// \param name Name of the parameter in the shader
+    ///
+    /// \return Handle of the parameter, or -1 if it doesn't exist
+    ///
+    ////////////////////////////////////////////////////////////
+    UniformHandle getUniformHandle(const std::string& name) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a float parameter of the shader, from its handle
+    ///
+    /// \param handle Handle of the parameter (see getUniformHandle)
+    /// \param x      Value to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(UniformHandle handle, float x);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 2-components vector parameter of the shader, from its handle
+    ///
+    /// \param handle Handle of the parameter (see getUniformHandle)
+    /// \param x      First component of the value to assign
+    /// \param y      Second component of the value to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(UniformHandle handle, float x, float y);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 3-components vector parameter of the shader, from its handle
+    ///
+    /// \param handle Handle of the parameter (see getUniformHandle)
+    /// \param x      First component of the value to assign
+    /// \param y      Second component of the value to assign
+    /// \param z      Third component of the value to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(UniformHandle handle, float x, float y, float z);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 4-components vector parameter of the shader, from its handle
+    ///
+    /// \param handle Handle of the parameter (see getUniformHandle)
+    /// \param x      First component of the value to assign
+    /// \param y      Second component of the value to assign
+    /// \param z      Third component of the value to assign
+    /// \param w      Fourth component of the value to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(UniformHandle handle, float x, float y, float z, float w);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 2-components vector parameter of the shader, from its handle
+    ///
+    /// \param handle Handle of the parameter (see getUniformHandle)
+    /// \param vector Vector to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(UniformHandle handle, const Vector2f& vector);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 3-components vector parameter of the shader, from its handle
+    ///
+    /// \param handle Handle of the parameter (see getUniformHandle)
+    /// \param vector Vector to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(UniformHandle handle, const Vector3f& vector);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a color parameter of the shader, from its handle
+    ///
+    /// The components of the color are normalized to [0 .. 1],
+    /// see the overload taking a name for more details.
+    ///
+    /// \param handle Handle of the parameter (see getUniformHandle)
+    /// \param color  Color to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(UniformHandle handle, const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a matrix parameter of the shader, from its handle
+    ///
+    /// \param handle    Handle of the parameter (see getUniformHandle)
+    /// \param transform Transform to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(UniformHandle handle, const sf::Transform& transform);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the OpenGL identifier of the program
+    ///
+    /// You shouldn't need to use this function, unless you have
+    /// very specific stuff to implement that SFML doesn't support,
+    /// or implement a temporary workaround until a bug is fixed.
+    ///
+    /// \return OpenGL program object, or 0 if not loaded yet
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getNativeHandle() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Bind a shader for rendering
     ///
@@ -470,6 +598,10 @@ public :
     /// // draw OpenGL stuff that use no shader...
     /// \endcode
     ///
+    /// Parameter values are uploaded to the program when it is
+    /// bound, so parameters changed while a shader is bound only
+    /// take effect the next time it is bound.
+    ///
     /// \param shader Shader to bind, can be null to use no shader
     ///
     ////////////////////////////////////////////////////////////
@@ -500,13 +632,10 @@ public :
     ////////////////////////////////////////////////////////////
     static bool isGeometryShaderAvailable();
 
-public :
-
-    virtual void ApplyProjectionMatrix(const float* matrix) = 0;
-
-
 protected :
 
+    friend class RenderTarget;
+
     // Retrieve the maximum number of texture units available
     int getMaxTextureUnits();
 
@@ -531,10 +660,89 @@ protected :
     ////////////////////////////////////////////////////////////
     bool compile(const char* vertexShaderCode, const char* geometryShaderCode, const char* fragmentShaderCode);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Fill the parameters table with the active uniforms of the program
+    ///
+    ////////////////////////////////////////////////////////////
+    void buildUniformTable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Connect the uniform blocks of the program to their binding points
+    ///
+    /// Each block declared by the program reads its values from
+    /// the binding point assigned to its name, so that it is
+    /// shared with the sf::UniformBlock of the same name.
+    ///
+    ////////////////////////////////////////////////////////////
+    void bindUniformBlocks();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a parameter to the parameters table
+    ///
+    /// \param name     Name of the parameter
+    /// \param location Location of the parameter in the program, -1 if it doesn't exist
+    ///
+    /// \return Handle of the new parameter
+    ///
+    ////////////////////////////////////////////////////////////
+    UniformHandle addUniform(const std::string& name, int location) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Store the value of a parameter until the program is bound
+    ///
+    /// \param handle Handle of the parameter
+    /// \param values Components of the value
+    /// \param size   Number of components (1 to 4, or 16 for a matrix)
+    ///
+    ////////////////////////////////////////////////////////////
+    void stageUniform(UniformHandle handle, const float* values, int size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the pending batch that uses the shader, if any
+    ///
+    /// This function is called before changing a parameter, so
+    /// that the draws already batched with the shader use the
+    /// value they were submitted with.
+    ///
+    ////////////////////////////////////////////////////////////
+    void flushPendingBatch() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload the parameters that changed since the last bind
+    ///
+    /// The program must be bound.
+    ///
+    ////////////////////////////////////////////////////////////
+    void uploadUniforms() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind all the textures used by the shader
+    ///
+    /// This function binds each texture to a different unit, and
+    /// updates the corresponding variables in the shader accordingly.
+    ///
+    ////////////////////////////////////////////////////////////
+    void bindTextures() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Parameter of the shader, with its staged value
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Uniform
+    {
+        std::string name;       ///< Name of the parameter
+        Uint32      hash;       ///< Hash of the name
+        int         location;   ///< Location in the program, -1 if the parameter doesn't exist
+        int         size;       ///< Number of components of the staged value, 0 if none
+        bool        dirty;      ///< Has the value changed since the last upload?
+        float       values[16]; ///< Staged value
+    };
+
     ////////////////////////////////////////////////////////////
     // Types
     ////////////////////////////////////////////////////////////
     typedef std::map<int, const Texture*> TextureTable;
+    typedef std::vector<Uniform> UniformTable;
 
     ////////////////////////////////////////////////////////////
     // Member data
@@ -547,8 +755,12 @@ protected :
     int          m_colourLoc;      ///< Colour attribute variable location in shader
     int          m_texCoordLoc;    ///< Texture coordinate attribute variable location in shader
 
-    int          m_wvpMatrixLoc;   ///< World view projection matrix variable location in shader
     int          m_textureLoc;     ///< Texture variable location in shader
+
+    mutable UniformTable     m_uniforms;       ///< Parameters of the shader, indexed by handle
+    mutable std::vector<int> m_uniformBuckets; ///< Hash table (open addressing) of the handles, indexed by name
+    mutable bool             m_uniformsDirty;  ///< Has any parameter changed since the last upload?
+    mutable RenderTarget*    m_batchTarget;    ///< Render target whose pending batch uses the shader, if any
 };
 
 } // namespace sf
@@ -589,7 +801,10 @@ protected :
 /// \li transforms (matrices)
 ///
 /// The value of the variables can be changed at any time
-/// with the various overloads of the setParameter function:
+/// with the various overloads of the setParameter function.
+/// The values are stored by the shader and sent to the graphics
+/// card only when the shader is bound for drawing, so changing
+/// a parameter several times between two draws is cheap:
 /// \code
 /// shader.setParameter("offset", 2.f);
 /// shader.setParameter("point", 0.5f, 0.8f, 0.3f);
@@ -603,6 +818,32 @@ protected :
 /// given texture variable to the current texture of the
 /// object being drawn (which cannot be known in advance).
 ///
+/// Parameters that change very often, like per-object
+/// parameters, are best set through a handle, which avoids
+/// looking up the name of the variable every time:
+/// \code
+/// sf::Shader::UniformHandle offset = shader.getUniformHandle("offset");
+/// for (std::size_t i = 0; i < objects.size(); ++i)
+/// {
+///     shader.setParameter(offset, objects[i].offset);
+///     window.draw(objects[i], &shader);
+/// }
+/// \endcode
+///
+/// This also works when the render target batches its draws
+/// (see RenderTarget::setBatchingEnabled): changing a parameter
+/// first draws the pending batch that uses the shader, so that
+/// each object keeps its own value. Objects whose parameters
+/// differ therefore can't share a draw command.
+///
+/// Parameters shared by many shaders, like the view matrix
+/// or the current time, belong in a uniform block instead
+/// (see sf::UniformBlock): the shaders that declare a block
+/// with a given name all read the same buffer, which is
+/// updated once regardless of the number of shaders. The
+/// states of the current sf::RenderTarget are available in
+/// the "sf_Frame" block.
+///
 /// To apply a shader to a drawable, you must pass it as an
 /// additional parameter to the Draw function:
 /// \code
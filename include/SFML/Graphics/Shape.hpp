@@ -251,12 +251,14 @@ protected :
     /// This function must be called by the derived class everytime
     /// the shape's points change (ie. the result of either
     /// getPointCount or getPoint is different).
+    /// The geometry is not recomputed immediately, but the next
+    /// time that the shape is drawn or that its bounds are
+    /// requested. A change of the result of getPointCount is
+    /// also detected at this time.
     ///
     ////////////////////////////////////////////////////////////
     void update();
 
-private :
-
     ////////////////////////////////////////////////////////////
     /// \brief Draw the shape to a render target
     ///
@@ -266,44 +268,63 @@ private :
     ////////////////////////////////////////////////////////////
     virtual void draw(RenderTarget& target, RenderStates states) const;
 
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Recompute the outdated parts of the shape's geometry
+    ///
+    ////////////////////////////////////////////////////////////
+    void ensureUpdate() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the fill vertices' position
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateGeometry() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Update the fill vertices' color
     ///
     ////////////////////////////////////////////////////////////
-    void updateFillColors();
+    void updateFillColors() const;
 
     ////////////////////////////////////////////////////////////
     /// \brief Update the fill vertices' texture coordinates
     ///
     ////////////////////////////////////////////////////////////
-    void updateTexCoords();
+    void updateTexCoords() const;
 
     ////////////////////////////////////////////////////////////
     /// \brief Update the outline vertices' position
     ///
     ////////////////////////////////////////////////////////////
-    void updateOutline();
+    void updateOutline() const;
 
     ////////////////////////////////////////////////////////////
     /// \brief Update the outline vertices' color
     ///
     ////////////////////////////////////////////////////////////
-    void updateOutlineColors();
+    void updateOutlineColors() const;
 
 private :
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    const Texture* m_texture;          ///< Texture of the shape
-    IntRect        m_textureRect;      ///< Rectangle defining the area of the source texture to display
-    Color          m_fillColor;        ///< Fill color
-    Color          m_outlineColor;     ///< Outline color
-    float          m_outlineThickness; ///< Thickness of the shape's outline
-    VertexArray    m_vertices;         ///< Vertex array containing the fill geometry
-    VertexArray    m_outlineVertices;  ///< Vertex array containing the outline geometry
-    FloatRect      m_insideBounds;     ///< Bounding rectangle of the inside (fill)
-    FloatRect      m_bounds;           ///< Bounding rectangle of the whole shape (outline + fill)
+    const Texture*      m_texture;                 ///< Texture of the shape
+    IntRect             m_textureRect;             ///< Rectangle defining the area of the source texture to display
+    Color               m_fillColor;               ///< Fill color
+    Color               m_outlineColor;            ///< Outline color
+    float               m_outlineThickness;        ///< Thickness of the shape's outline
+    mutable VertexArray m_vertices;                ///< Vertex array containing the fill geometry
+    mutable VertexArray m_outlineVertices;         ///< Vertex array containing the outline geometry
+    mutable FloatRect   m_insideBounds;            ///< Bounding rectangle of the inside (fill)
+    mutable FloatRect   m_bounds;                  ///< Bounding rectangle of the whole shape (outline + fill)
+    mutable bool        m_geometryNeedUpdate;      ///< Do the fill vertices' positions need to be updated?
+    mutable bool        m_fillColorsNeedUpdate;    ///< Do the fill vertices' colors need to be updated?
+    mutable bool        m_texCoordsNeedUpdate;     ///< Do the fill vertices' texture coordinates need to be updated?
+    mutable bool        m_outlineNeedUpdate;       ///< Do the outline vertices' positions need to be updated?
+    mutable bool        m_outlineColorsNeedUpdate; ///< Do the outline vertices' colors need to be updated?
 };
 
 } // namespace sf
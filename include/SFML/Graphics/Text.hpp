@@ -100,6 +100,53 @@ public :
     ////////////////////////////////////////////////////////////
     void setString(const String& string);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Append characters at the end of the text's string
+    ///
+    /// Only the geometry of the new characters is generated,
+    /// which makes this function much cheaper than setString
+    /// for texts that grow over time, like logs or consoles.
+    ///
+    /// \param string Characters to append
+    ///
+    /// \see insert, erase, setString
+    ///
+    ////////////////////////////////////////////////////////////
+    void append(const String& string);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Insert characters into the text's string
+    ///
+    /// The geometry of the characters that precede \a position
+    /// is kept, only the inserted characters and the ones that
+    /// follow them are laid out again.
+    /// If \a position is out of range, the characters are
+    /// appended at the end of the string.
+    ///
+    /// \param position Position of insertion
+    /// \param string   Characters to insert
+    ///
+    /// \see append, erase, setString
+    ///
+    ////////////////////////////////////////////////////////////
+    void insert(std::size_t position, const String& string);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Erase characters from the text's string
+    ///
+    /// The geometry of the characters that precede \a position
+    /// is kept, only the characters that follow the erased
+    /// range are laid out again.
+    /// If \a position is out of range, nothing is erased.
+    ///
+    /// \param position Position of the first character to erase
+    /// \param count    Number of characters to erase
+    ///
+    /// \see append, insert, setString
+    ///
+    ////////////////////////////////////////////////////////////
+    void erase(std::size_t position, std::size_t count = 1);
+
     ////////////////////////////////////////////////////////////
     /// \brief Set the text's font
     ///
@@ -155,6 +202,36 @@ public :
     ////////////////////////////////////////////////////////////
     void setColor(const Color& color);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the color of the text's outline
+    ///
+    /// The outline is only drawn with fonts in distance field
+    /// mode (see sf::Font::setDistanceField).
+    /// By default, the outline's color is opaque black.
+    ///
+    /// \param color New color of the outline
+    ///
+    /// \see getOutlineColor, setOutlineThickness
+    ///
+    ////////////////////////////////////////////////////////////
+    void setOutlineColor(const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the thickness of the text's outline
+    ///
+    /// The outline is only drawn with fonts in distance field
+    /// mode (see sf::Font::setDistanceField), and its thickness
+    /// is limited by the spread of the distance field scaled
+    /// to the character size.
+    /// By default, the outline's thickness is 0.
+    ///
+    /// \param thickness New thickness of the outline, in pixels
+    ///
+    /// \see getOutlineThickness, setOutlineColor
+    ///
+    ////////////////////////////////////////////////////////////
+    void setOutlineThickness(float thickness);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the text's string
     ///
@@ -218,6 +295,26 @@ public :
     ////////////////////////////////////////////////////////////
     const Color& getColor() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the color of the text's outline
+    ///
+    /// \return Color of the outline
+    ///
+    /// \see setOutlineColor
+    ///
+    ////////////////////////////////////////////////////////////
+    const Color& getOutlineColor() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the thickness of the text's outline
+    ///
+    /// \return Thickness of the outline, in pixels
+    ///
+    /// \see setOutlineThickness
+    ///
+    ////////////////////////////////////////////////////////////
+    float getOutlineThickness() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the position of the \a index-th character
     ///
@@ -275,21 +372,52 @@ private :
     virtual void draw(RenderTarget& target, RenderStates states) const;
 
     ////////////////////////////////////////////////////////////
-    /// \brief Update the text's geometry
+    /// \brief Mark the geometry of the text as outdated
+    ///
+    /// The geometry is not rebuilt immediately, but the next
+    /// time that it is needed, so that several changes
+    /// cost a single update.
+    ///
+    /// \param start Index of the first character whose geometry changed
     ///
     ////////////////////////////////////////////////////////////
-    void updateGeometry();
+    void invalidateGeometry(std::size_t start);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Make sure that the text's geometry is up to date
+    ///
+    /// Only the characters that follow the first invalidated
+    /// one are laid out again.
+    ///
+    ////////////////////////////////////////////////////////////
+    void ensureGeometryUpdate() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Layout state of the text before a character
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Layout
+    {
+        Vector2f     position;    ///< Position of the pen, before the kerning of the character
+        unsigned int vertexCount; ///< Number of vertices generated by the previous characters
+        FloatRect    bounds;      ///< Bounding rectangle of these vertices
+    };
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    String        m_string;        ///< String to display
-    const Font*   m_font;          ///< Font used to display the string
-    unsigned int  m_characterSize; ///< Base size of characters, in pixels
-    Uint32        m_style;         ///< Text style (see Style enum)
-    Color         m_color;         ///< Text color
-    VertexArray   m_vertices;      ///< Vertex array containing the text's geometry
-    FloatRect     m_bounds;        ///< Bounding rectangle of the text (in local coordinates)
+    String                      m_string;              ///< String to display
+    const Font*                 m_font;                ///< Font used to display the string
+    unsigned int                m_characterSize;       ///< Base size of characters, in pixels
+    Uint32                      m_style;               ///< Text style (see Style enum)
+    Color                       m_color;               ///< Text color
+    Color                       m_outlineColor;        ///< Outline color (distance field fonts only)
+    float                       m_outlineThickness;    ///< Outline thickness, in pixels (distance field fonts only)
+    mutable VertexArray         m_vertices;            ///< Vertex array containing the text's geometry
+    mutable FloatRect           m_bounds;              ///< Bounding rectangle of the text (in local coordinates)
+    mutable std::vector<Layout> m_layouts;             ///< Layout state before each character, plus the end of the string
+    mutable std::size_t         m_geometryUpdateStart; ///< Index of the first character to lay out again
+    mutable bool                m_geometryNeedUpdate;  ///< Does the geometry need to be updated?
 };
 
 } // namespace sf
@@ -40,6 +40,11 @@ class RenderTarget;
 class RenderTexture;
 class InputStream;
 
+namespace priv
+{
+    class TextureContainer;
+}
+
 ////////////////////////////////////////////////////////////
 /// \brief Image living on the graphics card that can be used for drawing
 ///
@@ -58,6 +63,31 @@ public :
         Pixels      ///< Texture coordinates in range [0 .. size]
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Formats of the pixels stored in a texture
+    ///
+    ////////////////////////////////////////////////////////////
+    enum PixelFormat
+    {
+        R8,      ///< 8-bits red channel
+        RG8,     ///< 8-bits red and green channels
+        RGBA8,   ///< 8-bits red, green, blue and alpha channels (default)
+        RGBA16F, ///< 16-bits floating point red, green, blue and alpha channels
+        RGBA32F, ///< 32-bits floating point red, green, blue and alpha channels
+        Depth,   ///< 24-bits depth component
+
+        // Compressed formats, which can only be loaded from DDS or KTX files
+        BC1,      ///< S3TC DXT1 compressed RGBA, with 1-bit alpha (8 bytes per 4x4 block)
+        BC2,      ///< S3TC DXT3 compressed RGBA (16 bytes per 4x4 block)
+        BC3,      ///< S3TC DXT5 compressed RGBA (16 bytes per 4x4 block)
+        BC4,      ///< RGTC1 compressed red channel (8 bytes per 4x4 block)
+        BC5,      ///< RGTC2 compressed red and green channels (16 bytes per 4x4 block)
+        BC6H,     ///< BPTC compressed floating point RGB (16 bytes per 4x4 block)
+        BC7,      ///< BPTC compressed RGBA (16 bytes per 4x4 block)
+        ETC2RGB,  ///< ETC2 compressed RGB (8 bytes per 4x4 block)
+        ETC2RGBA  ///< ETC2 compressed RGBA with EAC alpha (16 bytes per 4x4 block)
+    };
+
 public :
 
     ////////////////////////////////////////////////////////////
@@ -85,15 +115,29 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Create the texture
     ///
+    /// The pixel format defines how the pixels are stored on
+    /// the graphics card. Textures with less channels use less
+    /// memory: when they are drawn, the missing green and blue
+    /// components are 0 and the alpha component is 1. Floating
+    /// point formats keep values outside the [0 .. 1] range,
+    /// which is useful for high dynamic range rendering. Depth
+    /// textures are meant to be rendered to with OpenGL, and
+    /// read by shaders. Use isPixelFormatAvailable to know
+    /// which formats the system supports. Compressed formats
+    /// can't be used here, they are loaded from files.
+    ///
     /// If this function fails, the texture is left unchanged.
     ///
     /// \param width  Width of the texture
     /// \param height Height of the texture
+    /// \param format Format of the pixels
     ///
     /// \return True if creation was successful
     ///
+    /// \see getPixelFormat
+    ///
     ////////////////////////////////////////////////////////////
-    bool create(unsigned int width, unsigned int height);
+    bool create(unsigned int width, unsigned int height, PixelFormat format = RGBA8);
 
     ////////////////////////////////////////////////////////////
     /// \brief Load the texture from a file on disk
@@ -114,6 +158,12 @@ public :
     /// The maximum size for a texture depends on the graphics
     /// driver and can be retrieved with the getMaximumSize function.
     ///
+    /// DDS and KTX files containing compressed textures (see
+    /// PixelFormat) are not decoded: their blocks and mipmap
+    /// levels are uploaded as they are, and the texture keeps
+    /// their compressed format. In this case \a area must be
+    /// empty or cover the whole texture.
+    ///
     /// If this function fails, the texture is left unchanged.
     ///
     /// \param filename Path of the image file to load
@@ -145,6 +195,12 @@ public :
     /// The maximum size for a texture depends on the graphics
     /// driver and can be retrieved with the getMaximumSize function.
     ///
+    /// DDS and KTX files containing compressed textures (see
+    /// PixelFormat) are not decoded: their blocks and mipmap
+    /// levels are uploaded as they are, and the texture keeps
+    /// their compressed format. In this case \a area must be
+    /// empty or cover the whole texture.
+    ///
     /// If this function fails, the texture is left unchanged.
     ///
     /// \param data Pointer to the file data in memory
@@ -177,6 +233,12 @@ public :
     /// The maximum size for a texture depends on the graphics
     /// driver and can be retrieved with the getMaximumSize function.
     ///
+    /// DDS and KTX files containing compressed textures (see
+    /// PixelFormat) are not decoded: their blocks and mipmap
+    /// levels are uploaded as they are, and the texture keeps
+    /// their compressed format. In this case \a area must be
+    /// empty or cover the whole texture.
+    ///
     /// If this function fails, the texture is left unchanged.
     ///
     /// \param stream Source stream to read from
@@ -221,6 +283,16 @@ public :
     ////////////////////////////////////////////////////////////
     Vector2u getSize() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the format of the pixels of the texture
+    ///
+    /// \return Pixel format of the texture
+    ///
+    /// \see create
+    ///
+    ////////////////////////////////////////////////////////////
+    PixelFormat getPixelFormat() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Copy the texture pixels to an image
     ///
@@ -228,6 +300,12 @@ public :
     /// the texture's pixels from the graphics card and copies
     /// them to a new image, potentially applying transformations
     /// to pixels if necessary (texture may be padded or flipped).
+    /// Use sf::TextureReadback to download the pixels without
+    /// blocking.
+    ///
+    /// The pixels are converted to 32-bits RGBA: floating point
+    /// values are clamped to [0 .. 1], and the depth of depth
+    /// textures is stored as a gray level.
     ///
     /// \return Image containing the texture's pixels
     ///
@@ -276,6 +354,34 @@ public :
     ////////////////////////////////////////////////////////////
     void update(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of the texture from an array of
+    ///        floating point pixels
+    ///
+    /// Unlike the other overloads, which take 32-bits RGBA
+    /// pixels, the \a pixel array contains the channels of
+    /// the texture's pixel format: one value per pixel for R8
+    /// and Depth, two for RG8, four for RGBA8, RGBA16F and
+    /// RGBA32F. This is how the values outside the [0 .. 1]
+    /// range of floating point textures, and the depth of
+    /// depth textures, can be uploaded.
+    ///
+    /// No additional check is performed on the size of the pixel
+    /// array or the bounds of the area to update, passing invalid
+    /// arguments will lead to an undefined behaviour.
+    ///
+    /// This function does nothing if \a pixels is null or if the
+    /// texture was not previously created.
+    ///
+    /// \param pixels Array of values to copy to the texture
+    /// \param width  Width of the pixel region contained in \a pixels
+    /// \param height Height of the pixel region contained in \a pixels
+    /// \param x      X offset in the texture where to copy the source pixels
+    /// \param y      Y offset in the texture where to copy the source pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const float* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y);
+
     ////////////////////////////////////////////////////////////
     /// \brief Update the texture from an image
     ///
@@ -313,6 +419,76 @@ public :
     ////////////////////////////////////////////////////////////
     void update(const Image& image, unsigned int x, unsigned int y);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of the texture from a view of pixels
+    ///
+    /// The pixels are uploaded directly from the memory described
+    /// by the view, taking its stride into account: there's no need
+    /// to copy them to a sf::Image (or to repack them) first.
+    /// The 32-bits RGBA pixels are converted to the pixel format
+    /// of the texture; depth textures can only be updated with
+    /// floating point pixels.
+    ///
+    /// The view must fit in the texture at the given offset,
+    /// passing an invalid combination of view size and offset
+    /// will lead to an undefined behaviour.
+    ///
+    /// This function does nothing if the view is empty or if
+    /// the texture was not previously created.
+    ///
+    /// \param view View of the pixels to copy to the texture
+    /// \param x    X offset in the texture where to copy the source pixels
+    /// \param y    Y offset in the texture where to copy the source pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const ImageView& view, unsigned int x = 0, unsigned int y = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the texture from another texture
+    ///
+    /// Although the source texture can be smaller than this texture,
+    /// this function is usually used for updating the whole texture.
+    /// The other overload, which has (x, y) additional arguments,
+    /// is more convenient for updating a sub-area of this texture.
+    ///
+    /// No additional check is performed on the size of the passed
+    /// texture, passing a texture bigger than this texture
+    /// will lead to an undefined behaviour.
+    ///
+    /// This function does nothing if either texture was not
+    /// previously created.
+    ///
+    /// \param texture Source texture to copy to this texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of this texture from another texture
+    ///
+    /// The pixels are copied by the graphics card, through
+    /// framebuffer objects, so that they keep the precision of
+    /// the source format. They only go through the system memory,
+    /// as floats, if framebuffer objects are not supported, or
+    /// if the source texture was filled from a window or a render
+    /// texture and framebuffer blits are not supported.
+    /// Depth textures can only be copied to depth textures.
+    ///
+    /// No additional check is performed on the size of the texture,
+    /// passing an invalid combination of texture size and offset
+    /// will lead to an undefined behaviour. The source texture
+    /// must not be this texture.
+    ///
+    /// This function does nothing if either texture was not
+    /// previously created.
+    ///
+    /// \param texture Source texture to copy to this texture
+    /// \param x       X offset in this texture where to copy the source texture
+    /// \param y       Y offset in this texture where to copy the source texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const Texture& texture, unsigned int x, unsigned int y);
+
     ////////////////////////////////////////////////////////////
     /// \brief Update the texture from the contents of a window
     ///
@@ -331,7 +507,7 @@ public :
     /// \param window Window to copy to the texture
     ///
     ////////////////////////////////////////////////////////////
-    void update(const Window& window);
+    void update(Window& window);
 
     ////////////////////////////////////////////////////////////
     /// \brief Update a part of the texture from the contents of a window
@@ -348,7 +524,111 @@ public :
     /// \param y      Y offset in the texture where to copy the source window
     ///
     ////////////////////////////////////////////////////////////
-    void update(const Window& window, unsigned int x, unsigned int y);
+    void update(Window& window, unsigned int x, unsigned int y);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the whole texture from an array of pixels, asynchronously
+    ///
+    /// See the other overload of updateAsync.
+    ///
+    /// \param pixels Array of pixels to copy to the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateAsync(const Uint8* pixels);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of the texture from an array of pixels, asynchronously
+    ///
+    /// Unlike update, this function doesn't wait for the graphics
+    /// card to be ready to receive the pixels: they are copied
+    /// to a pixel buffer object and the transfer to the texture
+    /// is performed by the graphics card in the background. Two
+    /// pixel buffers are used alternately, so that a new update
+    /// can be prepared while the previous one is transferred.
+    ///
+    /// The \a pixels array can be reused as soon as the function
+    /// returns. Everything drawn with the texture after the call
+    /// uses the new contents, the graphics card waits for the
+    /// transfer if needed; isUpdatePending tells whether the
+    /// transfer is complete.
+    ///
+    /// If the system doesn't support asynchronous updates (see
+    /// isAsyncUpdateAvailable), this function falls back to update.
+    ///
+    /// The same rules as update apply to the arguments, and this
+    /// function does nothing if \a pixels is null or if the texture
+    /// was not previously created.
+    ///
+    /// \param pixels Array of pixels to copy to the texture
+    /// \param width  Width of the pixel region contained in \a pixels
+    /// \param height Height of the pixel region contained in \a pixels
+    /// \param x      X offset in the texture where to copy the source pixels
+    /// \param y      Y offset in the texture where to copy the source pixels
+    ///
+    /// \see isUpdatePending
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateAsync(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of the texture from an image, asynchronously
+    ///
+    /// See the other overload of updateAsync.
+    ///
+    /// \param image Image to copy to the texture
+    /// \param x     X offset in the texture where to copy the source image
+    /// \param y     Y offset in the texture where to copy the source image
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateAsync(const Image& image, unsigned int x, unsigned int y);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether an asynchronous update is still being transferred
+    ///
+    /// This function never blocks.
+    ///
+    /// \return True if the graphics card hasn't completed all the
+    ///         transfers started by updateAsync, false otherwise
+    ///
+    /// \see updateAsync
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isUpdatePending() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Generate a mipmap using the current texture data
+    ///
+    /// Mipmaps are pre-computed chains of optimized textures. Each
+    /// level of texture in a mipmap is generated by halving each of
+    /// the previous level's dimensions. This is done until the final
+    /// level has the size of 1x1. The textures generated in this process
+    /// may make use of more advanced filters which might improve the
+    /// visual quality of textures when they are applied to objects
+    /// much smaller than they are. This is known as minification.
+    /// Because fewer texels (texture elements) have to be sampled
+    /// from when heavily minified, usage of mipmaps can also improve
+    /// rendering performance in certain scenarios.
+    ///
+    /// The levels are generated by the graphics card when OpenGL 3.0
+    /// or the GL_EXT_framebuffer_object extension is available.
+    /// Otherwise, textures in the R8, RG8 and RGBA8 formats are
+    /// averaged by blocks of 2x2 pixels in system memory.
+    /// Compressed textures keep the levels stored in their file.
+    ///
+    /// Mipmap generation relies on the necessary OpenGL extension
+    /// being available. If it is unavailable or generation fails
+    /// due to another reason, this function will return false.
+    /// Mipmap data is only valid from the time it is generated
+    /// until the next time the base level image is modified, at
+    /// which point this function will have to be called again to
+    /// regenerate it.
+    ///
+    /// \return True if mipmap generation was successful, false if unsuccessful
+    ///
+    /// \see setSmooth, setAnisotropy
+    ///
+    ////////////////////////////////////////////////////////////
+    bool generateMipmap();
 
     ////////////////////////////////////////////////////////////
     /// \brief Enable or disable the smooth filter
@@ -359,9 +639,14 @@ public :
     /// you should leave it disabled.
     /// The smooth filter is disabled by default.
     ///
+    /// When the texture has a mipmap (see generateMipmap), the
+    /// smooth filter interpolates between the two closest levels
+    /// (trilinear filtering), and the non-smooth filter picks the
+    /// nearest pixel of the closest level.
+    ///
     /// \param smooth True to enable smoothing, false to disable it
     ///
-    /// \see isSmooth
+    /// \see isSmooth, generateMipmap
     ///
     ////////////////////////////////////////////////////////////
     void setSmooth(bool smooth);
@@ -376,6 +661,36 @@ public :
     ////////////////////////////////////////////////////////////
     bool isSmooth() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the level of anisotropic filtering
+    ///
+    /// Anisotropic filtering improves the quality of textures
+    /// seen at a steep angle, or scaled down more in one direction
+    /// than the other, by taking up to \a level samples along the
+    /// most minified direction. It is most effective combined with
+    /// a mipmap and the smooth filter.
+    /// The level is clamped to the maximum supported by the
+    /// graphics card (see getMaximumAnisotropy), and is ignored
+    /// if anisotropic filtering is not supported.
+    /// The default level is 1, which disables anisotropic filtering.
+    ///
+    /// \param level Maximum number of samples, 1 to disable anisotropic filtering
+    ///
+    /// \see getAnisotropy, getMaximumAnisotropy
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAnisotropy(unsigned int level);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the level of anisotropic filtering
+    ///
+    /// \return Level passed to setAnisotropy, 1 if disabled
+    ///
+    /// \see setAnisotropy
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getAnisotropy() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Enable or disable repeating
     ///
@@ -420,6 +735,17 @@ public :
     ////////////////////////////////////////////////////////////
     Texture& operator =(const Texture& right);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Swap the contents of this texture with those of another
+    ///
+    /// Unlike the assignment, this function doesn't copy any pixel:
+    /// the two instances just exchange their OpenGL textures.
+    ///
+    /// \param right Instance to swap with
+    ///
+    ////////////////////////////////////////////////////////////
+    void swap(Texture& right);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the maximum texture size allowed
     ///
@@ -432,10 +758,127 @@ public :
     ////////////////////////////////////////////////////////////
     static unsigned int getMaximumSize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the maximum level of anisotropic filtering
+    ///
+    /// Anisotropic filtering requires the GL_EXT_texture_filter_anisotropic
+    /// extension; most graphics cards support up to 16 samples.
+    ///
+    /// \return Maximum level of anisotropic filtering, 1 if it is not supported
+    ///
+    /// \see setAnisotropy
+    ///
+    ////////////////////////////////////////////////////////////
+    static unsigned int getMaximumAnisotropy();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports asynchronous updates
+    ///
+    /// Asynchronous updates require pixel buffer objects and
+    /// fence syncs (OpenGL 3.2, or the GL_ARB_pixel_buffer_object
+    /// and GL_ARB_sync extensions).
+    ///
+    /// \return True if asynchronous updates are supported, false otherwise
+    ///
+    /// \see updateAsync
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAsyncUpdateAvailable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports a pixel format
+    ///
+    /// RGBA8 is always supported. R8 and RG8 require OpenGL 3.0
+    /// or the GL_ARB_texture_rg extension, RGBA16F and RGBA32F
+    /// OpenGL 3.0 or GL_ARB_texture_float, and Depth OpenGL 1.4
+    /// or GL_ARB_depth_texture. Among the compressed formats,
+    /// BC1 to BC3 require GL_EXT_texture_compression_s3tc, BC4
+    /// and BC5 OpenGL 3.0 or GL_ARB_texture_compression_rgtc,
+    /// BC6H and BC7 OpenGL 4.2 or GL_ARB_texture_compression_bptc,
+    /// and ETC2 OpenGL 4.3 or GL_ARB_ES3_compatibility.
+    ///
+    /// \param format Pixel format to check
+    ///
+    /// \return True if textures can be created with this format, false otherwise
+    ///
+    /// \see create
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isPixelFormatAvailable(PixelFormat format);
+
 private :
 
     friend class RenderTexture;
     friend class RenderTarget;
+    friend class Shader;
+    friend class TextureReadback;
+    friend class priv::TextureContainer;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the texture from the blocks of a compressed texture
+    ///
+    /// If this function fails, the texture is left unchanged.
+    ///
+    /// \param container Compressed texture read from a file
+    /// \param area      Area to load, must be empty or cover the whole texture
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromContainer(const priv::TextureContainer& container, const IntRect& area);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Average the pixels of each level into the next one
+    ///
+    /// This is the fallback of generateMipmap when the graphics
+    /// card can't generate the levels itself.
+    /// The texture must be bound.
+    ///
+    /// \param levels Number of levels, including the base level
+    ///
+    /// \return True if the levels were generated
+    ///
+    ////////////////////////////////////////////////////////////
+    bool generateMipmapLevels(unsigned int levels);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Extend the edges of the base level over its padding
+    ///
+    /// When the size of the texture is rounded up to a power of
+    /// two, the padding pixels are undefined; the levels of the
+    /// mipmap are built over the whole texture, so they must
+    /// repeat the last row and column instead of bleeding into
+    /// the image. The texture must be bound.
+    ///
+    ////////////////////////////////////////////////////////////
+    void extendPadding();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the pending batch that uses the texture, if any
+    ///
+    /// This function is called before the texture is modified
+    /// or destroyed, so that the draws already batched with it
+    /// use the contents they were submitted with.
+    ///
+    ////////////////////////////////////////////////////////////
+    void flushPendingBatch() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Invalidate the mipmap if one exists
+    ///
+    /// This also resets the texture's minifying function.
+    /// This function is mainly for internal use by RenderTexture.
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidateMipmap();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply the level of anisotropic filtering to the texture
+    ///
+    /// The texture must be bound.
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyAnisotropy();
 
     ////////////////////////////////////////////////////////////
     /// \brief Get a valid image size according to hardware support
@@ -455,13 +898,22 @@ private :
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Vector2u     m_size;          ///< Public texture size
-    Vector2u     m_actualSize;    ///< Actual texture size (can be greater than public size because of padding)
-    unsigned int m_texture;       ///< Internal texture identifier
-    bool         m_isSmooth;      ///< Status of the smooth filter
-    bool         m_isRepeated;    ///< Is the texture in repeat mode?
-    mutable bool m_pixelsFlipped; ///< To work around the inconsistency in Y orientation
-    Uint64       m_cacheId;       ///< Unique number that identifies the texture to the render target's cache
+    Vector2u      m_size;             ///< Public texture size
+    Vector2u      m_actualSize;       ///< Actual texture size (can be greater than public size because of padding)
+    PixelFormat   m_format;           ///< Format of the pixels
+    bool          m_hasMipmap;        ///< Has the texture mipmap levels?
+    unsigned int  m_texture;          ///< Internal texture identifier
+    bool          m_isSmooth;         ///< Status of the smooth filter
+    unsigned int  m_anisotropy;       ///< Level of anisotropic filtering
+    bool          m_isRepeated;       ///< Is the texture in repeat mode?
+    mutable bool  m_pixelsFlipped;    ///< To work around the inconsistency in Y orientation
+    Uint64        m_cacheId;          ///< Unique number that identifies the texture to the render target's cache
+
+    unsigned int  m_uploadBuffers[2]; ///< Pixel buffer objects used alternately by the asynchronous updates
+    mutable void* m_uploadFences[2];  ///< Fences signaled when the transfers from the pixel buffers are complete
+    unsigned int  m_nextUploadBuffer; ///< Index of the pixel buffer to use for the next asynchronous update
+
+    mutable RenderTarget* m_batchTarget;  ///< Render target whose pending batch uses the texture, if any
 };
 
 } // namespace sf
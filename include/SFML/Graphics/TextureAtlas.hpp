@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_TEXTUREATLAS_HPP
+#define SFML_TEXTUREATLAS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class Image;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Packs many small images into a few large textures
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API TextureAtlas : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Location of an image in the atlas
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Region
+    {
+        ////////////////////////////////////////////////////////////
+        /// \brief Default constructor
+        ///
+        /// Creates an invalid region (no texture).
+        ///
+        ////////////////////////////////////////////////////////////
+        Region();
+
+        const Texture* texture; ///< Texture containing the image, NULL if the image couldn't be added
+        IntRect        rect;    ///< Area of the image in the texture, in pixels
+    };
+
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the atlas
+    ///
+    /// The size of the pages is clamped to the maximum texture
+    /// size allowed by the graphics card.
+    ///
+    /// \param pageSize Width and height of the textures (pages) of the atlas
+    /// \param padding  Space left around each image, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit TextureAtlas(unsigned int pageSize = 1024, unsigned int padding = 1);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TextureAtlas();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an image to the atlas
+    ///
+    /// The image is copied into the first page that has room
+    /// for it, or into a new page if all of them are full.
+    /// Only the area of the page occupied by the image is
+    /// uploaded to the graphics card, the rest of the page is
+    /// left untouched. Images bigger than the pages get a page
+    /// of their own.
+    ///
+    /// The returned region can be used directly with a sprite:
+    /// \code
+    /// sf::TextureAtlas::Region region = atlas.add(image);
+    /// sprite.setTexture(*region.texture);
+    /// sprite.setTextureRect(region.rect);
+    /// \endcode
+    ///
+    /// \param image Image to add
+    ///
+    /// \return Location of the image in the atlas (its texture is NULL on failure)
+    ///
+    ////////////////////////////////////////////////////////////
+    Region add(const Image& image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an area of an image to the atlas
+    ///
+    /// \param image      Image to add
+    /// \param sourceRect Area of the image to add
+    ///
+    /// \return Location of the image in the atlas (its texture is NULL on failure)
+    ///
+    /// \see add
+    ///
+    ////////////////////////////////////////////////////////////
+    Region add(const Image& image, const IntRect& sourceRect);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the images and pages from the atlas
+    ///
+    /// The textures returned by previous calls to add are
+    /// destroyed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of pages of the atlas
+    ///
+    /// \return Number of textures used by the atlas
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getPageCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture of a page
+    ///
+    /// \param index Index of the page, in [0, getPageCount())
+    ///
+    /// \return Texture of the page
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getTexture(unsigned int index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the ratio of a page covered by images
+    ///
+    /// \param index Index of the page, in [0, getPageCount())
+    ///
+    /// \return Area covered by images (and their padding) divided by the area of the page
+    ///
+    ////////////////////////////////////////////////////////////
+    float getOccupancy(unsigned int index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the smooth filter on the pages
+    ///
+    /// This applies to the existing pages and to the ones
+    /// created afterwards. The smooth filter is disabled by
+    /// default.
+    ///
+    /// \param smooth True to enable smoothing, false to disable it
+    ///
+    /// \see isSmooth
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSmooth(bool smooth);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the smooth filter is enabled or not
+    ///
+    /// \return True if smoothing is enabled, false if it is disabled
+    ///
+    /// \see setSmooth
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isSmooth() const;
+
+private :
+
+    struct Page;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a new page
+    ///
+    /// \param width  Width of the page
+    /// \param height Height of the page
+    ///
+    /// \return The new page, or NULL if it couldn't be created
+    ///
+    ////////////////////////////////////////////////////////////
+    Page* createPage(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Page*> m_pages;    ///< Pages of the atlas
+    unsigned int       m_pageSize; ///< Size of the pages
+    unsigned int       m_padding;  ///< Space left around each image
+    bool               m_isSmooth; ///< Status of the smooth filter
+};
+
+} // namespace sf
+
+
+#endif // SFML_TEXTUREATLAS_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::TextureAtlas
+/// \ingroup graphics
+///
+/// Every change of texture between two draws breaks the
+/// batching of sf::RenderTarget and costs a texture switch
+/// in the graphics driver. When many sprites use small
+/// textures of their own, packing these images into a few
+/// large textures lets them be drawn with the same texture,
+/// and therefore in a few draw calls.
+///
+/// sf::TextureAtlas does exactly that: images are added at
+/// any time, placed in the textures (the pages of the atlas)
+/// with a skyline bin-packing algorithm, and uploaded
+/// individually. add() returns the texture and the rectangle
+/// where the image can be found, ready to be used with
+/// sf::Sprite::setTextureRect.
+///
+/// A transparent padding is left around each image so that
+/// smooth filtering doesn't bleed neighbouring images into
+/// each other.
+///
+/// Usage example:
+/// \code
+/// sf::TextureAtlas atlas;
+/// std::vector<sf::Sprite> sprites;
+/// for (std::size_t i = 0; i < images.size(); ++i)
+/// {
+///     sf::TextureAtlas::Region region = atlas.add(images[i]);
+///     if (region.texture)
+///         sprites.push_back(sf::Sprite(*region.texture, region.rect));
+/// }
+/// \endcode
+///
+/// The atlas owns its textures: they must not be used after
+/// the atlas is destroyed or cleared.
+///
+/// \see sf::Texture, sf::Sprite
+///
+////////////////////////////////////////////////////////////
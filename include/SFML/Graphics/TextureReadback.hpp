@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_TEXTUREREADBACK_HPP
+#define SFML_TEXTUREREADBACK_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+#include <cstddef>
+
+
+namespace sf
+{
+class Image;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Non-blocking download of the pixels of a texture
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API TextureReadback : GlResource, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty readback, with no transfer in progress.
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureReadback();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TextureReadback();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start downloading the pixels of a texture
+    ///
+    /// This function returns immediately: the pixels are copied
+    /// by the graphics card to a pixel buffer object in the
+    /// background, and retrieved later with copyTo. Any transfer
+    /// previously started and not retrieved is discarded.
+    ///
+    /// If the system doesn't support asynchronous readbacks
+    /// (see isAvailable), the pixels are downloaded immediately.
+    ///
+    /// \param texture Texture to read
+    ///
+    /// \return True if the transfer was started, false if the texture is empty
+    ///
+    ////////////////////////////////////////////////////////////
+    bool start(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a transfer was started and not yet retrieved
+    ///
+    /// \return True if copyTo has pixels to retrieve
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isStarted() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the pixels are available
+    ///
+    /// This function never blocks. When it returns true, copyTo
+    /// retrieves the pixels without waiting for the graphics card.
+    ///
+    /// \return True if the transfer is complete, false if it is still
+    ///         in progress or if no transfer was started
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isReady() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the texture being read
+    ///
+    /// \return Size of the pixel area retrieved by copyTo, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Retrieve the pixels into an array
+    ///
+    /// The pixels are written directly to \a pixels, which must
+    /// have room for getSize().x * getSize().y 32-bits RGBA
+    /// pixels; the padding and orientation of the texture are
+    /// handled while copying, without an intermediate copy.
+    /// The pixels are converted like in Texture::copyToImage.
+    /// If the transfer is not complete yet, this function waits
+    /// for it. The readback is then ready to be started again.
+    ///
+    /// \param pixels Array of pixels to fill
+    ///
+    /// \return True on success, false if no transfer was started
+    ///
+    ////////////////////////////////////////////////////////////
+    bool copyTo(Uint8* pixels);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Retrieve the pixels into an image
+    ///
+    /// The image is resized to the size of the texture. See the
+    /// other overload of copyTo.
+    ///
+    /// \param image Image to fill
+    ///
+    /// \return True on success, false if no transfer was started
+    ///
+    ////////////////////////////////////////////////////////////
+    bool copyTo(Image& image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports asynchronous readbacks
+    ///
+    /// Asynchronous readbacks require pixel buffer objects and
+    /// fence syncs (OpenGL 3.2, or the GL_ARB_pixel_buffer_object
+    /// and GL_ARB_sync extensions).
+    ///
+    /// \return True if asynchronous readbacks are supported, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the visible pixels of the texture from its full storage
+    ///
+    /// \param source      Pixels of the whole texture, including the padding
+    /// \param destination Array of pixels to fill
+    ///
+    ////////////////////////////////////////////////////////////
+    void copyVisiblePixels(const Uint8* source, Uint8* destination) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the pixels downloaded from the texture
+    ///
+    /// \return Size of a downloaded pixel, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getPixelSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release the fence of the transfer
+    ///
+    ////////////////////////////////////////////////////////////
+    void releaseFence() const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int       m_buffer;     ///< Pixel buffer object receiving the pixels
+    mutable void*      m_fence;      ///< Fence signaled when the transfer is complete
+    std::vector<Uint8> m_pixels;     ///< Pixels downloaded synchronously, when pixel buffers are not supported
+    Vector2u           m_size;       ///< Size of the texture
+    Vector2u           m_actualSize; ///< Size of the storage of the texture, including the padding
+    bool               m_depth;      ///< Is the texture a depth texture?
+    bool               m_flipped;    ///< Are the pixels of the texture flipped vertically?
+    bool               m_started;    ///< Has a transfer been started and not retrieved yet?
+};
+
+} // namespace sf
+
+
+#endif // SFML_TEXTUREREADBACK_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::TextureReadback
+/// \ingroup graphics
+///
+/// sf::Texture::copyToImage stalls the program until the
+/// graphics card has finished drawing and transferred the
+/// pixels, which is too slow to take screenshots or record
+/// videos without dropping frames. sf::TextureReadback splits
+/// this operation in two: start() asks the graphics card to
+/// copy the pixels to a buffer in the background and returns
+/// immediately, and copyTo() retrieves them later, typically
+/// one or two frames after, when isReady() returns true.
+///
+/// The readback acts as a future: it holds the result of a
+/// single transfer until it is retrieved. Use several of them
+/// to keep several transfers in flight.
+///
+/// Usage example:
+/// \code
+/// sf::RenderTexture target;
+/// sf::TextureReadback readback;
+/// std::vector<sf::Uint8> pixels;
+/// ...
+/// // after drawing a frame
+/// if (!readback.isStarted())
+///     readback.start(target.getTexture());
+///
+/// // later, without blocking
+/// if (readback.isReady())
+/// {
+///     pixels.resize(readback.getSize().x * readback.getSize().y * 4);
+///     readback.copyTo(&pixels[0]);
+///     recorder.addFrame(pixels);
+/// }
+/// \endcode
+///
+/// \see sf::Texture
+///
+////////////////////////////////////////////////////////////
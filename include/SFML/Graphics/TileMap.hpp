@@ -0,0 +1,355 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_TILEMAP_HPP
+#define SFML_TILEMAP_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Transformable.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <vector>
+#include <cstddef>
+
+
+namespace sf
+{
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Grid of tiles taken from a tileset texture, drawn
+///        by chunks with view culling
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API TileMap : public Drawable, public Transformable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Special tile values
+    ///
+    ////////////////////////////////////////////////////////////
+    enum
+    {
+        EmptyTile = 0xFFFFFFFF ///< Value of the tiles which are not drawn
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty map with no tileset.
+    ///
+    ////////////////////////////////////////////////////////////
+    TileMap();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// The cached geometry is not copied, it is rebuilt
+    /// when the copy is drawn.
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    TileMap(const TileMap& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TileMap();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the map
+    ///
+    /// All the tiles of the new map are empty.
+    /// The map is divided into square chunks of \a chunkSize
+    /// tiles, which are the unit of caching and culling: a
+    /// chunk is only drawn if it overlaps the view, and editing
+    /// a tile only updates the geometry of its chunk.
+    ///
+    /// \param width     Width of the map, in tiles
+    /// \param height    Height of the map, in tiles
+    /// \param tileSize  Size of a tile, in pixels
+    /// \param chunkSize Size of a chunk, in tiles
+    ///
+    ////////////////////////////////////////////////////////////
+    void create(unsigned int width, unsigned int height, const Vector2u& tileSize, unsigned int chunkSize = 32);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the map
+    ///
+    /// \return Size of the map, in tiles
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of a tile
+    ///
+    /// \return Size of a tile, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getTileSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of a chunk
+    ///
+    /// \return Size of a chunk, in tiles
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getChunkSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the tileset of the map
+    ///
+    /// The tiles are numbered from left to right and from top
+    /// to bottom in the tileset, starting at 0.
+    /// The \a texture argument refers to a texture that must
+    /// exist as long as the map uses it. Indeed, the map
+    /// doesn't store its own copy of the texture, but rather keeps
+    /// a pointer to the one that you passed to this function.
+    ///
+    /// \param texture New tileset texture
+    ///
+    /// \see getTileset
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTileset(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the tileset of the map
+    ///
+    /// \return Pointer to the tileset texture, or NULL if there's none
+    ///
+    /// \see setTileset
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture* getTileset() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a tile of the map
+    ///
+    /// Only the chunk which contains the tile is updated; if
+    /// the tile was already drawn, only its own vertices are.
+    /// This function does nothing if the position is outside
+    /// the map.
+    ///
+    /// \param x    Column of the tile
+    /// \param y    Row of the tile
+    /// \param tile Index of the tile in the tileset, or EmptyTile
+    ///
+    /// \see getTile, setTiles
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTile(unsigned int x, unsigned int y, Uint32 tile);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a tile of the map
+    ///
+    /// \param x Column of the tile
+    /// \param y Row of the tile
+    ///
+    /// \return Index of the tile in the tileset, or EmptyTile if it's empty or outside the map
+    ///
+    /// \see setTile
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint32 getTile(unsigned int x, unsigned int y) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change all the tiles of the map
+    ///
+    /// \a tiles must contain width * height values, row by row.
+    ///
+    /// \param tiles Indices of the tiles in the tileset, or EmptyTile
+    ///
+    /// \see setTile
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTiles(const Uint32* tiles);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the maximum number of chunks kept in memory
+    ///
+    /// The geometry of a chunk is built the first time it is
+    /// visible, and kept (in graphics memory if vertex buffers
+    /// are available) for the next frames. When more chunks
+    /// than this limit are cached, the ones that have not been
+    /// drawn for the longest time are released.
+    /// The default limit is 1024 chunks.
+    ///
+    /// \param chunkCount Maximum number of cached chunks
+    ///
+    /// \see getCacheSize
+    ///
+    ////////////////////////////////////////////////////////////
+    void setCacheSize(std::size_t chunkCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the maximum number of chunks kept in memory
+    ///
+    /// \return Maximum number of cached chunks
+    ///
+    /// \see setCacheSize
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCacheSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the local bounding rectangle of the map
+    ///
+    /// \return Local bounding rectangle of the map
+    ///
+    ////////////////////////////////////////////////////////////
+    FloatRect getLocalBounds() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the global bounding rectangle of the map
+    ///
+    /// \return Global bounding rectangle of the map
+    ///
+    ////////////////////////////////////////////////////////////
+    FloatRect getGlobalBounds() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    TileMap& operator =(const TileMap& right);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Cached geometry of a chunk
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Chunk;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the visible chunks of the map to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the vertices of a tile
+    ///
+    /// \param x    Column of the tile
+    /// \param y    Row of the tile
+    /// \param tile Index of the tile in the tileset
+    /// \param quad Array of 4 vertices to fill
+    ///
+    ////////////////////////////////////////////////////////////
+    void buildQuad(unsigned int x, unsigned int y, Uint32 tile, Vertex* quad) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Build the geometry of a chunk
+    ///
+    /// \param index Index of the chunk
+    ///
+    ////////////////////////////////////////////////////////////
+    void buildChunk(std::size_t index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release the least recently drawn chunks above the cache size
+    ///
+    ////////////////////////////////////////////////////////////
+    void trimCache() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release the geometry of all the chunks
+    ///
+    ////////////////////////////////////////////////////////////
+    void releaseChunks();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Vector2u                         m_size;        ///< Size of the map, in tiles
+    Vector2u                         m_tileSize;    ///< Size of a tile, in pixels
+    unsigned int                     m_chunkSize;   ///< Size of a chunk, in tiles
+    Vector2u                         m_chunkCount;  ///< Number of chunks in each direction
+    const Texture*                   m_tileset;     ///< Tileset texture
+    std::vector<Uint32>              m_tiles;       ///< Tiles of the map, row by row
+    mutable std::vector<Chunk*>      m_chunks;      ///< Cached geometry of the chunks (NULL if not cached)
+    mutable std::vector<std::size_t> m_cached;      ///< Indices of the cached chunks
+    mutable std::vector<Vertex>      m_vertices;    ///< Temporary storage for the geometry of a chunk
+    std::size_t                      m_cacheSize;   ///< Maximum number of cached chunks
+    mutable Uint64                   m_frame;       ///< Number of times the map was drawn
+};
+
+} // namespace sf
+
+
+#endif // SFML_TILEMAP_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::TileMap
+/// \ingroup graphics
+///
+/// sf::TileMap displays a large grid of tiles taken from a
+/// single texture, the tileset. Drawing it only costs what
+/// is visible: the map is divided into square chunks, whose
+/// geometry is built the first time they overlap the view
+/// and then cached, in a vertex buffer when the system
+/// supports it. Chunks that are outside the view are skipped,
+/// and editing a tile only updates its own chunk.
+///
+/// Tiles are identified by their index in the tileset, which
+/// is divided into a grid of tiles of the same size as the
+/// map's tiles, numbered row by row. The special value
+/// sf::TileMap::EmptyTile leaves a hole in the map.
+///
+/// Usage example:
+/// \code
+/// sf::Texture tileset;
+/// tileset.loadFromFile("tileset.png");
+///
+/// sf::TileMap map;
+/// map.create(4096, 4096, sf::Vector2u(16, 16));
+/// map.setTileset(tileset);
+/// map.setTiles(&level[0]);
+///
+/// // in the main loop: only the visible chunks are drawn
+/// map.setTile(x, y, 42);
+/// window.draw(map);
+/// \endcode
+///
+/// \see sf::Texture, sf::VertexBuffer
+///
+////////////////////////////////////////////////////////////
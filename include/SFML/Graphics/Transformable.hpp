@@ -311,6 +311,20 @@ public :
     ////////////////////////////////////////////////////////////
     const Transform& getInverseTransform() const;
 
+protected :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called when the transform of the object changes
+    ///
+    /// This function is called by setPosition, setRotation,
+    /// setScale and setOrigin (and thus by the functions that
+    /// are based on them), so that derived classes which cache
+    /// data depending on the transform can invalidate it.
+    /// The default implementation does nothing.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onTransformChange();
+
 private :
 
     ////////////////////////////////////////////////////////////
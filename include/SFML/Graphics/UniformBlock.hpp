@@ -0,0 +1,305 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_UNIFORMBLOCK_HPP
+#define SFML_UNIFORMBLOCK_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/Vector3.hpp>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Block of shader parameters shared by all the shaders
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API UniformBlock : GlResource, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty uniform block, which has no storage.
+    ///
+    ////////////////////////////////////////////////////////////
+    UniformBlock();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~UniformBlock();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the uniform block
+    ///
+    /// \a name is the name of the uniform block declared in the
+    /// shaders, and \a size the size in bytes of its storage
+    /// (which must be computed with the std140 layout rules).
+    /// Every shader declaring a block with the same name reads
+    /// its values from this block once it is bound.
+    ///
+    /// The contents of the block are initialized to zero.
+    /// If this function fails, the block is left unchanged.
+    ///
+    /// \param name Name of the block in the shaders
+    /// \param size Size of the block, in bytes
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(const std::string& name, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a range of bytes of the block
+    ///
+    /// The data is stored in the block and sent to the graphics
+    /// card the next time the block is bound. Ranges that exceed
+    /// the size of the block are ignored.
+    ///
+    /// \param offset Offset of the range in the block, in bytes
+    /// \param data   Pointer to the data to copy
+    /// \param size   Size of the range, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    void setData(std::size_t offset, const void* data, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a float parameter of the block
+    ///
+    /// \param offset Offset of the parameter in the block (float GLSL type)
+    /// \param x      Value to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(std::size_t offset, float x);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 2-components vector parameter of the block
+    ///
+    /// \param offset Offset of the parameter in the block (vec2 GLSL type)
+    /// \param vector Vector to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(std::size_t offset, const Vector2f& vector);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 3-components vector parameter of the block
+    ///
+    /// \param offset Offset of the parameter in the block (vec3 GLSL type)
+    /// \param vector Vector to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(std::size_t offset, const Vector3f& vector);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a color parameter of the block
+    ///
+    /// The color is normalized to the [0, 1] range, like
+    /// sf::Shader does for its own parameters.
+    ///
+    /// \param offset Offset of the parameter in the block (vec4 GLSL type)
+    /// \param color  Color to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(std::size_t offset, const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a matrix parameter of the block
+    ///
+    /// \param offset    Offset of the parameter in the block (mat4 GLSL type)
+    /// \param transform Transform to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(std::size_t offset, const Transform& transform);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the name of the block
+    ///
+    /// \return Name of the block in the shaders
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::string& getName() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the block
+    ///
+    /// \return Size of the block, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the binding point of the block
+    ///
+    /// \return Index of the uniform buffer binding point used by the block
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getBindingPoint() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the underlying OpenGL handle of the block
+    ///
+    /// You shouldn't need to use this function, unless you have
+    /// very specific stuff to implement that SFML doesn't support,
+    /// or implement a temporary workaround until a bug is fixed.
+    ///
+    /// \return OpenGL handle of the buffer or 0 if not yet created
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getNativeHandle() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind a uniform block to its binding point
+    ///
+    /// The values changed since the last bind are uploaded to
+    /// the graphics card first, in a single transfer. Binding
+    /// points are part of the state of the active context, so
+    /// a block must be bound in each context where it is used;
+    /// sf::RenderTarget does it for its own per-frame block.
+    ///
+    /// \param block Uniform block to bind
+    ///
+    ////////////////////////////////////////////////////////////
+    static void bind(const UniformBlock* block);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the binding point assigned to a block name
+    ///
+    /// Each block name is assigned its own binding point the
+    /// first time it is requested, either by a sf::UniformBlock
+    /// or by a sf::Shader that declares it; this is how shaders
+    /// and blocks are connected without knowing each other.
+    ///
+    /// \param name Name of the block in the shaders
+    ///
+    /// \return Index of the binding point
+    ///
+    ////////////////////////////////////////////////////////////
+    static unsigned int getBindingPoint(const std::string& name);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports uniform blocks
+    ///
+    /// This function should always be called before using
+    /// the uniform block features. If it returns false, then
+    /// any attempt to use sf::UniformBlock will fail.
+    ///
+    /// \return True if uniform blocks are supported, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload the range of bytes changed since the last upload
+    ///
+    ////////////////////////////////////////////////////////////
+    void upload() const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::string                m_name;         ///< Name of the block in the shaders
+    unsigned int               m_bindingPoint; ///< Uniform buffer binding point of the block
+    unsigned int               m_buffer;       ///< Internal OpenGL buffer identifier
+    std::vector<unsigned char> m_data;         ///< Contents of the block, as stored in system memory
+    mutable std::size_t        m_dirtyBegin;   ///< Beginning of the range changed since the last upload
+    mutable std::size_t        m_dirtyEnd;     ///< End of the range changed since the last upload
+};
+
+} // namespace sf
+
+
+#endif // SFML_UNIFORMBLOCK_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::UniformBlock
+/// \ingroup graphics
+///
+/// sf::UniformBlock stores a group of shader parameters in
+/// a uniform buffer object. Unlike the parameters set with
+/// sf::Shader::setParameter, which belong to a single shader,
+/// the parameters of a uniform block are shared by all the
+/// shaders that declare a block with the same name: changing
+/// them costs a single transfer to the graphics card, no matter
+/// how many shaders use them.
+///
+/// The block is declared in the shaders with the std140 layout,
+/// and the offsets passed to setParameter must follow the std140
+/// rules (in short: scalars are aligned on 4 bytes, vec2 on 8
+/// bytes, vec3, vec4 and matrix columns on 16 bytes):
+/// \code
+/// layout(std140) uniform Lights
+/// {
+///     vec4  ambient;   // offset 0
+///     vec2  position;  // offset 16
+///     float radius;    // offset 24
+/// };
+/// \endcode
+/// \code
+/// sf::UniformBlock lights;
+/// lights.create("Lights", 32);
+/// lights.setParameter(0, sf::Color(40, 40, 60));
+/// lights.setParameter(16, sf::Vector2f(320.f, 240.f));
+/// lights.setParameter(24, 150.f);
+///
+/// // once per frame, or whenever the values change
+/// sf::UniformBlock::bind(&lights);
+/// \endcode
+///
+/// sf::RenderTarget owns a block named "sf_Frame", updated
+/// when its view changes and once per frame, that shaders can
+/// declare to access the per-frame states:
+/// \code
+/// layout(std140) uniform sf_Frame
+/// {
+///     mat4  sf_ViewMatrix; // projection of the current view
+///     vec4  sf_Viewport;   // left, top, width, height, in pixels
+///     float sf_Time;       // time elapsed since the target was created, in seconds
+/// };
+/// \endcode
+///
+/// Uniform blocks require OpenGL 3.1, or the
+/// GL_ARB_uniform_buffer_object extension; use isAvailable()
+/// to check whether they are supported.
+///
+/// \see sf::Shader, sf::RenderTarget
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,300 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_VERTEXBUFFER_HPP
+#define SFML_VERTEXBUFFER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Window/GlResource.hpp>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Vertex storage living in the graphics card memory
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API VertexBuffer : public Drawable, GlResource
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Usage hints
+    ///
+    /// The usage hint tells the graphics driver how often the
+    /// contents of the buffer are expected to change, so that
+    /// it can place them in the most appropriate memory.
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Usage
+    {
+        Stream,  ///< Contents are updated every frame (or almost)
+        Dynamic, ///< Contents are updated from time to time
+        Static   ///< Contents are specified once and rarely or never updated
+    };
+
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty vertex buffer, drawn as points,
+    /// with the Stream usage hint.
+    ///
+    ////////////////////////////////////////////////////////////
+    VertexBuffer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the vertex buffer with a type and a usage hint
+    ///
+    /// \param type  Type of primitives
+    /// \param usage Usage hint
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit VertexBuffer(PrimitiveType type, Usage usage = Stream);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// The copy is done directly in the graphics card memory
+    /// when the driver supports it.
+    ///
+    /// \param copy instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    VertexBuffer(const VertexBuffer& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~VertexBuffer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the vertex buffer
+    ///
+    /// This function allocates storage for \a vertexCount
+    /// vertices in the graphics card memory. The contents of
+    /// the buffer are undefined until they are updated.
+    ///
+    /// If this function fails, the buffer is left unchanged.
+    ///
+    /// \param vertexCount Number of vertices that the buffer can hold
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(unsigned int vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the whole buffer from an array of vertices
+    ///
+    /// The array must contain at least as many vertices as
+    /// the buffer (see getVertexCount).
+    ///
+    /// \param vertices Array of vertices to copy to the buffer
+    ///
+    /// \return True if the update was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(const Vertex* vertices);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of the buffer from an array of vertices
+    ///
+    /// Only the range [offset, offset + vertexCount) of the
+    /// buffer is uploaded, the rest of the buffer is left
+    /// untouched.
+    ///
+    /// If \a offset is 0 and \a vertexCount is greater than
+    /// the current size of the buffer, the buffer is resized.
+    /// Otherwise the range must fit in the buffer, and the
+    /// function fails if it doesn't.
+    ///
+    /// \param vertices    Array of vertices to copy to the buffer
+    /// \param vertexCount Number of vertices to copy
+    /// \param offset      Index of the first vertex of the buffer to update
+    ///
+    /// \return True if the update was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(const Vertex* vertices, unsigned int vertexCount, unsigned int offset);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the vertex count
+    ///
+    /// \return Number of vertices in the buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getVertexCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the type of primitives to draw
+    ///
+    /// The default primitive type is sf::Points.
+    ///
+    /// \param type Type of primitive
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPrimitiveType(PrimitiveType type);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the type of primitives drawn by the vertex buffer
+    ///
+    /// \return Primitive type
+    ///
+    ////////////////////////////////////////////////////////////
+    PrimitiveType getPrimitiveType() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the usage hint of the buffer
+    ///
+    /// The new hint is applied the next time the buffer
+    /// storage is (re)allocated, with create() or a
+    /// resizing update().
+    ///
+    /// \param usage Usage hint
+    ///
+    ////////////////////////////////////////////////////////////
+    void setUsage(Usage usage);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the usage hint of the buffer
+    ///
+    /// \return Usage hint
+    ///
+    ////////////////////////////////////////////////////////////
+    Usage getUsage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the OpenGL identifier of the buffer
+    ///
+    /// \return OpenGL buffer object, or 0 if not created yet
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getNativeHandle() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    VertexBuffer& operator =(const VertexBuffer& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports vertex buffers
+    ///
+    /// This function should always be called before using
+    /// the vertex buffer features. If it returns false, then
+    /// any attempt to use sf::VertexBuffer will fail.
+    ///
+    /// \return True if vertex buffers are supported, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the vertex buffer to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int  m_buffer;        ///< OpenGL buffer object identifier
+    unsigned int  m_size;          ///< Number of vertices in the buffer
+    PrimitiveType m_primitiveType; ///< Type of primitives to draw
+    Usage         m_usage;         ///< Usage hint of the buffer
+};
+
+} // namespace sf
+
+
+#endif // SFML_VERTEXBUFFER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::VertexBuffer
+/// \ingroup graphics
+///
+/// sf::VertexBuffer is like sf::VertexArray, except that the
+/// vertices are stored in the graphics card memory (as an
+/// OpenGL vertex buffer object) instead of the system memory.
+///
+/// A sf::VertexArray is uploaded to the graphics card every
+/// time it is drawn. A sf::VertexBuffer is only uploaded when
+/// its contents change, which makes it much faster to draw
+/// geometry that doesn't change (or rarely) like level
+/// geometry or tilemaps. Parts of the buffer can be updated
+/// individually, so a single modified vertex doesn't require
+/// the whole buffer to be uploaded again.
+///
+/// The usage hint tells the driver how the buffer is going
+/// to be used: Static for geometry that never changes,
+/// Dynamic for geometry that changes from time to time and
+/// Stream for geometry that changes every frame.
+///
+/// Like sf::VertexArray, it inherits sf::Drawable but is not
+/// transformable. It can also be drawn partially with the
+/// corresponding overload of RenderTarget::draw.
+///
+/// Vertex buffers are drawn with their own draw command, so they
+/// are never merged with other draws when batching is enabled
+/// on the render target.
+///
+/// Example:
+/// \code
+/// std::vector<sf::Vertex> vertices = ...;
+///
+/// sf::VertexBuffer buffer(sf::Triangles, sf::VertexBuffer::Static);
+/// buffer.create(vertices.size());
+/// buffer.update(&vertices[0]);
+/// ...
+/// window.draw(buffer, &tileset);
+///
+/// // Later, change a single triangle
+/// buffer.update(&vertices[30], 3, 30);
+/// \endcode
+///
+/// \see sf::Vertex, sf::VertexArray
+///
+////////////////////////////////////////////////////////////
@@ -444,8 +444,30 @@ protected :
     ////////////////////////////////////////////////////////////
     virtual void onResize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called before the window contents are displayed
+    ///
+    /// This function is called by display() so that derived
+    /// classes can finish their rendering before the buffers
+    /// are swapped.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onDisplay();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called before the window contents are read
+    ///
+    /// This function is called when the back buffer is about
+    /// to be copied (see sf::Texture::update), so that derived
+    /// classes can finish their rendering first.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onCapture();
+
 private:
 
+    friend class Texture;
+
     ////////////////////////////////////////////////////////////
     /// \brief Processes an event before it is sent to the user
     ///
@@ -26,15 +26,25 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/CircleShape.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <algorithm>
 #include <cmath>
 
 
+namespace
+{
+    const float pi = 3.141592654f;
+}
+
+
 namespace sf
 {
 ////////////////////////////////////////////////////////////
 CircleShape::CircleShape(float radius, unsigned int pointCount) :
-m_radius    (radius),
-m_pointCount(pointCount)
+m_radius            (radius),
+m_pointCount        (pointCount),
+m_adaptive          (false),
+m_adaptivePointCount(pointCount)
 {
     update();
 }
@@ -59,26 +69,75 @@ float CircleShape::getRadius() const
 void CircleShape::setPointCount(unsigned int count)
 {
     m_pointCount = count;
+    m_adaptivePointCount = count;
     update();
 }
 
 ////////////////////////////////////////////////////////////
 unsigned int CircleShape::getPointCount() const
 {
-    return m_pointCount;
+    return m_adaptive ? m_adaptivePointCount : m_pointCount;
 }
 
 
 ////////////////////////////////////////////////////////////
-Vector2f CircleShape::getPoint(unsigned int index) const
+void CircleShape::setAdaptivePointCount(bool adaptive)
+{
+    m_adaptive = adaptive;
+    m_adaptivePointCount = m_pointCount;
+}
+
+
+////////////////////////////////////////////////////////////
+bool CircleShape::isAdaptivePointCount() const
 {
-    static const float pi = 3.141592654f;
+    return m_adaptive;
+}
+
 
-    float angle = index * 2 * pi / m_pointCount - pi / 2;
+////////////////////////////////////////////////////////////
+Vector2f CircleShape::getPoint(unsigned int index) const
+{
+    float angle = index * 2 * pi / getPointCount() - pi / 2;
     float x = std::cos(angle) * m_radius;
     float y = std::sin(angle) * m_radius;
 
     return Vector2f(m_radius + x, m_radius + y);
 }
 
+
+////////////////////////////////////////////////////////////
+void CircleShape::draw(RenderTarget& target, RenderStates states) const
+{
+    if (m_adaptive)
+    {
+        // Get the scale of the circle's transform, and the number of pixels per unit of the view
+        const float* matrix = (states.transform * getTransform()).getMatrix();
+        float scale = std::max(std::sqrt(matrix[0] * matrix[0] + matrix[1] * matrix[1]),
+                               std::sqrt(matrix[4] * matrix[4] + matrix[5] * matrix[5]));
+        const View& view = target.getView();
+        IntRect viewport = target.getViewport(view);
+        float pixels = std::max(viewport.width / std::abs(view.getSize().x),
+                                viewport.height / std::abs(view.getSize().y));
+
+        // Use enough points for the middle of each segment to stay within half a pixel of
+        // the circle, rounded up to a multiple of 4 so that zooming doesn't change it constantly
+        float radius = m_radius * scale * pixels;
+        unsigned int count = 8;
+        if (radius > 2.f)
+        {
+            float needed = pi / std::acos(1.f - 0.5f / radius);
+            if (needed < m_pointCount)
+                count = std::max(count, (static_cast<unsigned int>(std::ceil(needed)) + 3) / 4 * 4);
+            else
+                count = m_pointCount;
+        }
+
+        // Shape::draw rebuilds the geometry if the number of points changed
+        m_adaptivePointCount = std::min(count, m_pointCount);
+    }
+
+    Shape::draw(target, states);
+}
+
 } // namespace sf
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/CommandList.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <algorithm>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+CommandList::CommandList() :
+m_commands(),
+m_vertices(),
+m_views   ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void CommandList::clear(const Color& color)
+{
+    Command command;
+    command.type         = Clear;
+    command.vertexBuffer = NULL;
+    command.first        = 0;
+    command.count        = 0;
+    command.color        = color;
+
+    m_commands.push_back(command);
+}
+
+
+////////////////////////////////////////////////////////////
+void CommandList::setView(const View& view)
+{
+    Command command;
+    command.type         = SetView;
+    command.vertexBuffer = NULL;
+    command.first        = static_cast<unsigned int>(m_views.size());
+    command.count        = 0;
+
+    m_views.push_back(view);
+    m_commands.push_back(command);
+}
+
+
+////////////////////////////////////////////////////////////
+void CommandList::draw(const Vertex* vertices, unsigned int vertexCount,
+                       PrimitiveType type, const RenderStates& states)
+{
+    // Nothing to draw?
+    if (!vertices || (vertexCount == 0))
+        return;
+
+    // Extend the previous command if it draws the same kind of primitives with the same states,
+    // so that the list doesn't grow with one command per sprite
+    if (!m_commands.empty() && (type != TrianglesStrip) && (type != TrianglesFan) && (type != LinesStrip))
+    {
+        Command& last = m_commands.back();
+        if ((last.type == DrawVertices) &&
+            (last.primitiveType == type) &&
+            (last.first + last.count == m_vertices.size()) &&
+            (last.states.blendMode == states.blendMode) &&
+            (last.states.texture == states.texture) &&
+            (last.states.shader == states.shader) &&
+            std::equal(states.transform.getMatrix(), states.transform.getMatrix() + 16, last.states.transform.getMatrix()))
+        {
+            m_vertices.insert(m_vertices.end(), vertices, vertices + vertexCount);
+            last.count += vertexCount;
+            return;
+        }
+    }
+
+    Command command;
+    command.type          = DrawVertices;
+    command.states        = states;
+    command.primitiveType = type;
+    command.vertexBuffer  = NULL;
+    command.first         = static_cast<unsigned int>(m_vertices.size());
+    command.count         = vertexCount;
+
+    m_vertices.insert(m_vertices.end(), vertices, vertices + vertexCount);
+    m_commands.push_back(command);
+}
+
+
+////////////////////////////////////////////////////////////
+void CommandList::draw(const VertexArray& vertices, const RenderStates& states)
+{
+    if (vertices.getVertexCount() > 0)
+        draw(&vertices[0], vertices.getVertexCount(), vertices.getPrimitiveType(), states);
+}
+
+
+////////////////////////////////////////////////////////////
+void CommandList::draw(const VertexBuffer& vertexBuffer, unsigned int firstVertex,
+                       unsigned int vertexCount, const RenderStates& states)
+{
+    Command command;
+    command.type          = DrawVertexBuffer;
+    command.states        = states;
+    command.primitiveType = vertexBuffer.getPrimitiveType();
+    command.vertexBuffer  = &vertexBuffer;
+    command.first         = firstVertex;
+    command.count         = vertexCount;
+
+    m_commands.push_back(command);
+}
+
+
+////////////////////////////////////////////////////////////
+void CommandList::reset()
+{
+    m_commands.clear();
+    m_vertices.clear();
+    m_views.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t CommandList::getCommandCount() const
+{
+    return m_commands.size();
+}
+
+
+////////////////////////////////////////////////////////////
+bool CommandList::isEmpty() const
+{
+    return m_commands.empty();
+}
+
+
+////////////////////////////////////////////////////////////
+void CommandList::draw(RenderTarget& target, RenderStates states) const
+{
+    // Views recorded in the list must not leak into the next draw calls
+    View previousView = target.getView();
+    bool viewChanged = false;
+
+    for (std::vector<Command>::const_iterator it = m_commands.begin(); it != m_commands.end(); ++it)
+    {
+        switch (it->type)
+        {
+            case Clear :
+            {
+                target.clear(it->color);
+                break;
+            }
+
+            case SetView :
+            {
+                target.setView(m_views[it->first]);
+                viewChanged = true;
+                break;
+            }
+
+            case DrawVertices :
+            {
+                RenderStates commandStates(it->states);
+                commandStates.transform = states.transform * commandStates.transform;
+                target.draw(&m_vertices[it->first], it->count, it->primitiveType, commandStates);
+                break;
+            }
+
+            case DrawVertexBuffer :
+            {
+                RenderStates commandStates(it->states);
+                commandStates.transform = states.transform * commandStates.transform;
+                target.draw(*it->vertexBuffer, it->first, it->count, commandStates);
+                break;
+            }
+        }
+    }
+
+    if (viewChanged)
+        target.setView(previousView);
+}
+
+} // namespace sf
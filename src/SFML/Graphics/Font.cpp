@@ -26,6 +26,11 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/GlyphTable.hpp>
+#include <SFML/Graphics/SkylinePacker.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/UniformBlock.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
 #include <SFML/System/InputStream.hpp>
 #include <SFML/System/Err.hpp>
 #include <ft2build.h>
@@ -33,8 +38,11 @@
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_BITMAP_H
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 
 
 namespace
@@ -56,17 +64,141 @@ namespace
     void close(FT_Stream)
     {
     }
+
+    // Glyph rasterized by Font::preloadGlyphs, waiting to be written to the texture
+    struct PendingGlyph
+    {
+        sf::Uint32  codePoint; // Code point of the glyph
+        sf::Glyph   glyph;     // Glyph, whose texture rectangle is relative to the block of glyphs
+        std::size_t offset;    // Offset of the glyph's pixels in the staging buffer
+    };
+
+    // Signature and version of the glyph cache files
+    const char       cacheSignature[4] = {'S', 'F', 'G', 'C'};
+    const sf::Uint32 cacheVersion      = 1;
+
+    // Write and read the values of the glyph cache files, which are stored in little endian
+    void writeValue(std::ostream& stream, sf::Uint32 value)
+    {
+        char bytes[4] = {static_cast<char>(value & 0xFF),         static_cast<char>((value >> 8) & 0xFF),
+                         static_cast<char>((value >> 16) & 0xFF), static_cast<char>((value >> 24) & 0xFF)};
+        stream.write(bytes, sizeof(bytes));
+    }
+    void writeValue(std::ostream& stream, const char* value)
+    {
+        sf::Uint32 length = value ? static_cast<sf::Uint32>(std::strlen(value)) : 0;
+        writeValue(stream, length);
+        stream.write(value, length);
+    }
+    bool readValue(std::istream& stream, sf::Uint32& value)
+    {
+        unsigned char bytes[4];
+        if (!stream.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+            return false;
+        value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<sf::Uint32>(bytes[3]) << 24);
+        return true;
+    }
+    bool readValue(std::istream& stream, int& value)
+    {
+        sf::Uint32 bits;
+        if (!readValue(stream, bits))
+            return false;
+        value = static_cast<int>(static_cast<sf::Int32>(bits));
+        return true;
+    }
+    bool readValue(std::istream& stream, std::string& value)
+    {
+        sf::Uint32 length;
+        if (!readValue(stream, length) || (length > 1024))
+            return false;
+        value.resize(length);
+        return (length == 0) || stream.read(&value[0], length);
+    }
+
+    // Squared euclidean distance transform of a sampled function (Felzenszwalb & Huttenlocher);
+    // applied to the rows then to the columns of a grid, it gives the squared distance of
+    // each cell to the nearest cell whose value is 0
+    void distanceTransform(float* values, std::size_t count, std::size_t stride,
+                           std::vector<float>& f, std::vector<std::size_t>& v, std::vector<float>& z)
+    {
+        const float infinity = 1e20f;
+
+        f.resize(count);
+        v.resize(count);
+        z.resize(count + 1);
+        for (std::size_t i = 0; i < count; ++i)
+            f[i] = values[i * stride];
+
+        // Compute the lower envelope of the parabolas rooted at each sample
+        // (the "infinite" values are finite so that the intersections never
+        // fall below z[0], which stops the backtracking)
+        std::size_t k = 0;
+        v[0] = 0;
+        z[0] = -infinity;
+        z[1] = infinity;
+        for (std::size_t q = 1; q < count; ++q)
+        {
+            float fq = f[q] + static_cast<float>(q * q);
+            float s = (fq - (f[v[k]] + static_cast<float>(v[k] * v[k]))) / static_cast<float>(2 * (q - v[k]));
+            while (s <= z[k])
+            {
+                --k;
+                s = (fq - (f[v[k]] + static_cast<float>(v[k] * v[k]))) / static_cast<float>(2 * (q - v[k]));
+            }
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = infinity;
+        }
+
+        // Sample the envelope
+        k = 0;
+        for (std::size_t q = 0; q < count; ++q)
+        {
+            while (z[k + 1] < static_cast<float>(q))
+                ++k;
+            float d = static_cast<float>(q) - static_cast<float>(v[k]);
+            values[q * stride] = d * d + f[v[k]];
+        }
+    }
+
+    // Apply the distance transform to a whole grid
+    void distanceTransform(std::vector<float>& grid, std::size_t width, std::size_t height)
+    {
+        std::vector<float> f;
+        std::vector<std::size_t> v;
+        std::vector<float> z;
+
+        for (std::size_t y = 0; y < height; ++y)
+            distanceTransform(&grid[y * width], width, 1, f, v, z);
+        for (std::size_t x = 0; x < width; ++x)
+            distanceTransform(&grid[x], height, width, f, v, z);
+    }
 }
 
 
 namespace sf
 {
+////////////////////////////////////////////////////////////
+struct Font::Page
+{
+    Page();
+
+    priv::GlyphTable    glyphs;   ///< Table of the glyphs, by size, style and code point
+    priv::KerningTable  kernings; ///< Table of the kerning offsets already computed
+    Texture             texture;  ///< Texture containing the pixels of the glyphs
+    priv::SkylinePacker packer;   ///< Allocator of the areas of the texture
+};
+
+
 ////////////////////////////////////////////////////////////
 Font::Font() :
-m_library  (NULL),
-m_face     (NULL),
-m_streamRec(NULL),
-m_refCount (NULL)
+m_library          (NULL),
+m_face             (NULL),
+m_streamRec        (NULL),
+m_refCount         (NULL),
+m_page             (NULL),
+m_distanceFieldSize(0)
 {
 
 }
@@ -74,12 +206,13 @@ m_refCount (NULL)
 
 ////////////////////////////////////////////////////////////
 Font::Font(const Font& copy) :
-m_library    (copy.m_library),
-m_face       (copy.m_face),
-m_streamRec  (copy.m_streamRec),
-m_refCount   (copy.m_refCount),
-m_pages      (copy.m_pages),
-m_pixelBuffer(copy.m_pixelBuffer)
+m_library          (copy.m_library),
+m_face             (copy.m_face),
+m_streamRec        (copy.m_streamRec),
+m_refCount         (copy.m_refCount),
+m_page             (copy.m_page ? new Page(*copy.m_page) : NULL),
+m_pixelBuffer      (copy.m_pixelBuffer),
+m_distanceFieldSize(copy.m_distanceFieldSize)
 {
     // Note: as FreeType doesn't provide functions for copying/cloning,
     // we must share all the FreeType pointers
@@ -239,25 +372,315 @@ bool Font::loadFromStream(InputStream& stream)
 ////////////////////////////////////////////////////////////
 const Glyph& Font::getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const
 {
-    // Get the page corresponding to the character size
-    GlyphTable& glyphs = m_pages[characterSize].glyphs;
+    // Distance field glyphs are shared by all the sizes and styles
+    if (m_distanceFieldSize)
+    {
+        characterSize = m_distanceFieldSize;
+        bold = false;
+    }
 
-    // Build the key by combining the code point and the bold flag
-    Uint32 key = ((bold ? 1 : 0) << 31) | codePoint;
+    // All the sizes share the same page
+    priv::GlyphTable& glyphs = getPage().glyphs;
 
     // Search the glyph into the cache
-    GlyphTable::const_iterator it = glyphs.find(key);
-    if (it != glyphs.end())
+    const Glyph* glyph = glyphs.find(characterSize, bold, codePoint);
+    if (glyph)
     {
         // Found: just return it
-        return it->second;
+        return *glyph;
     }
     else
     {
         // Not found: we have to load it
-        Glyph glyph = loadGlyph(codePoint, characterSize, bold);
-        return glyphs.insert(std::make_pair(key, glyph)).first->second;
+        return glyphs.insert(characterSize, bold, codePoint, loadGlyph(codePoint, characterSize, bold));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::preloadGlyphs(const String& characters, unsigned int characterSize, bool bold) const
+{
+    // Distance field glyphs are shared by all the sizes and styles
+    if (m_distanceFieldSize)
+    {
+        characterSize = m_distanceFieldSize;
+        bold = false;
+    }
+
+    // Rasterize the missing glyphs one after the other, into a staging buffer
+    Page& page = getPage();
+    std::vector<Uint32> codePoints(characters.begin(), characters.end());
+    std::sort(codePoints.begin(), codePoints.end());
+    codePoints.erase(std::unique(codePoints.begin(), codePoints.end()), codePoints.end());
+
+    std::vector<PendingGlyph> pending;
+    std::vector<Uint8> pixels;
+    unsigned long area = 0;
+    unsigned int maxWidth = 0;
+    unsigned int totalHeight = 0;
+    for (std::vector<Uint32>::const_iterator it = codePoints.begin(); it != codePoints.end(); ++it)
+    {
+        if (page.glyphs.find(characterSize, bold, *it))
+            continue;
+
+        PendingGlyph entry;
+        entry.codePoint = *it;
+        entry.glyph  = rasterizeGlyph(*it, characterSize, bold);
+        entry.offset = pixels.size();
+
+        unsigned int width  = entry.glyph.textureRect.width;
+        unsigned int height = entry.glyph.textureRect.height;
+        pixels.insert(pixels.end(), m_pixelBuffer.begin(), m_pixelBuffer.begin() + width * height * 4);
+        area += width * height;
+        maxWidth = std::max(maxWidth, width);
+        totalHeight += height;
+
+        pending.push_back(entry);
+    }
+
+    // Pack the glyphs together into a block, roughly square, which is then reserved
+    // in the texture as a whole: its contents can be uploaded at once without
+    // overwriting any other glyph
+    unsigned int blockWidth = std::max(maxWidth, static_cast<unsigned int>(std::sqrt(area * 1.2f)) + 1);
+    unsigned int blockHeight = 0;
+    priv::SkylinePacker packer(blockWidth, totalHeight);
+    for (std::vector<PendingGlyph>::iterator it = pending.begin(); it != pending.end(); ++it)
+    {
+        IntRect& rect = it->glyph.textureRect;
+        if ((rect.width > 0) && (rect.height > 0))
+        {
+            if (!packer.insert(rect.width, rect.height, rect))
+            {
+                err() << "Failed to preload glyphs: glyph 0x" << std::hex << it->codePoint << std::dec
+                      << " at size " << characterSize << " doesn't fit in the block" << std::endl;
+                return false;
+            }
+            blockHeight = std::max(blockHeight, static_cast<unsigned int>(rect.top + rect.height));
+        }
+    }
+
+    if (blockHeight > 0)
+    {
+        IntRect block = findGlyphRect(blockWidth, blockHeight);
+        if ((block.width != static_cast<int>(blockWidth)) || (block.height != static_cast<int>(blockHeight)))
+        {
+            err() << "Failed to preload the " << pending.size() << " glyphs from 0x" << std::hex
+                  << pending.front().codePoint << " to 0x" << pending.back().codePoint << std::dec
+                  << " at size " << characterSize << ": the block of " << blockWidth << "x" << blockHeight
+                  << " pixels doesn't fit in the texture of the font" << std::endl;
+            return false;
+        }
+
+        // Copy the glyphs to a transparent block, and send it to the texture
+        std::vector<Uint8> blockPixels(blockWidth * blockHeight * 4, 255);
+        for (std::size_t i = 0; i < blockWidth * blockHeight; ++i)
+            blockPixels[i * 4 + 3] = 0;
+        for (std::vector<PendingGlyph>::iterator it = pending.begin(); it != pending.end(); ++it)
+        {
+            IntRect& rect = it->glyph.textureRect;
+            for (int y = 0; y < rect.height; ++y)
+            {
+                const Uint8* source = &pixels[it->offset + y * rect.width * 4];
+                Uint8* destination = &blockPixels[(rect.left + (rect.top + y) * blockWidth) * 4];
+                std::memcpy(destination, source, rect.width * 4);
+            }
+            rect.left += block.left;
+            rect.top  += block.top;
+        }
+        page.texture.update(&blockPixels[0], blockWidth, blockHeight, block.left, block.top);
+    }
+
+    // Store the new glyphs
+    for (std::vector<PendingGlyph>::const_iterator it = pending.begin(); it != pending.end(); ++it)
+        page.glyphs.insert(characterSize, bold, it->codePoint, it->glyph);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::saveGlyphCache(const std::string& filename) const
+{
+    FT_Face face = static_cast<FT_Face>(m_face);
+    if (!face)
+    {
+        err() << "Failed to save glyph cache \"" << filename << "\" (no font loaded)" << std::endl;
+        return false;
+    }
+
+    std::ofstream file(filename.c_str(), std::ios_base::binary);
+    if (!file)
+    {
+        err() << "Failed to save glyph cache \"" << filename << "\" (failed to open the file)" << std::endl;
+        return false;
+    }
+
+    // Write the header, which identifies the font face and the mode of the glyphs
+    file.write(cacheSignature, sizeof(cacheSignature));
+    writeValue(file, cacheVersion);
+    writeValue(file, face->family_name);
+    writeValue(file, face->style_name);
+    writeValue(file, static_cast<Uint32>(face->num_glyphs));
+    writeValue(file, m_distanceFieldSize);
+
+    // Write the metrics of the glyphs
+    const Page& page = getPage();
+    writeValue(file, static_cast<Uint32>(page.glyphs.getSize()));
+    for (std::size_t i = 0; i < page.glyphs.getSize(); ++i)
+    {
+        const priv::GlyphTable::Entry& entry = page.glyphs.getEntry(i);
+        const Glyph& glyph = entry.glyph;
+        writeValue(file, entry.characterSize);
+        writeValue(file, ((entry.bold ? 1u : 0u) << 31) | entry.codePoint);
+        writeValue(file, glyph.advance);
+        writeValue(file, glyph.bounds.left);
+        writeValue(file, glyph.bounds.top);
+        writeValue(file, glyph.bounds.width);
+        writeValue(file, glyph.bounds.height);
+        writeValue(file, glyph.textureRect.left);
+        writeValue(file, glyph.textureRect.top);
+        writeValue(file, glyph.textureRect.width);
+        writeValue(file, glyph.textureRect.height);
+    }
+
+    // Write the texture; the color channels are always white, only the alpha channel is stored
+    Image image = page.texture.copyToImage();
+    unsigned int width  = image.getSize().x;
+    unsigned int height = image.getSize().y;
+    std::vector<char> alpha(width * height);
+    const Uint8* pixels = image.getPixelsPtr();
+    for (std::size_t i = 0; i < alpha.size(); ++i)
+        alpha[i] = static_cast<char>(pixels[i * 4 + 3]);
+    writeValue(file, width);
+    writeValue(file, height);
+    if (!alpha.empty())
+        file.write(&alpha[0], alpha.size());
+
+    if (!file)
+    {
+        err() << "Failed to save glyph cache \"" << filename << "\" (failed to write the file)" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::loadGlyphCache(const std::string& filename)
+{
+    FT_Face face = static_cast<FT_Face>(m_face);
+    if (!face)
+    {
+        err() << "Failed to load glyph cache \"" << filename << "\" (no font loaded)" << std::endl;
+        return false;
+    }
+
+    std::ifstream file(filename.c_str(), std::ios_base::binary);
+    if (!file)
+    {
+        err() << "Failed to load glyph cache \"" << filename << "\" (failed to open the file)" << std::endl;
+        return false;
+    }
+
+    // Read the header, and check that it matches the font
+    char signature[sizeof(cacheSignature)];
+    Uint32 version, glyphCount, distanceFieldSize;
+    std::string familyName, styleName;
+    if (!file.read(signature, sizeof(signature)) || (std::memcmp(signature, cacheSignature, sizeof(signature)) != 0) ||
+        !readValue(file, version) || (version != cacheVersion))
+    {
+        err() << "Failed to load glyph cache \"" << filename << "\" (not a glyph cache, or unsupported version)" << std::endl;
+        return false;
+    }
+    if (!readValue(file, familyName) || !readValue(file, styleName) || !readValue(file, glyphCount) ||
+        (familyName != (face->family_name ? face->family_name : "")) ||
+        (styleName != (face->style_name ? face->style_name : "")) ||
+        (glyphCount != static_cast<Uint32>(face->num_glyphs)))
+    {
+        err() << "Failed to load glyph cache \"" << filename << "\" (the cache was created with another font)" << std::endl;
+        return false;
     }
+    if (!readValue(file, distanceFieldSize) || (distanceFieldSize != m_distanceFieldSize))
+    {
+        err() << "Failed to load glyph cache \"" << filename << "\" (the distance field mode doesn't match)" << std::endl;
+        return false;
+    }
+
+    // Read the metrics of the glyphs
+    priv::GlyphTable glyphs;
+    bool valid = readValue(file, glyphCount);
+    Int64 usedWidth = 2;  // the white square of the underlines
+    Int64 usedHeight = 2;
+    for (Uint32 i = 0; valid && (i < glyphCount); ++i)
+    {
+        Uint32 size, code;
+        Glyph glyph;
+        valid = readValue(file, size) && readValue(file, code) && readValue(file, glyph.advance) &&
+                readValue(file, glyph.bounds.left) && readValue(file, glyph.bounds.top) &&
+                readValue(file, glyph.bounds.width) && readValue(file, glyph.bounds.height) &&
+                readValue(file, glyph.textureRect.left) && readValue(file, glyph.textureRect.top) &&
+                readValue(file, glyph.textureRect.width) && readValue(file, glyph.textureRect.height);
+
+        // The rectangle must be inside the texture, whose size is checked below
+        const IntRect& rect = glyph.textureRect;
+        valid = valid && (rect.left >= 0) && (rect.top >= 0) && (rect.width >= 0) && (rect.height >= 0);
+        if (!valid)
+            break;
+
+        bool   bold      = (code >> 31) != 0;
+        Uint32 codePoint = code & 0x7FFFFFFF;
+        if (!glyphs.find(size, bold, codePoint))
+            glyphs.insert(size, bold, codePoint, glyph);
+        usedWidth  = std::max(usedWidth,  static_cast<Int64>(rect.left) + rect.width);
+        usedHeight = std::max(usedHeight, static_cast<Int64>(rect.top) + rect.height);
+    }
+
+    // Read the texture
+    Uint32 width = 0, height = 0;
+    valid = valid && readValue(file, width) && readValue(file, height) &&
+            (width > 0) && (height > 0) && (width <= Texture::getMaximumSize()) && (height <= Texture::getMaximumSize()) &&
+            (usedWidth <= static_cast<Int64>(width)) && (usedHeight <= static_cast<Int64>(height));
+
+    // Don't trust the size before knowing that the file contains that many pixels
+    if (valid)
+    {
+        std::streampos position = file.tellg();
+        file.seekg(0, std::ios_base::end);
+        std::streamoff remaining = file.tellg() - position;
+        file.seekg(position);
+        valid = file && (remaining >= static_cast<std::streamoff>(width) * height);
+    }
+
+    std::vector<char> alpha(valid ? width * height : 0);
+    if (!valid || !file.read(&alpha[0], alpha.size()))
+    {
+        err() << "Failed to load glyph cache \"" << filename << "\" (the file is corrupted)" << std::endl;
+        return false;
+    }
+
+    std::vector<Uint8> pixels(width * height * 4, 255);
+    for (std::size_t i = 0; i < alpha.size(); ++i)
+        pixels[i * 4 + 3] = static_cast<Uint8>(alpha[i]);
+
+    // Replace the current glyphs; the area of the texture used by the glyphs
+    // of the cache is reserved as a whole, new glyphs are packed above it
+    Page* page = new Page;
+    page->glyphs = glyphs;
+    if (!page->texture.create(width, height))
+    {
+        delete page;
+        return false;
+    }
+    page->texture.update(&pixels[0]);
+    page->packer.reset(width, height);
+    IntRect used;
+    page->packer.insert(width, static_cast<unsigned int>(usedHeight), used);
+
+    delete m_page;
+    m_page = page;
+
+    return true;
 }
 
 
@@ -270,7 +693,18 @@ int Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize) co
 
     FT_Face face = static_cast<FT_Face>(m_face);
 
-    if (face && FT_HAS_KERNING(face) && setCurrentSize(characterSize))
+    // Invalid font, or no kerning
+    if (!face || !FT_HAS_KERNING(face))
+        return 0;
+
+    // Search the pair into the cache, FreeType is much slower and would
+    // change the current size of the face back and forth
+    priv::KerningTable& kernings = getPage().kernings;
+    int offset = 0;
+    if (kernings.find(characterSize, first, second, offset))
+        return offset;
+
+    if (setCurrentSize(characterSize))
     {
         // Convert the characters to indices
         FT_UInt index1 = FT_Get_Char_Index(face, first);
@@ -280,14 +714,12 @@ int Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize) co
         FT_Vector kerning;
         FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &kerning);
 
-        // Return the X advance
-        return kerning.x >> 6;
-    }
-    else
-    {
-        // Invalid font, or no kerning
-        return 0;
+        // Keep the X advance
+        offset = kerning.x >> 6;
     }
+
+    kernings.insert(characterSize, first, second, offset);
+    return offset;
 }
 
 
@@ -308,9 +740,71 @@ int Font::getLineSpacing(unsigned int characterSize) const
 
 
 ////////////////////////////////////////////////////////////
-const Texture& Font::getTexture(unsigned int characterSize) const
+const Texture& Font::getTexture(unsigned int) const
+{
+    // All the sizes share the same texture
+    return getPage().texture;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::setDistanceField(bool distanceField, unsigned int referenceSize)
+{
+    unsigned int size = distanceField ? referenceSize : 0;
+    if (size == m_distanceFieldSize)
+        return true;
+
+    // Keep the rasterized glyphs if they couldn't be rendered
+    if (distanceField && !isDistanceFieldAvailable())
+    {
+        err() << "Failed to enable the distance field mode of the font: your system doesn't support the distance field shader" << std::endl;
+        return false;
+    }
+
+    // The glyphs loaded so far don't match the new mode
+    m_distanceFieldSize = size;
+    delete m_page;
+    m_page = NULL;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::isDistanceField() const
+{
+    return m_distanceFieldSize != 0;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Font::getDistanceFieldSize() const
+{
+    return m_distanceFieldSize;
+}
+
+
+////////////////////////////////////////////////////////////
+float Font::getDistanceFieldSpread() const
 {
-    return m_pages[characterSize].texture;
+    // An eighth of the size leaves enough room for outlines and bold
+    // without wasting too much of the texture on the padding
+    if (m_distanceFieldSize)
+        return static_cast<float>(std::max(m_distanceFieldSize / 8, 2u));
+    else
+        return 0.f;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::isDistanceFieldAvailable()
+{
+    // The program reads the view from the "sf_Frame" uniform block
+    if (!Shader::isAvailable() || !UniformBlock::isAvailable())
+        return false;
+
+    // GLSL 1.30 comes with OpenGL 3.0
+    return GLEW_VERSION_3_0 != 0;
 }
 
 
@@ -321,9 +815,10 @@ Font& Font::operator =(const Font& right)
 
     std::swap(m_library,     temp.m_library);
     std::swap(m_face,        temp.m_face);
-    std::swap(m_pages,       temp.m_pages);
+    std::swap(m_page,        temp.m_page);
     std::swap(m_pixelBuffer, temp.m_pixelBuffer);
     std::swap(m_refCount,    temp.m_refCount);
+    std::swap(m_distanceFieldSize, temp.m_distanceFieldSize);
 
     return *this;
 }
@@ -363,13 +858,38 @@ void Font::cleanup()
     m_face      = NULL;
     m_streamRec = NULL;
     m_refCount  = NULL;
-    m_pages.clear();
     m_pixelBuffer.clear();
+
+    // Destroy the glyphs
+    delete m_page;
+    m_page = NULL;
 }
 
 
 ////////////////////////////////////////////////////////////
 Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const
+{
+    // Rasterize the glyph
+    Glyph glyph = rasterizeGlyph(codePoint, characterSize, bold);
+
+    int width  = glyph.textureRect.width;
+    int height = glyph.textureRect.height;
+    if ((width > 0) && (height > 0))
+    {
+        // Find a good position for the new glyph into the texture
+        glyph.textureRect = findGlyphRect(width, height);
+
+        // Write the pixels to the texture, unless there was no room for them
+        if ((glyph.textureRect.width == width) && (glyph.textureRect.height == height))
+            getPage().texture.update(&m_pixelBuffer[0], width, height, glyph.textureRect.left, glyph.textureRect.top);
+    }
+
+    return glyph;
+}
+
+
+////////////////////////////////////////////////////////////
+Glyph Font::rasterizeGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const
 {
     // The glyph to return
     Glyph glyph;
@@ -422,14 +942,10 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
     if ((width > 0) && (height > 0))
     {
         // Leave a small padding around characters, so that filtering doesn't
-        // pollute them with pixels from neighbours
-        const unsigned int padding = 1;
-
-        // Get the glyphs page corresponding to the character size
-        Page& page = m_pages[characterSize];
-
-        // Find a good position for the new glyph into the texture
-        glyph.textureRect = findGlyphRect(page, width + 2 * padding, height + 2 * padding);
+        // pollute them with pixels from neighbours; distance fields also need
+        // room around the outlines for the distances
+        const float        spread  = getDistanceFieldSpread();
+        const unsigned int padding = 1 + static_cast<unsigned int>(spread);
 
         // Compute the glyph's bounding box
         glyph.bounds.left   = bitmapGlyph->left - padding;
@@ -437,8 +953,14 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
         glyph.bounds.width  = width + 2 * padding;
         glyph.bounds.height = height + 2 * padding;
 
-        // Extract the glyph's pixels from the bitmap
-        m_pixelBuffer.resize(width * height * 4, 255);
+        // Extract the glyph's pixels from the bitmap; the padding is written as well
+        // since the texture is not cleared when it grows, it must stay transparent
+        int bufferWidth  = width + 2 * padding;
+        int bufferHeight = height + 2 * padding;
+        glyph.textureRect = IntRect(0, 0, bufferWidth, bufferHeight);
+        m_pixelBuffer.assign(bufferWidth * bufferHeight * 4, 255);
+        for (int i = 0; i < bufferWidth * bufferHeight; ++i)
+            m_pixelBuffer[i * 4 + 3] = 0;
         const Uint8* pixels = bitmap.buffer;
         if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
         {
@@ -448,7 +970,7 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
                 for (int x = 0; x < width; ++x)
                 {
                     // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
+                    std::size_t index = ((x + padding) + (y + padding) * bufferWidth) * 4 + 3;
                     m_pixelBuffer[index] = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
                 }
                 pixels += bitmap.pitch;
@@ -462,19 +984,16 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
                 for (int x = 0; x < width; ++x)
                 {
                     // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
+                    std::size_t index = ((x + padding) + (y + padding) * bufferWidth) * 4 + 3;
                     m_pixelBuffer[index] = pixels[x];
                 }
                 pixels += bitmap.pitch;
             }
         }
 
-        // Write the pixels to the texture
-        unsigned int x = glyph.textureRect.left + padding;
-        unsigned int y = glyph.textureRect.top + padding;
-        unsigned int w = glyph.textureRect.width - 2 * padding;
-        unsigned int h = glyph.textureRect.height - 2 * padding;
-        page.texture.update(&m_pixelBuffer[0], w, h, x, y);
+        // Replace the coverage by its distance field, which extends over the padding
+        if (spread > 0)
+            computeDistanceField(bufferWidth, bufferHeight, spread);
     }
 
     // Delete the FT glyph
@@ -486,70 +1005,83 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
 
 
 ////////////////////////////////////////////////////////////
-IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height) const
+Font::Page& Font::getPage() const
 {
-    // Find the line that fits well the glyph
-    Row* row = NULL;
-    float bestRatio = 0;
-    for (std::vector<Row>::iterator it = page.rows.begin(); it != page.rows.end() && !row; ++it)
-    {
-        float ratio = static_cast<float>(height) / it->height;
-
-        // Ignore rows that are either too small or too high
-        if ((ratio < 0.7f) || (ratio > 1.f))
-            continue;
+    if (!m_page)
+        m_page = new Page;
 
-        // Check if there's enough horizontal space left in the row
-        if (width > page.texture.getSize().x - it->width)
-            continue;
+    return *m_page;
+}
 
-        // Make sure that this new row is the best found so far
-        if (ratio < bestRatio)
-            continue;
 
-        // The current row passed all the tests: we can select it
-        row = &*it;
-        bestRatio = ratio;
-    }
+////////////////////////////////////////////////////////////
+IntRect Font::findGlyphRect(unsigned int width, unsigned int height) const
+{
+    Page& page = getPage();
 
-    // If we didn't find a matching row, create a new one (10% taller than the glyph)
-    if (!row)
+    IntRect rect;
+    while (!page.packer.insert(width, height, rect))
     {
-        int rowHeight = height + height / 10;
-        while (page.nextRow + rowHeight >= page.texture.getSize().y)
+        // Not enough space: enlarge the texture if possible, along its smallest side
+        unsigned int textureWidth  = page.texture.getSize().x;
+        unsigned int textureHeight = page.texture.getSize().y;
+        if (textureHeight < textureWidth)
+            textureHeight *= 2;
+        else
+            textureWidth *= 2;
+
+        if ((textureWidth > Texture::getMaximumSize()) || (textureHeight > Texture::getMaximumSize()))
         {
-            // Not enough space: resize the texture if possible
-            unsigned int textureWidth  = page.texture.getSize().x;
-            unsigned int textureHeight = page.texture.getSize().y;
-            if ((textureWidth * 2 <= Texture::getMaximumSize()) && (textureHeight * 2 <= Texture::getMaximumSize()))
-            {
-                // Make the texture 2 times bigger
-                Image newImage;
-                newImage.create(textureWidth * 2, textureHeight * 2, Color(255, 255, 255, 0));
-                newImage.copy(page.texture.copyToImage(), 0, 0);
-                page.texture.loadFromImage(newImage);
-            }
-            else
-            {
-                // Oops, we've reached the maximum texture size...
-                err() << "Failed to add a new character to the font: the maximum texture size has been reached" << std::endl;
-                return IntRect(0, 0, 2, 2);
-            }
+            // Oops, we've reached the maximum texture size...
+            err() << "Failed to add a new character to the font: the maximum texture size has been reached" << std::endl;
+            return IntRect(0, 0, 2, 2);
         }
 
-        // We can now create the new row
-        page.rows.push_back(Row(page.nextRow, rowHeight));
-        page.nextRow += rowHeight;
-        row = &page.rows.back();
+        // Copy the glyphs to the new texture on the graphics card, their
+        // rectangles don't change so the texts that use them remain valid
+        Texture texture;
+        if (!texture.create(textureWidth, textureHeight))
+            return IntRect(0, 0, 2, 2);
+        texture.setSmooth(true);
+        texture.update(page.texture);
+        page.texture.swap(texture);
+        page.packer.grow(textureWidth, textureHeight);
     }
 
-    // Find the glyph's rectangle on the selected row
-    IntRect rect(row->width, row->top, width, height);
+    return rect;
+}
+
 
-    // Update the row informations
-    row->width += width;
+////////////////////////////////////////////////////////////
+void Font::computeDistanceField(unsigned int width, unsigned int height, float spread) const
+{
+    const float infinity = 1e20f;
+    std::size_t count = static_cast<std::size_t>(width) * height;
+
+    // Split the glyph into inside and outside pixels; each grid holds 0 on the
+    // pixels that the distances are measured to
+    std::vector<float> toInside(count, infinity);
+    std::vector<float> toOutside(count, 0.f);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (m_pixelBuffer[i * 4 + 3] >= 128)
+        {
+            toInside[i]  = 0.f;
+            toOutside[i] = infinity;
+        }
+    }
+    distanceTransform(toInside, width, height);
+    distanceTransform(toOutside, width, height);
 
-    return rect;
+    // Store the signed distance to the outline (half a pixel away from the pixel centers)
+    // in the alpha channel, mapping [-spread, spread] to [0, 255]
+    float scale = 127.5f / spread;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float distance = (toOutside[i] > 0.f) ? std::sqrt(toOutside[i]) - 0.5f : 0.5f - std::sqrt(toInside[i]);
+        float value = 127.5f + distance * scale;
+        m_pixelBuffer[i * 4 + 3] = static_cast<Uint8>(std::min(std::max(value, 0.f), 255.f) + 0.5f);
+    }
 }
 
 
@@ -575,20 +1107,18 @@ bool Font::setCurrentSize(unsigned int characterSize) const
 
 ////////////////////////////////////////////////////////////
 Font::Page::Page() :
-nextRow(2)
+packer(256, 256)
 {
-    // Make sure that the texture is initialized by default
-    sf::Image image;
-    image.create(128, 128, Color(255, 255, 255, 0));
+    // Create the texture; it is not cleared, every area is written when it's reserved
+    texture.create(256, 256);
+    texture.setSmooth(true);
 
     // Reserve a 2x2 white square for texturing underlines
-    for (int x = 0; x < 2; ++x)
-        for (int y = 0; y < 2; ++y)
-            image.setPixel(x, y, Color(255, 255, 255, 255));
-
-    // Create the texture
-    texture.loadFromImage(image);
-    texture.setSmooth(true);
+    IntRect rect;
+    packer.insert(2, 2, rect);
+    const Uint8 white[2 * 2 * 4] = {255, 255, 255, 255, 255, 255, 255, 255,
+                                    255, 255, 255, 255, 255, 255, 255, 255};
+    texture.update(white, 2, 2, rect.left, rect.top);
 }
 
 } // namespace sf
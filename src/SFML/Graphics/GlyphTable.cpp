@@ -0,0 +1,288 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/GlyphTable.hpp>
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+    // Code points beyond the Unicode range are not mapped to glyphs by fonts: they
+    // all share the last 21-bit value, so that the keys never overlap
+    sf::Uint64 getKeyCodePoint(sf::Uint32 codePoint)
+    {
+        return (codePoint <= 0x10FFFF) ? codePoint : 0x1FFFFF;
+    }
+
+    // Build the key of a glyph: character size, then bold flag and code point
+    sf::Uint64 getGlyphKey(unsigned int characterSize, bool bold, sf::Uint32 codePoint)
+    {
+        return (static_cast<sf::Uint64>(characterSize) << 32) | ((bold ? 1u : 0u) << 31) | getKeyCodePoint(codePoint);
+    }
+
+    // Build the key of a kerning pair: character size, then code points of 21 bits each
+    sf::Uint64 getKerningKey(unsigned int characterSize, sf::Uint32 first, sf::Uint32 second)
+    {
+        return (static_cast<sf::Uint64>(characterSize) << 42) | (getKeyCodePoint(first) << 21) | getKeyCodePoint(second);
+    }
+
+    // Mix the bits of a key, so that close keys spread over the whole table (splitmix64 finalizer)
+    sf::Uint64 hash(sf::Uint64 key)
+    {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return key;
+    }
+
+    // Find the slot holding a key, or the free slot where it would be stored
+    std::size_t findSlot(const std::vector<sf::priv::HashSlot>& slots, sf::Uint64 key)
+    {
+        // The size of the table is a power of two, and it is never full
+        std::size_t mask = slots.size() - 1;
+        std::size_t i = static_cast<std::size_t>(hash(key)) & mask;
+        while (slots[i].index && (slots[i].key != key))
+            i = (i + 1) & mask;
+
+        return i;
+    }
+
+    // Store a key which is not in a table yet, enlarging the table to keep it at most half full
+    void insertSlot(std::vector<sf::priv::HashSlot>& slots, std::size_t count, sf::Uint64 key, sf::Uint32 index)
+    {
+        if (count * 2 > slots.size())
+        {
+            sf::priv::HashSlot empty = {0, 0};
+            std::vector<sf::priv::HashSlot> table(slots.empty() ? 16 : slots.size() * 2, empty);
+            for (std::vector<sf::priv::HashSlot>::const_iterator it = slots.begin(); it != slots.end(); ++it)
+            {
+                if (it->index)
+                    table[findSlot(table, it->key)] = *it;
+            }
+            slots.swap(table);
+        }
+
+        sf::priv::HashSlot& slot = slots[findSlot(slots, key)];
+        slot.key   = key;
+        slot.index = index;
+    }
+
+    // Look up a key in a table; return its index plus one, or 0 if it's not in the table
+    sf::Uint32 lookup(const std::vector<sf::priv::HashSlot>& slots, sf::Uint64 key)
+    {
+        return slots.empty() ? 0 : slots[findSlot(slots, key)].index;
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+GlyphTable::GlyphTable() :
+m_entries  (),
+m_blocks   (),
+m_lastBlock(0),
+m_slots    (),
+m_slotCount(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+GlyphTable::GlyphTable(const GlyphTable& copy) :
+m_entries  (),
+m_blocks   (),
+m_lastBlock(0),
+m_slots    (),
+m_slotCount(0)
+{
+    *this = copy;
+}
+
+
+////////////////////////////////////////////////////////////
+GlyphTable& GlyphTable::operator =(const GlyphTable& right)
+{
+    // The blocks point to the entries of their own table, they must be rebuilt
+    if (this != &right)
+    {
+        clear();
+        for (std::deque<Entry>::const_iterator it = right.m_entries.begin(); it != right.m_entries.end(); ++it)
+            insert(it->characterSize, it->bold, it->codePoint, it->glyph);
+    }
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+const Glyph* GlyphTable::find(unsigned int characterSize, bool bold, Uint32 codePoint) const
+{
+    if (codePoint < 256)
+    {
+        // The entries never move, the blocks point directly to them
+        std::size_t block = findBlock(characterSize, bold);
+        return (block < m_blocks.size()) ? m_blocks[block].glyphs[codePoint] : NULL;
+    }
+    else
+    {
+        Uint32 index = lookup(m_slots, getGlyphKey(characterSize, bold, codePoint));
+        return index ? &m_entries[index - 1].glyph : NULL;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+const Glyph& GlyphTable::insert(unsigned int characterSize, bool bold, Uint32 codePoint, const Glyph& glyph)
+{
+    assert(!find(characterSize, bold, codePoint));
+
+    Entry entry;
+    entry.characterSize = characterSize;
+    entry.bold          = bold;
+    entry.codePoint     = codePoint;
+    entry.glyph         = glyph;
+    m_entries.push_back(entry);
+    Uint32 index = static_cast<Uint32>(m_entries.size());
+
+    if (codePoint < 256)
+    {
+        // Create the block of the size and style if it's the first glyph
+        std::size_t block = findBlock(characterSize, bold);
+        if (block == m_blocks.size())
+        {
+            LatinBlock newBlock;
+            newBlock.characterSize = characterSize;
+            newBlock.bold          = bold;
+            std::fill(newBlock.glyphs, newBlock.glyphs + 256, static_cast<const Glyph*>(NULL));
+            m_blocks.push_back(newBlock);
+            m_lastBlock = block;
+        }
+
+        m_blocks[block].glyphs[codePoint] = &m_entries.back().glyph;
+    }
+    else
+    {
+        m_slotCount++;
+        insertSlot(m_slots, m_slotCount, getGlyphKey(characterSize, bold, codePoint), index);
+    }
+
+    return m_entries.back().glyph;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlyphTable::clear()
+{
+    m_entries.clear();
+    m_blocks.clear();
+    m_lastBlock = 0;
+    m_slots.clear();
+    m_slotCount = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t GlyphTable::getSize() const
+{
+    return m_entries.size();
+}
+
+
+////////////////////////////////////////////////////////////
+const GlyphTable::Entry& GlyphTable::getEntry(std::size_t index) const
+{
+    return m_entries[index];
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t GlyphTable::findBlock(unsigned int characterSize, bool bold) const
+{
+    // A text uses a single size and style, so consecutive lookups most likely hit the same block
+    if ((m_lastBlock < m_blocks.size()) &&
+        (m_blocks[m_lastBlock].characterSize == characterSize) && (m_blocks[m_lastBlock].bold == bold))
+        return m_lastBlock;
+
+    // There are only a few sizes and styles in use, a linear search is enough
+    for (std::size_t i = 0; i < m_blocks.size(); ++i)
+    {
+        if ((m_blocks[i].characterSize == characterSize) && (m_blocks[i].bold == bold))
+        {
+            m_lastBlock = i;
+            return i;
+        }
+    }
+
+    return m_blocks.size();
+}
+
+
+////////////////////////////////////////////////////////////
+KerningTable::KerningTable() :
+m_kernings(),
+m_slots   ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool KerningTable::find(unsigned int characterSize, Uint32 first, Uint32 second, int& kerning) const
+{
+    Uint32 index = lookup(m_slots, getKerningKey(characterSize, first, second));
+    if (!index)
+        return false;
+
+    kerning = m_kernings[index - 1];
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void KerningTable::insert(unsigned int characterSize, Uint32 first, Uint32 second, int kerning)
+{
+    m_kernings.push_back(kerning);
+    insertSlot(m_slots, m_kernings.size(), getKerningKey(characterSize, first, second), static_cast<Uint32>(m_kernings.size()));
+}
+
+
+////////////////////////////////////////////////////////////
+void KerningTable::clear()
+{
+    m_kernings.clear();
+    m_slots.clear();
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,253 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_GLYPHTABLE_HPP
+#define SFML_GLYPHTABLE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Glyph.hpp>
+#include <deque>
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Slot of an open-addressing hash table
+///
+////////////////////////////////////////////////////////////
+struct HashSlot
+{
+    Uint64 key;   ///< Key of the entry stored in the slot
+    Uint32 index; ///< Index of the entry plus one, 0 if the slot is free
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Cache of the glyphs of a font
+///
+/// The glyphs are identified by their character size, their
+/// bold flag and their code point. The characters of the
+/// ASCII and Latin-1 ranges, which make up most of the texts,
+/// are found in a table directly indexed by the code point;
+/// the others go through an open-addressing hash table.
+/// Glyphs never move once inserted, references to them
+/// remain valid until the table is cleared.
+///
+/// Code points beyond the Unicode range (above 0x10FFFF)
+/// are not mapped by fonts: they all share the same glyph.
+///
+////////////////////////////////////////////////////////////
+class GlyphTable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Glyph stored in the table, with its identity
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        unsigned int characterSize; ///< Character size of the glyph
+        bool         bold;          ///< Is the glyph bold?
+        Uint32       codePoint;     ///< Code point of the glyph
+        Glyph        glyph;         ///< Metrics of the glyph
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    GlyphTable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    GlyphTable(const GlyphTable& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    GlyphTable& operator =(const GlyphTable& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Look for a glyph
+    ///
+    /// \param characterSize Character size of the glyph
+    /// \param bold          Is the glyph bold?
+    /// \param codePoint     Code point of the glyph
+    ///
+    /// \return Pointer to the glyph, or NULL if it is not in the table
+    ///
+    ////////////////////////////////////////////////////////////
+    const Glyph* find(unsigned int characterSize, bool bold, Uint32 codePoint) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a glyph which is not in the table yet
+    ///
+    /// \param characterSize Character size of the glyph
+    /// \param bold          Is the glyph bold?
+    /// \param codePoint     Code point of the glyph
+    /// \param glyph         Metrics of the glyph
+    ///
+    /// \return Reference to the stored glyph
+    ///
+    ////////////////////////////////////////////////////////////
+    const Glyph& insert(unsigned int characterSize, bool bold, Uint32 codePoint, const Glyph& glyph);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the glyphs
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of glyphs in the table
+    ///
+    /// \return Number of glyphs
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a glyph of the table, in insertion order
+    ///
+    /// \param index Index of the glyph, in [0, getSize() - 1]
+    ///
+    /// \return Glyph and its identity
+    ///
+    ////////////////////////////////////////////////////////////
+    const Entry& getEntry(std::size_t index) const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Direct table of the Latin-1 glyphs of a size and style
+    ///
+    ////////////////////////////////////////////////////////////
+    struct LatinBlock
+    {
+        unsigned int characterSize; ///< Character size of the glyphs
+        bool         bold;          ///< Are the glyphs bold?
+        const Glyph* glyphs[256];   ///< Glyph of each code point, NULL if not loaded
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the Latin-1 block of a size and style
+    ///
+    /// \param characterSize Character size of the glyphs
+    /// \param bold          Are the glyphs bold?
+    ///
+    /// \return Index of the block, or the number of blocks if there's none
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t findBlock(unsigned int characterSize, bool bold) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::deque<Entry>       m_entries;   ///< Glyphs of the table, in insertion order
+    std::vector<LatinBlock> m_blocks;    ///< Direct tables of the Latin-1 glyphs
+    mutable std::size_t     m_lastBlock; ///< Index of the last block used, checked first
+    std::vector<HashSlot>   m_slots;     ///< Hash table of the other glyphs
+    std::size_t             m_slotCount; ///< Number of used slots in the hash table
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Cache of the kerning offsets of a font
+///
+/// The offsets are identified by their character size and
+/// the code points of the two characters, and stored in an
+/// open-addressing hash table. Like in sf::priv::GlyphTable,
+/// code points beyond the Unicode range are not distinguished.
+///
+////////////////////////////////////////////////////////////
+class KerningTable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    KerningTable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Look for the kerning offset of a pair of characters
+    ///
+    /// \param characterSize Character size
+    /// \param first         Code point of the first character
+    /// \param second        Code point of the second character
+    /// \param kerning       Receives the kerning offset if it is found
+    ///
+    /// \return True if the pair is in the table
+    ///
+    ////////////////////////////////////////////////////////////
+    bool find(unsigned int characterSize, Uint32 first, Uint32 second, int& kerning) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the kerning offset of a pair which is not in the table yet
+    ///
+    /// \param characterSize Character size
+    /// \param first         Code point of the first character
+    /// \param second        Code point of the second character
+    /// \param kerning       Kerning offset of the pair
+    ///
+    ////////////////////////////////////////////////////////////
+    void insert(unsigned int characterSize, Uint32 first, Uint32 second, int kerning);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the kerning offsets
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<int>      m_kernings;  ///< Kerning offsets, in insertion order
+    std::vector<HashSlot> m_slots;     ///< Hash table of the offsets
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_GLYPHTABLE_HPP
@@ -27,24 +27,67 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/ImageLoader.hpp>
+#include <SFML/Graphics/PixelKernels.hpp>
 #include <SFML/System/Err.hpp>
 #include <algorithm>
 #include <cstring>
 
 
+namespace
+{
+    // Release the pixels decoded by the image loader
+    void freeLoaderPixels(sf::Uint8* pixels, void*)
+    {
+        sf::priv::ImageLoader::freePixels(pixels);
+    }
+}
+
+
 namespace sf
 {
 ////////////////////////////////////////////////////////////
 Image::Image() :
-m_size(0, 0)
+m_size       (0, 0),
+m_adopted    (NULL),
+m_deleter    (NULL),
+m_deleterData(NULL),
+m_request    (NULL)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+Image::Image(const Image& copy) :
+m_size       (copy.m_size),
+m_adopted    (NULL),
+m_deleter    (NULL),
+m_deleterData(NULL),
+m_request    (copy.m_request)
 {
+    if (copy.m_adopted)
+        m_pixels.assign(copy.m_adopted, copy.m_adopted + m_size.x * m_size.y * 4);
+    else
+        m_pixels = copy.m_pixels;
+
+    if (m_request)
+        m_request->acquire();
+}
+
 
+////////////////////////////////////////////////////////////
+Image::~Image()
+{
+    cancelLoad();
+    releasePixels();
 }
 
 
 ////////////////////////////////////////////////////////////
 void Image::create(unsigned int width, unsigned int height, const Color& color)
 {
+    cancelLoad();
+
     if (width && height)
     {
         // Assign the new size
@@ -52,25 +95,18 @@ void Image::create(unsigned int width, unsigned int height, const Color& color)
         m_size.y = height;
 
         // Resize the pixel buffer
+        releasePixels();
         m_pixels.resize(width * height * 4);
 
         // Fill it with the specified color
-        Uint8* ptr = &m_pixels[0];
-        Uint8* end = ptr + m_pixels.size();
-        while (ptr < end)
-        {
-            *ptr++ = color.r;
-            *ptr++ = color.g;
-            *ptr++ = color.b;
-            *ptr++ = color.a;
-        }
+        priv::fillPixels(&m_pixels[0], width * height, color);
     }
     else
     {
         // Create an empty image
         m_size.x = 0;
         m_size.y = 0;
-        m_pixels.clear();
+        releasePixels();
     }
 }
 
@@ -78,6 +114,8 @@ void Image::create(unsigned int width, unsigned int height, const Color& color)
 ////////////////////////////////////////////////////////////
 void Image::create(unsigned int width, unsigned int height, const Uint8* pixels)
 {
+    cancelLoad();
+
     if (pixels && width && height)
     {
         // Assign the new size
@@ -86,6 +124,7 @@ void Image::create(unsigned int width, unsigned int height, const Uint8* pixels)
 
         // Copy the pixels
         std::size_t size = width * height * 4;
+        releasePixels();
         m_pixels.resize(size);
         std::memcpy(&m_pixels[0], pixels, size); // faster than vector::assign
     }
@@ -94,7 +133,35 @@ void Image::create(unsigned int width, unsigned int height, const Uint8* pixels)
         // Create an empty image
         m_size.x = 0;
         m_size.y = 0;
-        m_pixels.clear();
+        releasePixels();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Image::adopt(unsigned int width, unsigned int height, Uint8* pixels, PixelsDeleter deleter, void* userData)
+{
+    cancelLoad();
+    releasePixels();
+
+    // The adopted buffer replaces the owned storage, release its memory
+    std::vector<Uint8>().swap(m_pixels);
+
+    if (pixels && width && height)
+    {
+        m_size.x      = width;
+        m_size.y      = height;
+        m_adopted     = pixels;
+        m_deleter     = deleter;
+        m_deleterData = userData;
+    }
+    else
+    {
+        // Create an empty image, we don't need the buffer
+        m_size.x = 0;
+        m_size.y = 0;
+        if (pixels && deleter)
+            deleter(pixels, userData);
     }
 }
 
@@ -102,28 +169,97 @@ void Image::create(unsigned int width, unsigned int height, const Uint8* pixels)
 ////////////////////////////////////////////////////////////
 bool Image::loadFromFile(const std::string& filename)
 {
-    return priv::ImageLoader::getInstance().loadImageFromFile(filename, m_pixels, m_size);
+    cancelLoad();
+
+    Uint8*   pixels;
+    Vector2u size;
+    if (!priv::ImageLoader::getInstance().loadImageFromFile(filename, pixels, size))
+        return false;
+
+    adopt(size.x, size.y, pixels, &freeLoaderPixels);
+    return true;
 }
 
 
 ////////////////////////////////////////////////////////////
 bool Image::loadFromMemory(const void* data, std::size_t size)
 {
-    return priv::ImageLoader::getInstance().loadImageFromMemory(data, size, m_pixels, m_size);
+    cancelLoad();
+
+    Uint8*   pixels;
+    Vector2u imageSize;
+    if (!priv::ImageLoader::getInstance().loadImageFromMemory(data, size, pixels, imageSize))
+        return false;
+
+    adopt(imageSize.x, imageSize.y, pixels, &freeLoaderPixels);
+    return true;
 }
 
 
 ////////////////////////////////////////////////////////////
 bool Image::loadFromStream(InputStream& stream)
 {
-    return priv::ImageLoader::getInstance().loadImageFromStream(stream, m_pixels, m_size);
+    cancelLoad();
+
+    Uint8*   pixels;
+    Vector2u size;
+    if (!priv::ImageLoader::getInstance().loadImageFromStream(stream, pixels, size))
+        return false;
+
+    adopt(size.x, size.y, pixels, &freeLoaderPixels);
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Image::loadFromFileAsync(const std::string& filename)
+{
+    cancelLoad();
+
+    m_request = priv::ImageLoader::getInstance().loadImageFromFileAsync(filename);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Image::isLoading() const
+{
+    return m_request && !m_request->isDone();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Image::waitForLoad()
+{
+    if (!m_request)
+        return true;
+
+    priv::ImageLoadRequest* request = m_request;
+    m_request = NULL;
+
+    priv::ImageLoader::getInstance().wait(*request);
+
+    // Adopt the decoded pixels if no other image shares the request, copy them otherwise
+    Vector2u size;
+    bool     owned;
+    Uint8*   pixels = request->takePixels(size, owned);
+    if (pixels)
+    {
+        if (owned)
+            adopt(size.x, size.y, pixels, &freeLoaderPixels);
+        else
+            create(size.x, size.y, pixels);
+    }
+
+    request->release();
+
+    return pixels != NULL;
 }
 
 
 ////////////////////////////////////////////////////////////
 bool Image::saveToFile(const std::string& filename) const
 {
-    return priv::ImageLoader::getInstance().saveImageToFile(filename, m_pixels, m_size);
+    return priv::ImageLoader::getInstance().saveImageToFile(filename, ImageView(*this));
 }
 
 
@@ -138,26 +274,20 @@ Vector2u Image::getSize() const
 void Image::createMaskFromColor(const Color& color, Uint8 alpha)
 {
     // Make sure that the image is not empty
-    if (!m_pixels.empty())
+    Uint8* ptr = getPixelData();
+    if (ptr)
     {
         // Replace the alpha of the pixels that match the transparent color
-        Uint8* ptr = &m_pixels[0];
-        Uint8* end = ptr + m_pixels.size();
-        while (ptr < end)
-        {
-            if ((ptr[0] == color.r) && (ptr[1] == color.g) && (ptr[2] == color.b) && (ptr[3] == color.a))
-                ptr[3] = alpha;
-            ptr += 4;
-        }
+        priv::maskPixels(ptr, m_size.x * m_size.y, color, alpha);
     }
 }
 
 
 ////////////////////////////////////////////////////////////
-void Image::copy(const Image& source, unsigned int destX, unsigned int destY, const IntRect& sourceRect, bool applyAlpha)
+void Image::copy(const ImageView& source, unsigned int destX, unsigned int destY, const IntRect& sourceRect, bool applyAlpha)
 {
     // Make sure that both images are valid
-    if ((source.m_size.x == 0) || (source.m_size.y == 0) || (m_size.x == 0) || (m_size.y == 0))
+    if (source.isEmpty() || (m_size.x == 0) || (m_size.y == 0))
         return;
 
     // Adjust the source rectangle
@@ -166,15 +296,15 @@ void Image::copy(const Image& source, unsigned int destX, unsigned int destY, co
     {
         srcRect.left   = 0;
         srcRect.top    = 0;
-        srcRect.width  = source.m_size.x;
-        srcRect.height = source.m_size.y;
+        srcRect.width  = source.width;
+        srcRect.height = source.height;
     }
     else
     {
         if (srcRect.left   < 0) srcRect.left = 0;
         if (srcRect.top    < 0) srcRect.top  = 0;
-        if (srcRect.width  > static_cast<int>(source.m_size.x)) srcRect.width  = source.m_size.x;
-        if (srcRect.height > static_cast<int>(source.m_size.y)) srcRect.height = source.m_size.y;
+        if (srcRect.width  > static_cast<int>(source.width))  srcRect.width  = source.width;
+        if (srcRect.height > static_cast<int>(source.height)) srcRect.height = source.height;
     }
 
     // Then find the valid bounds of the destination rectangle
@@ -190,31 +320,18 @@ void Image::copy(const Image& source, unsigned int destX, unsigned int destY, co
     // Precompute as much as possible
     int          pitch     = width * 4;
     int          rows      = height;
-    int          srcStride = source.m_size.x * 4;
+    int          srcStride = static_cast<int>(source.stride);
     int          dstStride = m_size.x * 4;
-    const Uint8* srcPixels = &source.m_pixels[0] + (srcRect.left + srcRect.top * source.m_size.x) * 4;
-    Uint8*       dstPixels = &m_pixels[0] + (destX + destY * m_size.x) * 4;
+    const Uint8* srcPixels = source.pixels + srcRect.left * 4 + srcRect.top * source.stride;
+    Uint8*       dstPixels = getPixelData() + (destX + destY * m_size.x) * 4;
 
     // Copy the pixels
     if (applyAlpha)
     {
-        // Interpolation using alpha values, pixel by pixel (slower)
+        // Interpolation using the alpha values of the source pixels, row by row
         for (int i = 0; i < rows; ++i)
         {
-            for (int j = 0; j < width; ++j)
-            {
-                // Get a direct pointer to the components of the current pixel
-                const Uint8* src = srcPixels + j * 4;
-                Uint8*       dst = dstPixels + j * 4;
-
-                // Interpolate RGBA components using the alpha value of the source pixel
-                Uint8 alpha = src[3];
-                dst[0] = (src[0] * alpha + dst[0] * (255 - alpha)) / 255;
-                dst[1] = (src[1] * alpha + dst[1] * (255 - alpha)) / 255;
-                dst[2] = (src[2] * alpha + dst[2] * (255 - alpha)) / 255;
-                dst[3] = alpha + dst[3] * (255 - alpha) / 255;
-            }
-
+            priv::blendPixels(dstPixels, srcPixels, width);
             srcPixels += srcStride;
             dstPixels += dstStride;
         }
@@ -235,7 +352,7 @@ void Image::copy(const Image& source, unsigned int destX, unsigned int destY, co
 ////////////////////////////////////////////////////////////
 void Image::setPixel(unsigned int x, unsigned int y, const Color& color)
 {
-    Uint8* pixel = &m_pixels[(x + y * m_size.x) * 4];
+    Uint8* pixel = getPixelData() + (x + y * m_size.x) * 4;
     *pixel++ = color.r;
     *pixel++ = color.g;
     *pixel++ = color.b;
@@ -246,7 +363,7 @@ void Image::setPixel(unsigned int x, unsigned int y, const Color& color)
 ////////////////////////////////////////////////////////////
 Color Image::getPixel(unsigned int x, unsigned int y) const
 {
-    const Uint8* pixel = &m_pixels[(x + y * m_size.x) * 4];
+    const Uint8* pixel = getPixelData() + (x + y * m_size.x) * 4;
     return Color(pixel[0], pixel[1], pixel[2], pixel[3]);
 }
 
@@ -254,9 +371,10 @@ Color Image::getPixel(unsigned int x, unsigned int y) const
 ////////////////////////////////////////////////////////////
 const Uint8* Image::getPixelsPtr() const
 {
-    if (!m_pixels.empty())
+    const Uint8* pixels = getPixelData();
+    if (pixels)
     {
-        return &m_pixels[0];
+        return pixels;
     }
     else
     {
@@ -269,24 +387,12 @@ const Uint8* Image::getPixelsPtr() const
 ////////////////////////////////////////////////////////////
 void Image::flipHorizontally()
 {
-    if (!m_pixels.empty())
+    Uint8* pixels = getPixelData();
+    if (pixels)
     {
-        std::vector<Uint8> before = m_pixels;
+        // Reverse each row in place
         for (unsigned int y = 0; y < m_size.y; ++y)
-        {
-            const Uint8* source = &before[y * m_size.x * 4];
-            Uint8* dest = &m_pixels[(y + 1) * m_size.x * 4 - 4];
-            for (unsigned int x = 0; x < m_size.x; ++x)
-            {
-                dest[0] = source[0];
-                dest[1] = source[1];
-                dest[2] = source[2];
-                dest[3] = source[3];
-
-                source += 4;
-                dest -= 4;
-            }
-        }
+            priv::reversePixels(pixels + y * m_size.x * 4, m_size.x);
     }
 }
 
@@ -294,20 +400,94 @@ void Image::flipHorizontally()
 ////////////////////////////////////////////////////////////
 void Image::flipVertically()
 {
-    if (!m_pixels.empty())
+    Uint8* pixels = getPixelData();
+    if (pixels)
     {
-        std::vector<Uint8> before = m_pixels;
-        const Uint8* source = &before[m_size.x * (m_size.y - 1) * 4];
-        Uint8* dest = &m_pixels[0];
+        // Swap the rows in place, from both ends
         std::size_t rowSize = m_size.x * 4;
+        Uint8* top = pixels;
+        Uint8* bottom = pixels + (m_size.y - 1) * rowSize;
 
-        for (unsigned int y = 0; y < m_size.y; ++y)
+        while (top < bottom)
         {
-            std::memcpy(dest, source, rowSize);
-            source -= rowSize;
-            dest += rowSize;
+            std::swap_ranges(top, top + rowSize, bottom);
+            top += rowSize;
+            bottom -= rowSize;
         }
     }
 }
 
+
+////////////////////////////////////////////////////////////
+void Image::premultiplyAlpha()
+{
+    Uint8* pixels = getPixelData();
+    if (pixels)
+        priv::premultiplyPixels(pixels, m_size.x * m_size.y);
+}
+
+
+////////////////////////////////////////////////////////////
+Image& Image::operator =(const Image& right)
+{
+    Image temp(right);
+
+    std::swap(m_size,        temp.m_size);
+    std::swap(m_adopted,     temp.m_adopted);
+    std::swap(m_deleter,     temp.m_deleter);
+    std::swap(m_deleterData, temp.m_deleterData);
+    std::swap(m_request,     temp.m_request);
+    m_pixels.swap(temp.m_pixels);
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint8* Image::getPixelData()
+{
+    if (m_adopted)
+        return m_adopted;
+    else
+        return m_pixels.empty() ? NULL : &m_pixels[0];
+}
+
+
+////////////////////////////////////////////////////////////
+const Uint8* Image::getPixelData() const
+{
+    if (m_adopted)
+        return m_adopted;
+    else
+        return m_pixels.empty() ? NULL : &m_pixels[0];
+}
+
+
+////////////////////////////////////////////////////////////
+void Image::releasePixels()
+{
+    if (m_adopted)
+    {
+        if (m_deleter)
+            m_deleter(m_adopted, m_deleterData);
+
+        m_adopted     = NULL;
+        m_deleter     = NULL;
+        m_deleterData = NULL;
+    }
+
+    m_pixels.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void Image::cancelLoad()
+{
+    if (m_request)
+    {
+        m_request->release();
+        m_request = NULL;
+    }
+}
+
 } // namespace sf
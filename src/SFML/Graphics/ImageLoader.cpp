@@ -26,9 +26,18 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/ImageLoader.hpp>
+#include <SFML/Graphics/ImageView.hpp>
 #include <SFML/System/InputStream.hpp>
 #include <SFML/System/Err.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <SFML/System/Thread.hpp>
+#include <SFML/System/ThreadLocalPtr.hpp>
+// stb_image reports its errors in a global variable, that the worker threads
+// would overwrite concurrently: redirect it to a variable of the calling thread
+#define failure_reason *getStbiFailureReason()
 #include <SFML/Graphics/stb_image/stb_image.h>
+#undef failure_reason
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <SFML/Graphics/stb_image/stb_image_write.h>
 extern "C"
@@ -36,7 +45,9 @@ extern "C"
     #include <jpeglib.h>
     #include <jerror.h>
 }
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 
 
 namespace
@@ -65,6 +76,37 @@ namespace
         sf::InputStream* stream = static_cast<sf::InputStream*>(user);
         return stream->tell() >= stream->getSize();
     }
+
+    // Get the pixels of a view as a tightly packed array, copying them only if the rows are padded
+    const sf::Uint8* getPackedPixels(const sf::ImageView& image, std::vector<sf::Uint8>& buffer)
+    {
+        std::size_t pitch = image.width * 4;
+        if (image.stride == pitch)
+            return image.pixels;
+
+        buffer.resize(pitch * image.height);
+        for (unsigned int y = 0; y < image.height; ++y)
+            std::memcpy(&buffer[y * pitch], image.pixels + y * image.stride, pitch);
+
+        return &buffer[0];
+    }
+
+    // Number of threads decoding asynchronous requests
+    const std::size_t workerCount = 4;
+
+    // Failure reason of stb_image for the threads that are not workers
+    const char* sharedFailureReason = NULL;
+
+    // Failure reason of stb_image for the current thread, if it is a worker
+    sf::ThreadLocalPtr<const char*> workerFailureReason(NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+static const char** getStbiFailureReason()
+{
+    const char** reason = workerFailureReason;
+    return reason ? reason : &sharedFailureReason;
 }
 
 
@@ -73,72 +115,180 @@ namespace sf
 namespace priv
 {
 ////////////////////////////////////////////////////////////
-ImageLoader& ImageLoader::getInstance()
+struct ImageLoader::Worker
 {
-    static ImageLoader Instance;
+    Worker(ImageLoader& owner) :
+    loader       (owner),
+    thread       (&Worker::run, this),
+    running      (false),
+    failureReason(NULL)
+    {
+    }
 
-    return Instance;
-}
+    void run()
+    {
+        workerFailureReason = &failureReason;
+        loader.processRequests(*this);
+    }
+
+    ImageLoader& loader;        ///< Loader owning the worker
+    Thread       thread;        ///< Thread running the worker
+    bool         running;       ///< Is the thread running? (protected by the loader's mutex)
+    const char*  failureReason; ///< Failure reason of stb_image in the thread of the worker
+};
 
 
 ////////////////////////////////////////////////////////////
-ImageLoader::ImageLoader()
+ImageLoadRequest::ImageLoadRequest(const std::string& filename) :
+m_filename  (filename),
+m_pixels    (NULL),
+m_size      (0, 0),
+m_references(2),
+m_done      (false)
 {
-    // Nothing to do
 }
 
 
 ////////////////////////////////////////////////////////////
-ImageLoader::~ImageLoader()
+ImageLoadRequest::~ImageLoadRequest()
 {
-    // Nothing to do
+    if (m_pixels)
+        ImageLoader::freePixels(m_pixels);
 }
 
 
 ////////////////////////////////////////////////////////////
-bool ImageLoader::loadImageFromFile(const std::string& filename, std::vector<Uint8>& pixels, Vector2u& size)
+void ImageLoadRequest::acquire()
 {
-    // Clear the array (just in case)
-    pixels.clear();
+    Lock lock(m_mutex);
+    m_references++;
+}
 
-    // Load the image and get a pointer to the pixels in memory
-    int width, height, channels;
-    unsigned char* ptr = stbi_load(filename.c_str(), &width, &height, &channels, STBI_rgb_alpha);
 
-    if (ptr && width && height)
+////////////////////////////////////////////////////////////
+void ImageLoadRequest::release()
+{
+    bool last;
     {
-        // Assign the image properties
-        size.x = width;
-        size.y = height;
+        Lock lock(m_mutex);
+        last = (--m_references == 0);
+    }
 
-        // Copy the loaded pixels to the pixel buffer
-        pixels.resize(width * height * 4);
-        memcpy(&pixels[0], ptr, pixels.size());
+    if (last)
+        delete this;
+}
 
-        // Free the loaded pixels (they are now in our own pixel buffer)
-        stbi_image_free(ptr);
 
-        return true;
-    }
-    else
+////////////////////////////////////////////////////////////
+bool ImageLoadRequest::isDone() const
+{
+    Lock lock(m_mutex);
+    return m_done;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint8* ImageLoadRequest::takePixels(Vector2u& size, bool& owned)
+{
+    Lock lock(m_mutex);
+
+    Uint8* pixels = m_pixels;
+    size = m_size;
+    owned = (m_references == 1);
+    if (owned)
+        m_pixels = NULL;
+
+    return pixels;
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageLoadRequest::complete(Uint8* pixels, const Vector2u& size, const std::string& failure)
+{
+    bool last;
     {
-        // Error, failed to load the image
-        err() << "Failed to load image \"" << filename << "\". Reason : " << stbi_failure_reason() << std::endl;
+        // Publish the result and drop the loader's reference in the same step,
+        // so that a waiter seeing the request done knows whether it is the only owner
+        Lock lock(m_mutex);
+        m_pixels  = pixels;
+        m_size    = size;
+        m_failure = failure;
+        m_done    = true;
+        last     = (--m_references == 0);
+    }
 
-        return false;
+    if (last)
+        delete this;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageLoadRequest::isWanted() const
+{
+    Lock lock(m_mutex);
+    return m_references > 1;
+}
+
+
+////////////////////////////////////////////////////////////
+ImageLoader& ImageLoader::getInstance()
+{
+    static ImageLoader Instance;
+
+    return Instance;
+}
+
+
+////////////////////////////////////////////////////////////
+ImageLoader::ImageLoader()
+{
+    // stb_image fills its fixed Huffman tables the first time it needs them;
+    // do it now, before the workers can decode concurrently
+    init_defaults();
+
+    for (std::size_t i = 0; i < workerCount; ++i)
+        m_workers.push_back(new Worker(*this));
+}
+
+
+////////////////////////////////////////////////////////////
+ImageLoader::~ImageLoader()
+{
+    // Drop the requests that no worker has started yet
+    std::deque<ImageLoadRequest*> pending;
+    {
+        Lock lock(m_mutex);
+        pending.swap(m_queue);
     }
+    for (std::deque<ImageLoadRequest*>::iterator it = pending.begin(); it != pending.end(); ++it)
+        (*it)->complete(NULL, Vector2u(0, 0), "");
+
+    // Wait for the workers to finish their current request (the Thread destructor waits)
+    for (std::vector<Worker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+        delete *it;
 }
 
 
 ////////////////////////////////////////////////////////////
-bool ImageLoader::loadImageFromMemory(const void* data, std::size_t dataSize, std::vector<Uint8>& pixels, Vector2u& size)
+bool ImageLoader::loadImageFromFile(const std::string& filename, Uint8*& pixels, Vector2u& size)
+{
+    std::string failure;
+    if (decodeFile(filename, pixels, size, failure))
+        return true;
+
+    // Error, failed to load the image
+    err() << "Failed to load image \"" << filename << "\". Reason : " << failure << std::endl;
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageLoader::loadImageFromMemory(const void* data, std::size_t dataSize, Uint8*& pixels, Vector2u& size)
 {
     // Check input parameters
     if (data && dataSize)
     {
-        // Clear the array (just in case)
-        pixels.clear();
-
         // Load the image and get a pointer to the pixels in memory
         int width, height, channels;
         const unsigned char* buffer = static_cast<const unsigned char*>(data);
@@ -150,12 +300,8 @@ bool ImageLoader::loadImageFromMemory(const void* data, std::size_t dataSize, st
             size.x = width;
             size.y = height;
 
-            // Copy the loaded pixels to the pixel buffer
-            pixels.resize(width * height * 4);
-            memcpy(&pixels[0], ptr, pixels.size());
-
-            // Free the loaded pixels (they are now in our own pixel buffer)
-            stbi_image_free(ptr);
+            // Give the loaded pixels to the caller, there's no need to copy them
+            pixels = ptr;
 
             return true;
         }
@@ -176,11 +322,8 @@ bool ImageLoader::loadImageFromMemory(const void* data, std::size_t dataSize, st
 
 
 ////////////////////////////////////////////////////////////
-bool ImageLoader::loadImageFromStream(InputStream& stream, std::vector<Uint8>& pixels, Vector2u& size)
+bool ImageLoader::loadImageFromStream(InputStream& stream, Uint8*& pixels, Vector2u& size)
 {
-    // Clear the array (just in case)
-    pixels.clear();
-
     // Make sure that the stream's reading position is at the beginning
     stream.seek(0);
 
@@ -200,12 +343,8 @@ bool ImageLoader::loadImageFromStream(InputStream& stream, std::vector<Uint8>& p
         size.x = width;
         size.y = height;
 
-        // Copy the loaded pixels to the pixel buffer
-        pixels.resize(width * height * 4);
-        memcpy(&pixels[0], ptr, pixels.size());
-
-        // Free the loaded pixels (they are now in our own pixel buffer)
-        stbi_image_free(ptr);
+        // Give the loaded pixels to the caller, there's no need to copy them
+        pixels = ptr;
 
         return true;
     }
@@ -220,10 +359,76 @@ bool ImageLoader::loadImageFromStream(InputStream& stream, std::vector<Uint8>& p
 
 
 ////////////////////////////////////////////////////////////
-bool ImageLoader::saveImageToFile(const std::string& filename, const std::vector<Uint8>& pixels, const Vector2u& size)
+ImageLoadRequest* ImageLoader::loadImageFromFileAsync(const std::string& filename)
+{
+    ImageLoadRequest* request = new ImageLoadRequest(filename);
+
+    Lock lock(m_mutex);
+    m_queue.push_back(request);
+
+    // Wake up an idle worker, if any (the running ones will
+    // pick the request anyway when they are done with their current one)
+    for (std::vector<Worker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+    {
+        Worker& worker = **it;
+        if (!worker.running)
+        {
+            worker.running = true;
+            worker.thread.launch();
+            break;
+        }
+    }
+
+    return request;
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageLoader::wait(ImageLoadRequest& request)
+{
+    // If the request is still in the queue, decoding it ourselves
+    // is faster than waiting for a worker to become available
+    bool queued = false;
+    {
+        Lock lock(m_mutex);
+        std::deque<ImageLoadRequest*>::iterator it = std::find(m_queue.begin(), m_queue.end(), &request);
+        if (it != m_queue.end())
+        {
+            m_queue.erase(it);
+            queued = true;
+        }
+    }
+
+    if (queued)
+    {
+        execute(request);
+    }
+    else
+    {
+        // A worker is decoding the request: wait for it to finish
+        while (!request.isDone())
+            sleep(milliseconds(1));
+    }
+
+    // The workers don't write to the error stream, the failure is reported by the waiting thread
+    // (the request is complete, so its failure reason doesn't change anymore)
+    if (!request.m_failure.empty())
+        err() << "Failed to load image \"" << request.m_filename << "\". Reason : " << request.m_failure << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageLoader::freePixels(Uint8* pixels)
+{
+    stbi_image_free(pixels);
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageLoader::saveImageToFile(const std::string& filename, const ImageView& image)
 {
     // Make sure the image is not empty
-    if (!pixels.empty() && (size.x > 0) && (size.y > 0))
+    if (!image.isEmpty())
     {
         // Deduce the image type from its extension
         if (filename.size() > 3)
@@ -234,25 +439,27 @@ bool ImageLoader::saveImageToFile(const std::string& filename, const std::vector
             if (toLower(extension) == "bmp")
             {
                 // BMP format
-                if (stbi_write_bmp(filename.c_str(), size.x, size.y, 4, &pixels[0]))
+                std::vector<Uint8> buffer;
+                if (stbi_write_bmp(filename.c_str(), image.width, image.height, 4, getPackedPixels(image, buffer)))
                     return true;
             }
             else if (toLower(extension) == "tga")
             {
                 // TGA format
-                if (stbi_write_tga(filename.c_str(), size.x, size.y, 4, &pixels[0]))
+                std::vector<Uint8> buffer;
+                if (stbi_write_tga(filename.c_str(), image.width, image.height, 4, getPackedPixels(image, buffer)))
                     return true;
             }
             else if(toLower(extension) == "png")
             {
                 // PNG format
-                if (stbi_write_png(filename.c_str(), size.x, size.y, 4, &pixels[0], 0))
+                if (stbi_write_png(filename.c_str(), image.width, image.height, 4, image.pixels, static_cast<int>(image.stride)))
                     return true;
             }
             else if (toLower(extension) == "jpg")
             {
                 // JPG format
-                if (writeJpg(filename, pixels, size.x, size.y))
+                if (writeJpg(filename, image))
                     return true;
             }
         }
@@ -264,7 +471,79 @@ bool ImageLoader::saveImageToFile(const std::string& filename, const std::vector
 
 
 ////////////////////////////////////////////////////////////
-bool ImageLoader::writeJpg(const std::string& filename, const std::vector<Uint8>& pixels, unsigned int width, unsigned int height)
+void ImageLoader::processRequests(Worker& worker)
+{
+    for (;;)
+    {
+        ImageLoadRequest* request;
+        {
+            Lock lock(m_mutex);
+
+            // The thread ends when there's nothing left to do, it will
+            // be launched again when new requests are queued
+            if (m_queue.empty())
+            {
+                worker.running = false;
+                return;
+            }
+
+            request = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        execute(*request);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageLoader::execute(ImageLoadRequest& request)
+{
+    Uint8*      pixels = NULL;
+    Vector2u    size(0, 0);
+    std::string failure;
+
+    // Don't bother decoding images that nobody waits for anymore
+    if (request.isWanted())
+    {
+        if (!decodeFile(request.m_filename, pixels, size, failure))
+            pixels = NULL;
+    }
+
+    request.complete(pixels, size, failure);
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageLoader::decodeFile(const std::string& filename, Uint8*& pixels, Vector2u& size, std::string& failure)
+{
+    // Load the image and get a pointer to the pixels in memory
+    int width, height, channels;
+    unsigned char* ptr = stbi_load(filename.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+
+    if (ptr && width && height)
+    {
+        // Assign the image properties
+        size.x = width;
+        size.y = height;
+
+        // Give the loaded pixels to the caller, there's no need to copy them
+        pixels = ptr;
+
+        return true;
+    }
+    else
+    {
+        const char* reason = stbi_failure_reason();
+        failure = (reason && *reason) ? reason : "unknown error";
+
+        return false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageLoader::writeJpg(const std::string& filename, const ImageView& image)
 {
     // Open the file to write in
     FILE* file = fopen(filename.c_str(), "wb");
@@ -278,21 +557,26 @@ bool ImageLoader::writeJpg(const std::string& filename, const std::vector<Uint8>
 
     // Initialize all the writing and compression infos
     jpeg_create_compress(&compressInfos);
-    compressInfos.image_width      = width;
-    compressInfos.image_height     = height;
+    compressInfos.image_width      = image.width;
+    compressInfos.image_height     = image.height;
     compressInfos.input_components = 3;
     compressInfos.in_color_space   = JCS_RGB;
     jpeg_stdio_dest(&compressInfos, file);
     jpeg_set_defaults(&compressInfos);
     jpeg_set_quality(&compressInfos, 90, TRUE);
 
-    // Get rid of the aplha channel
-    std::vector<Uint8> buffer(width * height * 3);
-    for (std::size_t i = 0; i < width * height; ++i)
+    // Get rid of the aplha channel (and of the padding between rows)
+    std::vector<Uint8> buffer(image.width * image.height * 3);
+    for (unsigned int y = 0; y < image.height; ++y)
     {
-        buffer[i * 3 + 0] = pixels[i * 4 + 0];
-        buffer[i * 3 + 1] = pixels[i * 4 + 1];
-        buffer[i * 3 + 2] = pixels[i * 4 + 2];
+        const Uint8* pixels = image.pixels + y * image.stride;
+        Uint8*       row    = &buffer[y * image.width * 3];
+        for (unsigned int x = 0; x < image.width; ++x)
+        {
+            row[x * 3 + 0] = pixels[x * 4 + 0];
+            row[x * 3 + 1] = pixels[x * 4 + 1];
+            row[x * 3 + 2] = pixels[x * 4 + 2];
+        }
     }
     Uint8* ptr = &buffer[0];
 
@@ -302,7 +586,7 @@ bool ImageLoader::writeJpg(const std::string& filename, const std::vector<Uint8>
     // Write each row of the image
     while (compressInfos.next_scanline < compressInfos.image_height)
     {
-        JSAMPROW rawPointer = ptr + (compressInfos.next_scanline * width * 3);
+        JSAMPROW rawPointer = ptr + (compressInfos.next_scanline * image.width * 3);
         jpeg_write_scanlines(&compressInfos, &rawPointer, 1);
     }
 
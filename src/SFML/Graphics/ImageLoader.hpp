@@ -30,16 +30,118 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <deque>
 #include <string>
 #include <vector>
 
 
 namespace sf
 {
+class ImageView;
 class InputStream;
 
 namespace priv
 {
+////////////////////////////////////////////////////////////
+/// \brief Image file decoded in the background by the image loader
+///
+/// Requests are reference counted: the image loader holds a
+/// reference until the decoding is finished, and every image
+/// waiting for the result holds another one.
+///
+////////////////////////////////////////////////////////////
+class ImageLoadRequest : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a reference to the request
+    ///
+    ////////////////////////////////////////////////////////////
+    void acquire();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a reference to the request
+    ///
+    /// The request is destroyed when its last reference is removed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void release();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the decoding is finished
+    ///
+    /// \return True if the request is complete (successfully or not)
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isDone() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the decoded pixels of a complete request
+    ///
+    /// If the caller holds the only reference to the request,
+    /// the ownership of the returned buffer is transferred to it,
+    /// and it must be released with ImageLoader::freePixels.
+    /// Otherwise the buffer stays owned by the request and
+    /// must be copied.
+    ///
+    /// \param size  Receives the size of the image, in pixels
+    /// \param owned Receives whether the caller now owns the buffer
+    ///
+    /// \return Decoded pixels, or NULL if the decoding failed
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint8* takePixels(Vector2u& size, bool& owned);
+
+private :
+
+    friend class ImageLoader;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct a request for a file, with two references
+    ///
+    /// \param filename Path of the image file to load
+    ///
+    ////////////////////////////////////////////////////////////
+    ImageLoadRequest(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~ImageLoadRequest();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Store the result of the decoding and drop the reference of the loader
+    ///
+    /// \param pixels  Decoded pixels (NULL if the decoding failed)
+    /// \param size    Size of the image, in pixels
+    /// \param failure Reason of the failure (empty if the image was decoded or not wanted)
+    ///
+    ////////////////////////////////////////////////////////////
+    void complete(Uint8* pixels, const Vector2u& size, const std::string& failure);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether someone is still waiting for the result
+    ///
+    /// \return True if a reference other than the loader's exists
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isWanted() const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    mutable Mutex m_mutex;      ///< Mutex protecting the state of the request
+    std::string   m_filename;   ///< Path of the image file to load
+    Uint8*        m_pixels;     ///< Decoded pixels, owned by the request until they are taken
+    Vector2u      m_size;       ///< Size of the decoded image
+    std::string   m_failure;    ///< Reason of the failure, reported by the thread waiting for the request
+    unsigned int  m_references; ///< Number of references to the request
+    bool          m_done;       ///< Is the decoding finished?
+};
+
 ////////////////////////////////////////////////////////////
 /// \brief Load/save image files
 ///
@@ -59,54 +161,98 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Load an image from a file on disk
     ///
+    /// On success, \a pixels receives the buffer allocated by
+    /// the decoder, which must be released with freePixels.
+    ///
     /// \param filename Path of image file to load
-    /// \param pixels   Array of pixels to fill with loaded image
+    /// \param pixels   Receives the array of pixels of the loaded image
     /// \param size     Size of loaded image, in pixels
     ///
     /// \return True if loading was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool loadImageFromFile(const std::string& filename, std::vector<Uint8>& pixels, Vector2u& size);
+    bool loadImageFromFile(const std::string& filename, Uint8*& pixels, Vector2u& size);
 
     ////////////////////////////////////////////////////////////
     /// \brief Load an image from a file in memory
     ///
+    /// On success, \a pixels receives the buffer allocated by
+    /// the decoder, which must be released with freePixels.
+    ///
     /// \param data     Pointer to the file data in memory
     /// \param dataSize Size of the data to load, in bytes
-    /// \param pixels   Array of pixels to fill with loaded image
+    /// \param pixels   Receives the array of pixels of the loaded image
     /// \param size     Size of loaded image, in pixels
     ///
     /// \return True if loading was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool loadImageFromMemory(const void* data, std::size_t dataSize, std::vector<Uint8>& pixels, Vector2u& size);
+    bool loadImageFromMemory(const void* data, std::size_t dataSize, Uint8*& pixels, Vector2u& size);
 
     ////////////////////////////////////////////////////////////
     /// \brief Load an image from a custom stream
     ///
+    /// On success, \a pixels receives the buffer allocated by
+    /// the decoder, which must be released with freePixels.
+    ///
     /// \param stream Source stream to read from
-    /// \param pixels Array of pixels to fill with loaded image
+    /// \param pixels Receives the array of pixels of the loaded image
     /// \param size   Size of loaded image, in pixels
     ///
     /// \return True if loading was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool loadImageFromStream(InputStream& stream, std::vector<Uint8>& pixels, Vector2u& size);
+    bool loadImageFromStream(InputStream& stream, Uint8*& pixels, Vector2u& size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start loading an image file in a worker thread
+    ///
+    /// The returned request holds one reference for the caller,
+    /// which must be removed with ImageLoadRequest::release.
+    ///
+    /// \param filename Path of image file to load
+    ///
+    /// \return Request to poll or wait for
+    ///
+    ////////////////////////////////////////////////////////////
+    ImageLoadRequest* loadImageFromFileAsync(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until a request is complete
+    ///
+    /// If no worker has picked the request yet, it is removed
+    /// from the queue and decoded in the calling thread.
+    /// If the decoding failed, the reason is written to the
+    /// error stream by this function.
+    ///
+    /// \param request Request to wait for
+    ///
+    ////////////////////////////////////////////////////////////
+    void wait(ImageLoadRequest& request);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release a buffer of pixels allocated by the decoder
+    ///
+    /// \param pixels Buffer to release
+    ///
+    ////////////////////////////////////////////////////////////
+    static void freePixels(Uint8* pixels);
 
     ////////////////////////////////////////////////////////////
     /// \bref Save an array of pixels as an image file
     ///
     /// \param filename Path of image file to save
-    /// \param pixels   Array of pixels to save to image
-    /// \param size     Size of image to save, in pixels
+    /// \param image    View of the pixels to save to image
     ///
     /// \return True if saving was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool saveImageToFile(const std::string& filename, const std::vector<Uint8>& pixels, const Vector2u& size);
+    bool saveImageToFile(const std::string& filename, const ImageView& image);
 
 private :
 
+    struct Worker;
+
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
@@ -119,18 +265,56 @@ private :
     ////////////////////////////////////////////////////////////
     ~ImageLoader();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Entry point of the worker threads
+    ///
+    /// Decodes queued requests until the queue is empty.
+    ///
+    /// \param worker Worker running the function
+    ///
+    ////////////////////////////////////////////////////////////
+    void processRequests(Worker& worker);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode the file of a request and complete it
+    ///
+    /// \param request Request to execute
+    ///
+    ////////////////////////////////////////////////////////////
+    void execute(ImageLoadRequest& request);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode an image file without writing to the error stream
+    ///
+    /// This function can be called by several threads at the same time.
+    ///
+    /// \param filename Path of image file to load
+    /// \param pixels   Receives the array of pixels of the loaded image
+    /// \param size     Size of loaded image, in pixels
+    /// \param failure  Receives the reason of the failure, if any
+    ///
+    /// \return True if decoding was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool decodeFile(const std::string& filename, Uint8*& pixels, Vector2u& size, std::string& failure);
+
     ////////////////////////////////////////////////////////////
     /// \brief Save an image file in JPEG format
     ///
     /// \param filename Path of image file to save
-    /// \param pixels   Array of pixels to save to image
-    /// \param width    Width of image to save, in pixels
-    /// \param height   Height of image to save, in pixels
+    /// \param image    View of the pixels to save to image
     ///
     /// \return True if saving was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool writeJpg(const std::string& filename, const std::vector<Uint8>& pixels, unsigned int width, unsigned int height);
+    bool writeJpg(const std::string& filename, const ImageView& image);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Mutex                         m_mutex;   ///< Mutex protecting the queue and the workers state
+    std::deque<ImageLoadRequest*> m_queue;   ///< Requests waiting for a worker
+    std::vector<Worker*>          m_workers; ///< Pool of worker threads
 };
 
 } // namespace priv
@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/ImageView.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/ImageLoader.hpp>
+#include <algorithm>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+ImageView::ImageView() :
+pixels(NULL),
+width (0),
+height(0),
+stride(0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+ImageView::ImageView(const Uint8* viewPixels, unsigned int viewWidth, unsigned int viewHeight, std::size_t viewStride) :
+pixels(viewPixels),
+width (viewWidth),
+height(viewHeight),
+stride(viewStride ? viewStride : viewWidth * 4)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+ImageView::ImageView(const Image& image) :
+pixels(image.getSize().x ? image.getPixelsPtr() : NULL),
+width (image.getSize().x),
+height(image.getSize().y),
+stride(image.getSize().x * 4)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+ImageView ImageView::getSubView(const IntRect& area) const
+{
+    // Clamp the area to the bounds of the view
+    int left   = std::max(area.left, 0);
+    int top    = std::max(area.top, 0);
+    int right  = std::min(area.left + area.width, static_cast<int>(width));
+    int bottom = std::min(area.top + area.height, static_cast<int>(height));
+
+    if (!pixels || (left >= right) || (top >= bottom))
+        return ImageView();
+
+    return ImageView(pixels + top * stride + left * 4, right - left, bottom - top, stride);
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageView::isEmpty() const
+{
+    return !pixels || (width == 0) || (height == 0);
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageView::saveToFile(const std::string& filename) const
+{
+    return priv::ImageLoader::getInstance().saveImageToFile(filename, *this);
+}
+
+} // namespace sf
@@ -0,0 +1,290 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/InstancedSprite.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/UniformBlock.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    // Pack an instance: keep the 2D affine part of the transform, as two rows
+    void packInstance(const sf::Transform& transform, const sf::IntRect& textureRect, const sf::Color& color,
+                      float* transformRows, float* rect, sf::Uint8* rgba)
+    {
+        const float* matrix = transform.getMatrix();
+        transformRows[0] = matrix[0];
+        transformRows[1] = matrix[4];
+        transformRows[2] = matrix[12];
+        transformRows[3] = matrix[1];
+        transformRows[4] = matrix[5];
+        transformRows[5] = matrix[13];
+
+        rect[0] = static_cast<float>(textureRect.left);
+        rect[1] = static_cast<float>(textureRect.top);
+        rect[2] = static_cast<float>(textureRect.width);
+        rect[3] = static_cast<float>(textureRect.height);
+
+        rgba[0] = color.r;
+        rgba[1] = color.g;
+        rgba[2] = color.b;
+        rgba[3] = color.a;
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+InstancedSprite::InstancedSprite() :
+m_texture       (NULL),
+m_instances     (),
+m_buffer        (0),
+m_bufferCapacity(0),
+m_dirtyBegin    (0),
+m_dirtyEnd      (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+InstancedSprite::InstancedSprite(const Texture& texture) :
+m_texture       (&texture),
+m_instances     (),
+m_buffer        (0),
+m_bufferCapacity(0),
+m_dirtyBegin    (0),
+m_dirtyEnd      (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+InstancedSprite::InstancedSprite(const InstancedSprite& copy) :
+Drawable        (copy),
+Transformable   (copy),
+GlResource      (),
+m_texture       (copy.m_texture),
+m_instances     (copy.m_instances),
+m_buffer        (0),
+m_bufferCapacity(0),
+m_dirtyBegin    (0),
+m_dirtyEnd      (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+InstancedSprite::~InstancedSprite()
+{
+    if (m_buffer)
+    {
+        ensureGlContext();
+
+        GLuint buffer = static_cast<GLuint>(m_buffer);
+        glCheck(glDeleteBuffersARB(1, &buffer));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::setTexture(const Texture& texture)
+{
+    m_texture = &texture;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture* InstancedSprite::getTexture() const
+{
+    return m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t InstancedSprite::append(const Transform& transform, const IntRect& textureRect, const Color& color)
+{
+    Instance instance;
+    packInstance(transform, textureRect, color, instance.transform, instance.textureRect, instance.color);
+    m_instances.push_back(instance);
+
+    std::size_t index = m_instances.size() - 1;
+    invalidate(index, index + 1);
+
+    return index;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::setInstance(std::size_t index, const Transform& transform, const IntRect& textureRect, const Color& color)
+{
+    if (index >= m_instances.size())
+        return;
+
+    Instance& instance = m_instances[index];
+    packInstance(transform, textureRect, color, instance.transform, instance.textureRect, instance.color);
+    invalidate(index, index + 1);
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::resize(std::size_t instanceCount)
+{
+    std::size_t previousCount = m_instances.size();
+
+    Instance empty;
+    packInstance(Transform::Identity, IntRect(), Color::White, empty.transform, empty.textureRect, empty.color);
+    m_instances.resize(instanceCount, empty);
+
+    if (instanceCount > previousCount)
+        invalidate(previousCount, instanceCount);
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::clear()
+{
+    m_instances.clear();
+    m_dirtyBegin = 0;
+    m_dirtyEnd   = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t InstancedSprite::getInstanceCount() const
+{
+    return m_instances.size();
+}
+
+
+////////////////////////////////////////////////////////////
+InstancedSprite& InstancedSprite::operator =(const InstancedSprite& right)
+{
+    Transformable::operator =(right);
+
+    // Keep our own buffer, and send all the new instances to it at next draw
+    m_texture   = right.m_texture;
+    m_instances = right.m_instances;
+    m_dirtyBegin = 0;
+    m_dirtyEnd   = m_instances.size();
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+bool InstancedSprite::isAvailable()
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    return Shader::isAvailable()          &&
+           UniformBlock::isAvailable()    &&
+           GLEW_ARB_vertex_buffer_object  &&
+           GLEW_ARB_instanced_arrays      &&
+           GLEW_ARB_draw_instanced;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::draw(RenderTarget& target, RenderStates states) const
+{
+    if (!m_instances.empty())
+    {
+        states.transform *= getTransform();
+        states.texture = m_texture;
+        target.drawInstanced(*this, states);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::invalidate(std::size_t begin, std::size_t end)
+{
+    if (m_dirtyBegin == m_dirtyEnd)
+    {
+        m_dirtyBegin = begin;
+        m_dirtyEnd   = end;
+    }
+    else
+    {
+        m_dirtyBegin = std::min(m_dirtyBegin, begin);
+        m_dirtyEnd   = std::max(m_dirtyEnd, end);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int InstancedSprite::update() const
+{
+    if (m_instances.empty())
+        return m_buffer;
+
+    ensureGlContext();
+
+    // Create the OpenGL buffer if it doesn't exist yet
+    if (!m_buffer)
+    {
+        GLuint buffer;
+        glCheck(glGenBuffersARB(1, &buffer));
+        m_buffer = static_cast<unsigned int>(buffer);
+    }
+
+    glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffer));
+
+    if (m_instances.size() > m_bufferCapacity)
+    {
+        // The storage is too small: reallocate it with the capacity of the instance
+        // array, so that it grows as rarely as the array, and send all the instances
+        m_bufferCapacity = m_instances.capacity();
+        glCheck(glBufferDataARB(GL_ARRAY_BUFFER_ARB, m_bufferCapacity * sizeof(Instance), NULL, GL_STREAM_DRAW_ARB));
+        glCheck(glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, 0, m_instances.size() * sizeof(Instance), &m_instances[0]));
+    }
+    else
+    {
+        // Only send the instances that changed since the last upload
+        std::size_t end = std::min(m_dirtyEnd, m_instances.size());
+        if (m_dirtyBegin < end)
+            glCheck(glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, m_dirtyBegin * sizeof(Instance),
+                                       (end - m_dirtyBegin) * sizeof(Instance), &m_instances[m_dirtyBegin]));
+    }
+
+    glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0));
+
+    m_dirtyBegin = 0;
+    m_dirtyEnd   = 0;
+
+    return m_buffer;
+}
+
+} // namespace sf
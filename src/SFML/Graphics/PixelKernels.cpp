@@ -0,0 +1,830 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/PixelKernels.hpp>
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+    #define SFML_KERNELS_X86
+    #include <emmintrin.h>
+
+    // Compilers which allow AVX2 intrinsics in functions compiled for
+    // AVX2, without enabling AVX2 for the whole translation unit
+    #if defined(_MSC_VER) && (_MSC_VER >= 1700)
+        #define SFML_KERNELS_AVX2
+    #elif defined(__clang__)
+        #if (__clang_major__ > 3) || ((__clang_major__ == 3) && (__clang_minor__ >= 8))
+            #define SFML_KERNELS_AVX2
+        #endif
+    #elif defined(__GNUC__)
+        #if (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))
+            #define SFML_KERNELS_AVX2
+        #endif
+    #endif
+
+    #ifdef SFML_KERNELS_AVX2
+        #include <immintrin.h>
+    #endif
+
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define SFML_KERNELS_TARGET(isa)
+    #else
+        #include <cpuid.h>
+        #define SFML_KERNELS_TARGET(isa) __attribute__((target(isa)))
+    #endif
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+    #define SFML_KERNELS_NEON
+    #include <arm_neon.h>
+
+#endif
+
+
+namespace
+{
+    // Convert a color to a pixel, as it is stored in memory
+    sf::Uint32 toPixel(const sf::Color& color)
+    {
+        sf::Uint8 components[4] = {color.r, color.g, color.b, color.a};
+        sf::Uint32 pixel;
+        std::memcpy(&pixel, components, sizeof(pixel));
+        return pixel;
+    }
+
+    // Divide by 255, without a division; the result is exact for any x < 65535
+    inline unsigned int div255(unsigned int x)
+    {
+        return (x + 1 + (x >> 8)) >> 8;
+    }
+
+
+    ////////////////////////////////////////////////////////////
+    // Portable implementations
+    ////////////////////////////////////////////////////////////
+    void fillScalar(sf::Uint8* pixels, std::size_t count, sf::Uint32 color)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            std::memcpy(pixels + i * 4, &color, 4);
+    }
+
+    void maskScalar(sf::Uint8* pixels, std::size_t count, sf::Uint32 key, sf::Uint32 masked)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            sf::Uint32 pixel;
+            std::memcpy(&pixel, pixels + i * 4, 4);
+            if (pixel == key)
+                std::memcpy(pixels + i * 4, &masked, 4);
+        }
+    }
+
+    void blendScalar(sf::Uint8* destination, const sf::Uint8* source, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const sf::Uint8* src = source + i * 4;
+            sf::Uint8*       dst = destination + i * 4;
+
+            unsigned int alpha   = src[3];
+            unsigned int inverse = 255 - alpha;
+            dst[0] = static_cast<sf::Uint8>(div255(src[0] * alpha + dst[0] * inverse));
+            dst[1] = static_cast<sf::Uint8>(div255(src[1] * alpha + dst[1] * inverse));
+            dst[2] = static_cast<sf::Uint8>(div255(src[2] * alpha + dst[2] * inverse));
+            dst[3] = static_cast<sf::Uint8>(alpha + div255(dst[3] * inverse));
+        }
+    }
+
+    void reverseScalar(sf::Uint8* pixels, std::size_t count)
+    {
+        if (count < 2)
+            return;
+
+        sf::Uint8* left  = pixels;
+        sf::Uint8* right = pixels + (count - 1) * 4;
+        while (left < right)
+        {
+            std::swap_ranges(left, left + 4, right);
+            left  += 4;
+            right -= 4;
+        }
+    }
+
+    void premultiplyScalar(sf::Uint8* pixels, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            sf::Uint8*   pixel = pixels + i * 4;
+            unsigned int alpha = pixel[3];
+            for (int j = 0; j < 3; ++j)
+            {
+                // Rounded division by 255
+                unsigned int x = pixel[j] * alpha + 128;
+                pixel[j] = static_cast<sf::Uint8>((x + (x >> 8)) >> 8);
+            }
+        }
+    }
+
+    void downsampleScalar(sf::Uint8* destination, const sf::Uint8* row0, const sf::Uint8* row1, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count * 4; ++i)
+        {
+            // Same component of the next pixel is 4 bytes further
+            std::size_t j = (i / 4) * 8 + i % 4;
+            unsigned int sum = row0[j] + row0[j + 4] + row1[j] + row1[j + 4];
+            destination[i] = static_cast<sf::Uint8>((sum + 2) >> 2);
+        }
+    }
+
+
+#if defined(SFML_KERNELS_X86)
+
+    ////////////////////////////////////////////////////////////
+    // SSE2 implementations (4 pixels at once)
+    ////////////////////////////////////////////////////////////
+    SFML_KERNELS_TARGET("sse2")
+    inline __m128i div255Sse2(__m128i x)
+    {
+        return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+    }
+
+    // Get the multiplier of the components of 2 unpacked pixels: their alpha
+    // for the color components, 255 for the alpha component itself
+    SFML_KERNELS_TARGET("sse2")
+    inline __m128i alphaFactorSse2(__m128i pixels)
+    {
+        const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        return _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), _mm_and_si128(alphaLanes, _mm_set1_epi16(255)));
+    }
+
+    // Blend 2 unpacked pixels; the alpha is computed as (src.a * 255 + dst.a * (255 - src.a)) / 255,
+    // which is exactly src.a + dst.a * (255 - src.a) / 255
+    SFML_KERNELS_TARGET("sse2")
+    inline __m128i blendSse2(__m128i src, __m128i dst)
+    {
+        __m128i alpha   = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+        return div255Sse2(_mm_add_epi16(_mm_mullo_epi16(src, alphaFactorSse2(src)), _mm_mullo_epi16(dst, inverse)));
+    }
+
+    // Premultiply 2 unpacked pixels
+    SFML_KERNELS_TARGET("sse2")
+    inline __m128i premultiplySse2(__m128i pixels)
+    {
+        __m128i x = _mm_add_epi16(_mm_mullo_epi16(pixels, alphaFactorSse2(pixels)), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+    }
+
+    SFML_KERNELS_TARGET("sse2")
+    void fillSse2(sf::Uint8* pixels, std::size_t count, sf::Uint32 color)
+    {
+        __m128i value = _mm_set1_epi32(static_cast<int>(color));
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i * 4), value);
+
+        fillScalar(pixels + i * 4, count - i, color);
+    }
+
+    SFML_KERNELS_TARGET("sse2")
+    void maskSse2(sf::Uint8* pixels, std::size_t count, sf::Uint32 key, sf::Uint32 masked)
+    {
+        __m128i keys   = _mm_set1_epi32(static_cast<int>(key));
+        __m128i values = _mm_set1_epi32(static_cast<int>(masked));
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i* block = reinterpret_cast<__m128i*>(pixels + i * 4);
+            __m128i  input = _mm_loadu_si128(block);
+            __m128i  match = _mm_cmpeq_epi32(input, keys);
+            _mm_storeu_si128(block, _mm_or_si128(_mm_and_si128(match, values), _mm_andnot_si128(match, input)));
+        }
+
+        maskScalar(pixels + i * 4, count - i, key, masked);
+    }
+
+    SFML_KERNELS_TARGET("sse2")
+    void blendSse2(sf::Uint8* destination, const sf::Uint8* source, std::size_t count)
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i* block = reinterpret_cast<__m128i*>(destination + i * 4);
+            __m128i  src   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+            __m128i  dst   = _mm_loadu_si128(block);
+
+            __m128i low  = blendSse2(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(dst, zero));
+            __m128i high = blendSse2(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(dst, zero));
+            _mm_storeu_si128(block, _mm_packus_epi16(low, high));
+        }
+
+        blendScalar(destination + i * 4, source + i * 4, count - i);
+    }
+
+    SFML_KERNELS_TARGET("sse2")
+    void reverseSse2(sf::Uint8* pixels, std::size_t count)
+    {
+        // Swap blocks of 4 pixels from both ends, reversing them on the way
+        sf::Uint8* left  = pixels;
+        sf::Uint8* right = pixels + count * 4;
+        while (right - left >= 32)
+        {
+            right -= 16;
+            __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left));
+            __m128i last  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(left),  _mm_shuffle_epi32(last,  _MM_SHUFFLE(0, 1, 2, 3)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(right), _mm_shuffle_epi32(first, _MM_SHUFFLE(0, 1, 2, 3)));
+            left += 16;
+        }
+
+        reverseScalar(left, (right - left) / 4);
+    }
+
+    SFML_KERNELS_TARGET("sse2")
+    void premultiplySse2(sf::Uint8* pixels, std::size_t count)
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i* block = reinterpret_cast<__m128i*>(pixels + i * 4);
+            __m128i  input = _mm_loadu_si128(block);
+
+            __m128i low  = premultiplySse2(_mm_unpacklo_epi8(input, zero));
+            __m128i high = premultiplySse2(_mm_unpackhi_epi8(input, zero));
+            _mm_storeu_si128(block, _mm_packus_epi16(low, high));
+        }
+
+        premultiplyScalar(pixels + i * 4, count - i);
+    }
+
+    SFML_KERNELS_TARGET("sse2")
+    inline __m128i downsampleSse2(__m128i row0, __m128i row1)
+    {
+        // Sum the rows, then the neighbour pixels: 2 pixels of 16-bits components
+        const __m128i zero = _mm_setzero_si128();
+        __m128i low  = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero), _mm_unpacklo_epi8(row1, zero));
+        __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero), _mm_unpackhi_epi8(row1, zero));
+        __m128i sum  = _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+        return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+    }
+
+    SFML_KERNELS_TARGET("sse2")
+    void downsampleSse2(sf::Uint8* destination, const sf::Uint8* row0, const sf::Uint8* row1, std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i* first  = reinterpret_cast<const __m128i*>(row0 + i * 8);
+            const __m128i* second = reinterpret_cast<const __m128i*>(row1 + i * 8);
+
+            __m128i low  = downsampleSse2(_mm_loadu_si128(first),     _mm_loadu_si128(second));
+            __m128i high = downsampleSse2(_mm_loadu_si128(first + 1), _mm_loadu_si128(second + 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), _mm_packus_epi16(low, high));
+        }
+
+        downsampleScalar(destination + i * 4, row0 + i * 8, row1 + i * 8, count - i);
+    }
+
+#ifdef SFML_KERNELS_AVX2
+
+    ////////////////////////////////////////////////////////////
+    // AVX2 implementations (8 pixels at once); unpacking and
+    // packing operate on each 128-bits lane separately, so the
+    // pixels stay in order
+    ////////////////////////////////////////////////////////////
+    SFML_KERNELS_TARGET("avx2")
+    inline __m256i div255Avx2(__m256i x)
+    {
+        return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8)), 8);
+    }
+
+    SFML_KERNELS_TARGET("avx2")
+    inline __m256i alphaFactorAvx2(__m256i pixels)
+    {
+        const __m256i alphaLanes = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+
+        __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        return _mm256_or_si256(_mm256_andnot_si256(alphaLanes, alpha), _mm256_and_si256(alphaLanes, _mm256_set1_epi16(255)));
+    }
+
+    SFML_KERNELS_TARGET("avx2")
+    inline __m256i blendAvx2(__m256i src, __m256i dst)
+    {
+        __m256i alpha   = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m256i inverse = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+        return div255Avx2(_mm256_add_epi16(_mm256_mullo_epi16(src, alphaFactorAvx2(src)), _mm256_mullo_epi16(dst, inverse)));
+    }
+
+    SFML_KERNELS_TARGET("avx2")
+    inline __m256i premultiplyAvx2(__m256i pixels)
+    {
+        __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(pixels, alphaFactorAvx2(pixels)), _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+    }
+
+    SFML_KERNELS_TARGET("avx2")
+    void fillAvx2(sf::Uint8* pixels, std::size_t count, sf::Uint32 color)
+    {
+        __m256i value = _mm256_set1_epi32(static_cast<int>(color));
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i * 4), value);
+
+        fillSse2(pixels + i * 4, count - i, color);
+    }
+
+    SFML_KERNELS_TARGET("avx2")
+    void maskAvx2(sf::Uint8* pixels, std::size_t count, sf::Uint32 key, sf::Uint32 masked)
+    {
+        __m256i keys   = _mm256_set1_epi32(static_cast<int>(key));
+        __m256i values = _mm256_set1_epi32(static_cast<int>(masked));
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i* block = reinterpret_cast<__m256i*>(pixels + i * 4);
+            __m256i  input = _mm256_loadu_si256(block);
+            __m256i  match = _mm256_cmpeq_epi32(input, keys);
+            _mm256_storeu_si256(block, _mm256_blendv_epi8(input, values, match));
+        }
+
+        maskSse2(pixels + i * 4, count - i, key, masked);
+    }
+
+    SFML_KERNELS_TARGET("avx2")
+    void blendAvx2(sf::Uint8* destination, const sf::Uint8* source, std::size_t count)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i* block = reinterpret_cast<__m256i*>(destination + i * 4);
+            __m256i  src   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4));
+            __m256i  dst   = _mm256_loadu_si256(block);
+
+            __m256i low  = blendAvx2(_mm256_unpacklo_epi8(src, zero), _mm256_unpacklo_epi8(dst, zero));
+            __m256i high = blendAvx2(_mm256_unpackhi_epi8(src, zero), _mm256_unpackhi_epi8(dst, zero));
+            _mm256_storeu_si256(block, _mm256_packus_epi16(low, high));
+        }
+
+        blendSse2(destination + i * 4, source + i * 4, count - i);
+    }
+
+    SFML_KERNELS_TARGET("avx2")
+    void reverseAvx2(sf::Uint8* pixels, std::size_t count)
+    {
+        const __m256i reversed = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        sf::Uint8* left  = pixels;
+        sf::Uint8* right = pixels + count * 4;
+        while (right - left >= 64)
+        {
+            right -= 32;
+            __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left));
+            __m256i last  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(left),  _mm256_permutevar8x32_epi32(last,  reversed));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(right), _mm256_permutevar8x32_epi32(first, reversed));
+            left += 32;
+        }
+
+        reverseSse2(left, (right - left) / 4);
+    }
+
+    SFML_KERNELS_TARGET("avx2")
+    void premultiplyAvx2(sf::Uint8* pixels, std::size_t count)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i* block = reinterpret_cast<__m256i*>(pixels + i * 4);
+            __m256i  input = _mm256_loadu_si256(block);
+
+            __m256i low  = premultiplyAvx2(_mm256_unpacklo_epi8(input, zero));
+            __m256i high = premultiplyAvx2(_mm256_unpackhi_epi8(input, zero));
+            _mm256_storeu_si256(block, _mm256_packus_epi16(low, high));
+        }
+
+        premultiplySse2(pixels + i * 4, count - i);
+    }
+
+    SFML_KERNELS_TARGET("avx2")
+    inline __m256i downsampleAvx2(__m256i row0, __m256i row1)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i low  = _mm256_add_epi16(_mm256_unpacklo_epi8(row0, zero), _mm256_unpacklo_epi8(row1, zero));
+        __m256i high = _mm256_add_epi16(_mm256_unpackhi_epi8(row0, zero), _mm256_unpackhi_epi8(row1, zero));
+        __m256i sum  = _mm256_add_epi16(_mm256_unpacklo_epi64(low, high), _mm256_unpackhi_epi64(low, high));
+        return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(2)), 2);
+    }
+
+    SFML_KERNELS_TARGET("avx2")
+    void downsampleAvx2(sf::Uint8* destination, const sf::Uint8* row0, const sf::Uint8* row1, std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i* first  = reinterpret_cast<const __m256i*>(row0 + i * 8);
+            const __m256i* second = reinterpret_cast<const __m256i*>(row1 + i * 8);
+
+            // Each lane holds 4 of the 8 pixels, which are put back in order after packing
+            __m256i low    = downsampleAvx2(_mm256_loadu_si256(first),     _mm256_loadu_si256(second));
+            __m256i high   = downsampleAvx2(_mm256_loadu_si256(first + 1), _mm256_loadu_si256(second + 1));
+            __m256i packed = _mm256_packus_epi16(low, high);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 4), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+
+        downsampleSse2(destination + i * 4, row0 + i * 8, row1 + i * 8, count - i);
+    }
+
+#endif // SFML_KERNELS_AVX2
+
+    ////////////////////////////////////////////////////////////
+    // Detection of the instruction sets supported by the CPU
+    ////////////////////////////////////////////////////////////
+    void cpuid(unsigned int function, unsigned int registers[4])
+    {
+    #if defined(_MSC_VER)
+        int info[4];
+        __cpuidex(info, static_cast<int>(function), 0);
+        for (int i = 0; i < 4; ++i)
+            registers[i] = static_cast<unsigned int>(info[i]);
+    #else
+        __cpuid_count(function, 0, registers[0], registers[1], registers[2], registers[3]);
+    #endif
+    }
+
+    bool hasSse2()
+    {
+    #if defined(_M_X64) || defined(__x86_64__)
+        // SSE2 is part of the x86-64 baseline
+        return true;
+    #else
+        unsigned int registers[4];
+        cpuid(1, registers);
+        return (registers[3] & (1 << 26)) != 0;
+    #endif
+    }
+
+#ifdef SFML_KERNELS_AVX2
+    bool hasAvx2()
+    {
+        unsigned int registers[4];
+        cpuid(0, registers);
+        if (registers[0] < 7)
+            return false;
+
+        // The CPU must support AVX, and the OS must save the AVX registers (OSXSAVE + XCR0)
+        cpuid(1, registers);
+        if (!(registers[2] & (1 << 27)) || !(registers[2] & (1 << 28)))
+            return false;
+
+    #if defined(_MSC_VER)
+        unsigned int xcr0 = static_cast<unsigned int>(_xgetbv(0));
+    #else
+        unsigned int xcr0, edx;
+        __asm__ __volatile__("xgetbv" : "=a"(xcr0), "=d"(edx) : "c"(0));
+    #endif
+        if ((xcr0 & 6) != 6)
+            return false;
+
+        cpuid(7, registers);
+        return (registers[1] & (1 << 5)) != 0;
+    }
+#endif
+
+#elif defined(SFML_KERNELS_NEON)
+
+    ////////////////////////////////////////////////////////////
+    // NEON implementations (4 or 16 pixels at once); the blending
+    // functions deinterleave the components with vld4
+    ////////////////////////////////////////////////////////////
+    inline uint8x8_t div255Neon(uint16x8_t x)
+    {
+        return vshrn_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+    }
+
+    inline uint8x16_t blendComponentNeon(uint8x16_t src, uint8x16_t dst, uint8x16_t alpha, uint8x16_t inverse)
+    {
+        uint16x8_t low  = vmlal_u8(vmull_u8(vget_low_u8(src),  vget_low_u8(alpha)),  vget_low_u8(dst),  vget_low_u8(inverse));
+        uint16x8_t high = vmlal_u8(vmull_u8(vget_high_u8(src), vget_high_u8(alpha)), vget_high_u8(dst), vget_high_u8(inverse));
+        return vcombine_u8(div255Neon(low), div255Neon(high));
+    }
+
+    inline uint8x8_t premultiplyComponentNeon(uint8x8_t component, uint8x8_t alpha)
+    {
+        uint16x8_t x = vaddq_u16(vmull_u8(component, alpha), vdupq_n_u16(128));
+        return vshrn_n_u16(vaddq_u16(x, vshrq_n_u16(x, 8)), 8);
+    }
+
+    void fillNeon(sf::Uint8* pixels, std::size_t count, sf::Uint32 color)
+    {
+        uint8x16_t value = vreinterpretq_u8_u32(vdupq_n_u32(color));
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            vst1q_u8(pixels + i * 4, value);
+
+        fillScalar(pixels + i * 4, count - i, color);
+    }
+
+    void maskNeon(sf::Uint8* pixels, std::size_t count, sf::Uint32 key, sf::Uint32 masked)
+    {
+        uint32x4_t keys   = vdupq_n_u32(key);
+        uint32x4_t values = vdupq_n_u32(masked);
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32x4_t input = vreinterpretq_u32_u8(vld1q_u8(pixels + i * 4));
+            uint32x4_t match = vceqq_u32(input, keys);
+            vst1q_u8(pixels + i * 4, vreinterpretq_u8_u32(vbslq_u32(match, values, input)));
+        }
+
+        maskScalar(pixels + i * 4, count - i, key, masked);
+    }
+
+    void blendNeon(sf::Uint8* destination, const sf::Uint8* source, std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x4_t src = vld4q_u8(source + i * 4);
+            uint8x16x4_t dst = vld4q_u8(destination + i * 4);
+
+            uint8x16_t alpha   = src.val[3];
+            uint8x16_t inverse = vmvnq_u8(alpha); // 255 - alpha
+
+            uint8x16x4_t result;
+            result.val[0] = blendComponentNeon(src.val[0], dst.val[0], alpha, inverse);
+            result.val[1] = blendComponentNeon(src.val[1], dst.val[1], alpha, inverse);
+            result.val[2] = blendComponentNeon(src.val[2], dst.val[2], alpha, inverse);
+            result.val[3] = vaddq_u8(alpha, vcombine_u8(div255Neon(vmull_u8(vget_low_u8(dst.val[3]),  vget_low_u8(inverse))),
+                                                        div255Neon(vmull_u8(vget_high_u8(dst.val[3]), vget_high_u8(inverse)))));
+            vst4q_u8(destination + i * 4, result);
+        }
+
+        blendScalar(destination + i * 4, source + i * 4, count - i);
+    }
+
+    void reverseNeon(sf::Uint8* pixels, std::size_t count)
+    {
+        sf::Uint8* left  = pixels;
+        sf::Uint8* right = pixels + count * 4;
+        while (right - left >= 32)
+        {
+            right -= 16;
+            uint32x4_t first = vrev64q_u32(vreinterpretq_u32_u8(vld1q_u8(left)));
+            uint32x4_t last  = vrev64q_u32(vreinterpretq_u32_u8(vld1q_u8(right)));
+            vst1q_u8(left,  vreinterpretq_u8_u32(vcombine_u32(vget_high_u32(last),  vget_low_u32(last))));
+            vst1q_u8(right, vreinterpretq_u8_u32(vcombine_u32(vget_high_u32(first), vget_low_u32(first))));
+            left += 16;
+        }
+
+        reverseScalar(left, (right - left) / 4);
+    }
+
+    void premultiplyNeon(sf::Uint8* pixels, std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint8x8x4_t input = vld4_u8(pixels + i * 4);
+            input.val[0] = premultiplyComponentNeon(input.val[0], input.val[3]);
+            input.val[1] = premultiplyComponentNeon(input.val[1], input.val[3]);
+            input.val[2] = premultiplyComponentNeon(input.val[2], input.val[3]);
+            vst4_u8(pixels + i * 4, input);
+        }
+
+        premultiplyScalar(pixels + i * 4, count - i);
+    }
+
+    void downsampleNeon(sf::Uint8* destination, const sf::Uint8* row0, const sf::Uint8* row1, std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint8x16x4_t first  = vld4q_u8(row0 + i * 8);
+            uint8x16x4_t second = vld4q_u8(row1 + i * 8);
+
+            // Add the neighbour pixels pairwise, then the rows, and divide by 4 with rounding
+            uint8x8x4_t result;
+            for (int j = 0; j < 4; ++j)
+                result.val[j] = vrshrn_n_u16(vpadalq_u8(vpaddlq_u8(first.val[j]), second.val[j]), 2);
+            vst4_u8(destination + i * 4, result);
+        }
+
+        downsampleScalar(destination + i * 4, row0 + i * 8, row1 + i * 8, count - i);
+    }
+
+#endif
+
+
+    ////////////////////////////////////////////////////////////
+    // Selection of the best implementations
+    ////////////////////////////////////////////////////////////
+    struct Kernels
+    {
+        void (*fill)(sf::Uint8*, std::size_t, sf::Uint32);
+        void (*mask)(sf::Uint8*, std::size_t, sf::Uint32, sf::Uint32);
+        void (*blend)(sf::Uint8*, const sf::Uint8*, std::size_t);
+        void (*reverse)(sf::Uint8*, std::size_t);
+        void (*premultiply)(sf::Uint8*, std::size_t);
+        void (*downsample)(sf::Uint8*, const sf::Uint8*, const sf::Uint8*, std::size_t);
+    };
+
+    // Get the implementations of an instruction set, if it is compiled in and supported by the CPU
+    bool getKernelTable(sf::priv::PixelKernelSet set, Kernels& kernels)
+    {
+        switch (set)
+        {
+            case sf::priv::ScalarKernels :
+            {
+                Kernels scalar = {&fillScalar, &maskScalar, &blendScalar, &reverseScalar, &premultiplyScalar, &downsampleScalar};
+                kernels = scalar;
+                return true;
+            }
+
+        #if defined(SFML_KERNELS_X86)
+
+            case sf::priv::Sse2Kernels :
+            {
+                if (!hasSse2())
+                    return false;
+
+                Kernels sse2 = {&fillSse2, &maskSse2, &blendSse2, &reverseSse2, &premultiplySse2, &downsampleSse2};
+                kernels = sse2;
+                return true;
+            }
+
+        #ifdef SFML_KERNELS_AVX2
+            case sf::priv::Avx2Kernels :
+            {
+                // The AVX2 implementations finish their work with the SSE2 ones
+                if (!hasSse2() || !hasAvx2())
+                    return false;
+
+                Kernels avx2 = {&fillAvx2, &maskAvx2, &blendAvx2, &reverseAvx2, &premultiplyAvx2, &downsampleAvx2};
+                kernels = avx2;
+                return true;
+            }
+        #endif
+
+        #elif defined(SFML_KERNELS_NEON)
+
+            case sf::priv::NeonKernels :
+            {
+                Kernels neon = {&fillNeon, &maskNeon, &blendNeon, &reverseNeon, &premultiplyNeon, &downsampleNeon};
+                kernels = neon;
+                return true;
+            }
+
+        #endif
+
+            default :
+                return false;
+        }
+    }
+
+    // Implementations used by the routines, with their instruction set
+    struct Selection
+    {
+        Selection() :
+        set(sf::priv::ScalarKernels)
+        {
+            // Pick the best instruction set supported by the CPU
+            const sf::priv::PixelKernelSet sets[] = {sf::priv::Avx2Kernels, sf::priv::Sse2Kernels, sf::priv::NeonKernels, sf::priv::ScalarKernels};
+            for (std::size_t i = 0; i < sizeof(sets) / sizeof(*sets); ++i)
+            {
+                if (getKernelTable(sets[i], kernels))
+                {
+                    set = sets[i];
+                    break;
+                }
+            }
+        }
+
+        Kernels                  kernels;
+        sf::priv::PixelKernelSet set;
+    };
+
+    Selection& getSelection()
+    {
+        // If several threads get here at the same time, they all select the same kernels
+        static Selection selection;
+        return selection;
+    }
+
+    const Kernels& getKernels()
+    {
+        return getSelection().kernels;
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+bool setPixelKernelSet(PixelKernelSet set)
+{
+    Selection& selection = getSelection();
+    if (!getKernelTable(set, selection.kernels))
+        return false;
+
+    selection.set = set;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+PixelKernelSet getPixelKernelSet()
+{
+    return getSelection().set;
+}
+
+
+////////////////////////////////////////////////////////////
+void fillPixels(Uint8* pixels, std::size_t count, const Color& color)
+{
+    getKernels().fill(pixels, count, toPixel(color));
+}
+
+
+////////////////////////////////////////////////////////////
+void maskPixels(Uint8* pixels, std::size_t count, const Color& color, Uint8 alpha)
+{
+    getKernels().mask(pixels, count, toPixel(color), toPixel(Color(color.r, color.g, color.b, alpha)));
+}
+
+
+////////////////////////////////////////////////////////////
+void blendPixels(Uint8* destination, const Uint8* source, std::size_t count)
+{
+    getKernels().blend(destination, source, count);
+}
+
+
+////////////////////////////////////////////////////////////
+void reversePixels(Uint8* pixels, std::size_t count)
+{
+    getKernels().reverse(pixels, count);
+}
+
+
+////////////////////////////////////////////////////////////
+void premultiplyPixels(Uint8* pixels, std::size_t count)
+{
+    getKernels().premultiply(pixels, count);
+}
+
+
+////////////////////////////////////////////////////////////
+void downsamplePixels(Uint8* destination, const Uint8* row0, const Uint8* row1, std::size_t count)
+{
+    getKernels().downsample(destination, row0, row1, count);
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_PIXELKERNELS_HPP
+#define SFML_PIXELKERNELS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <cstddef>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+// Vectorized routines operating on arrays of 32-bits RGBA
+// pixels, used by sf::Image and sf::Texture.
+//
+// The best implementation supported by the CPU (AVX2, SSE2,
+// NEON or plain C++) is selected the first time a routine
+// is called; all of them produce exactly the same results.
+// Pixel arrays don't need any particular alignment.
+//
+// The routines are exported, although they are not part of
+// the public API, so that the benchmarks can call the ones
+// of the library.
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+/// \brief Implementations of the pixel routines
+///
+////////////////////////////////////////////////////////////
+enum PixelKernelSet
+{
+    ScalarKernels, ///< Plain C++, always available
+    Sse2Kernels,   ///< SSE2, on x86 CPUs
+    Avx2Kernels,   ///< AVX2, on x86 CPUs that support it
+    NeonKernels    ///< NEON, on ARM CPUs
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Force the implementation used by the pixel routines
+///
+/// This function is meant for benchmarks and tests, which
+/// compare the implementations. It must not be called while
+/// another thread uses the routines.
+///
+/// \param set Implementation to use
+///
+/// \return True if the implementation is compiled in and
+///         supported by the CPU, false otherwise (then the
+///         current implementation is kept)
+///
+////////////////////////////////////////////////////////////
+SFML_GRAPHICS_API bool setPixelKernelSet(PixelKernelSet set);
+
+////////////////////////////////////////////////////////////
+/// \brief Get the implementation used by the pixel routines
+///
+/// \return Best implementation supported by the CPU, unless
+///         another one was forced with setPixelKernelSet
+///
+////////////////////////////////////////////////////////////
+SFML_GRAPHICS_API PixelKernelSet getPixelKernelSet();
+
+////////////////////////////////////////////////////////////
+/// \brief Set all the pixels of an array to the same color
+///
+/// \param pixels Array of pixels to fill
+/// \param count  Number of pixels in the array
+/// \param color  Fill color
+///
+////////////////////////////////////////////////////////////
+SFML_GRAPHICS_API void fillPixels(Uint8* pixels, std::size_t count, const Color& color);
+
+////////////////////////////////////////////////////////////
+/// \brief Change the alpha of the pixels matching a color
+///
+/// \param pixels Array of pixels to modify
+/// \param count  Number of pixels in the array
+/// \param color  Color of the pixels to modify (alpha included)
+/// \param alpha  Alpha value to assign to matching pixels
+///
+////////////////////////////////////////////////////////////
+SFML_GRAPHICS_API void maskPixels(Uint8* pixels, std::size_t count, const Color& color, Uint8 alpha);
+
+////////////////////////////////////////////////////////////
+/// \brief Blend an array of pixels over another one, using the source alpha
+///
+/// For each pixel, with integer divisions:
+/// dst.rgb = (src.rgb * src.a + dst.rgb * (255 - src.a)) / 255
+/// dst.a   = src.a + dst.a * (255 - src.a) / 255
+///
+/// \param destination Array of pixels to blend onto
+/// \param source      Array of pixels to blend
+/// \param count       Number of pixels in the arrays
+///
+////////////////////////////////////////////////////////////
+SFML_GRAPHICS_API void blendPixels(Uint8* destination, const Uint8* source, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief Reverse the order of the pixels of an array, in place
+///
+/// \param pixels Array of pixels to reverse
+/// \param count  Number of pixels in the array
+///
+////////////////////////////////////////////////////////////
+SFML_GRAPHICS_API void reversePixels(Uint8* pixels, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief Multiply the color components of the pixels by their alpha
+///
+/// For each pixel: rgb = round(rgb * a / 255)
+///
+/// \param pixels Array of pixels to modify
+/// \param count  Number of pixels in the array
+///
+////////////////////////////////////////////////////////////
+SFML_GRAPHICS_API void premultiplyPixels(Uint8* pixels, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief Average blocks of 2x2 pixels taken from two rows
+///
+/// Destination pixel i is the rounded average of the pixels
+/// 2i and 2i+1 of both source rows:
+/// dst = (row0[2i] + row0[2i+1] + row1[2i] + row1[2i+1] + 2) / 4
+///
+/// \param destination Array of pixels to write, must not overlap the rows
+/// \param row0        First source row, of 2 * count pixels
+/// \param row1        Second source row, of 2 * count pixels
+/// \param count       Number of pixels to write
+///
+////////////////////////////////////////////////////////////
+SFML_GRAPHICS_API void downsamplePixels(Uint8* destination, const Uint8* row0, const Uint8* row1, std::size_t count);
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_PIXELKERNELS_HPP
@@ -30,18 +30,204 @@
 #include <SFML/Graphics/Shader.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/Graphics/InstancedSprite.hpp>
+#include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
 #include <iostream>
 
 
+namespace
+{
+    // OpenGL equivalents of the primitive types
+    const GLenum primitiveModes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
+                                     GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN, GL_QUADS};
+
+    // Name and layout (std140) of the per-frame uniform block
+    const char* const frameBlockName  = "sf_Frame";
+    const std::size_t frameViewMatrix = 0;  // mat4
+    const std::size_t frameViewport   = 64; // vec4
+    const std::size_t frameTime       = 80; // float
+    const std::size_t frameBlockSize  = 96;
+
+    // Name and layout (std140) of the per-draw uniform block of the instanced draws
+    const char* const drawBlockName     = "sf_Draw";
+    const std::size_t drawTransform     = 0;   // mat4
+    const std::size_t drawTextureMatrix = 64;  // mat4
+    const std::size_t drawTextured      = 128; // float
+    const std::size_t drawBlockSize     = 144;
+
+    // Built-in program drawing the instanced sprites: each instance is a quad
+    // whose corners are generated from gl_VertexID (drawn as a triangle strip)
+    const char instancingVertexShader[] =
+        "#version 140\n"
+        "layout(std140) uniform sf_Frame { mat4 sf_ViewMatrix; vec4 sf_Viewport; float sf_Time; };\n"
+        "layout(std140) uniform sf_Draw { mat4 sf_Transform; mat4 sf_TextureMatrix; float sf_Textured; };\n"
+        "in vec3 sf_InstanceRow0;\n"
+        "in vec3 sf_InstanceRow1;\n"
+        "in vec4 sf_InstanceTextureRect;\n"
+        "in vec4 sf_InstanceColor;\n"
+        "out vec2 sf_TexCoords;\n"
+        "out vec4 sf_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+        "    vec3 local = vec3(corner * abs(sf_InstanceTextureRect.zw), 1.0);\n"
+        "    vec2 position = vec2(dot(sf_InstanceRow0, local), dot(sf_InstanceRow1, local));\n"
+        "    gl_Position = sf_ViewMatrix * sf_Transform * vec4(position, 0.0, 1.0);\n"
+        "    vec2 texCoords = sf_InstanceTextureRect.xy + corner * sf_InstanceTextureRect.zw;\n"
+        "    sf_TexCoords = (sf_TextureMatrix * vec4(texCoords, 0.0, 1.0)).xy;\n"
+        "    sf_Color = sf_InstanceColor;\n"
+        "}\n";
+
+    const char instancingFragmentShader[] =
+        "#version 140\n"
+        "layout(std140) uniform sf_Draw { mat4 sf_Transform; mat4 sf_TextureMatrix; float sf_Textured; };\n"
+        "uniform sampler2D sf_Texture;\n"
+        "in vec2 sf_TexCoords;\n"
+        "in vec4 sf_Color;\n"
+        "out vec4 sf_FragColor;\n"
+        "void main()\n"
+        "{\n"
+        "    vec4 texel = sf_Textured > 0.5 ? texture(sf_Texture, sf_TexCoords) : vec4(1.0);\n"
+        "    sf_FragColor = sf_Color * texel;\n"
+        "}\n";
+
+    // Built-in program drawing the distance fields: the vertices come from the
+    // fixed-function arrays, the edges are antialiased over the screen-space
+    // footprint of a pixel so that they remain sharp at any scale
+    const char distanceFieldVertexShader[] =
+        "#version 130\n"
+        "#extension GL_ARB_uniform_buffer_object : enable\n"
+        "layout(std140) uniform sf_Frame { mat4 sf_ViewMatrix; vec4 sf_Viewport; float sf_Time; };\n"
+        "out vec2 sf_TexCoords;\n"
+        "out vec4 sf_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_Position = sf_ViewMatrix * gl_ModelViewMatrix * gl_Vertex;\n"
+        "    sf_TexCoords = (gl_TextureMatrix[0] * gl_MultiTexCoord0).xy;\n"
+        "    sf_Color = gl_Color;\n"
+        "}\n";
+
+    const char distanceFieldFragmentShader[] =
+        "#version 130\n"
+        "uniform sampler2D sf_Texture;\n"
+        "uniform float sf_Edge;\n"
+        "uniform float sf_Outline;\n"
+        "uniform vec4 sf_OutlineColor;\n"
+        "in vec2 sf_TexCoords;\n"
+        "in vec4 sf_Color;\n"
+        "out vec4 sf_FragColor;\n"
+        "void main()\n"
+        "{\n"
+        "    float distance = texture(sf_Texture, sf_TexCoords).a;\n"
+        "    float smoothing = 0.5 * fwidth(distance);\n"
+        "    float fill = smoothstep(sf_Edge - smoothing, sf_Edge + smoothing, distance);\n"
+        "    float edge = sf_Edge - sf_Outline;\n"
+        "    float shape = smoothstep(edge - smoothing, edge + smoothing, distance);\n"
+        "    vec4 color = sf_Outline > 0.0 ? mix(sf_OutlineColor, sf_Color, fill) : sf_Color;\n"
+        "    sf_FragColor = vec4(color.rgb, color.a * shape);\n"
+        "}\n";
+
+    // Setup a per-instance attribute of a program, if the program uses it; return its location
+    GLint enableInstanceAttribute(GLhandleARB program, const char* name, GLint size, GLenum type,
+                                  GLboolean normalized, GLsizei stride, std::size_t offset)
+    {
+        GLint location = glGetAttribLocationARB(program, name);
+        if (location != -1)
+        {
+            const char* data = NULL;
+            glCheck(glEnableVertexAttribArrayARB(location));
+            glCheck(glVertexAttribPointerARB(location, size, type, normalized, stride, data + offset));
+            glCheck(glVertexAttribDivisorARB(location, 1));
+        }
+
+        return location;
+    }
+
+    // Restore the default state of an attribute enabled by enableInstanceAttribute
+    void disableInstanceAttribute(GLint location)
+    {
+        if (location != -1)
+        {
+            glCheck(glVertexAttribDivisorARB(location, 0));
+            glCheck(glDisableVertexAttribArrayARB(location));
+        }
+    }
+
+    // Copy a vertex and transform its position
+    inline void copyTransformed(sf::Vertex& destination, const sf::Vertex& source, const sf::Transform& transform)
+    {
+        destination.position  = transform.transformPoint(source.position);
+        destination.color     = source.color;
+        destination.texCoords = source.texCoords;
+    }
+
+    // Get the list primitive type that a primitive type is converted to when batched
+    sf::PrimitiveType getBatchType(sf::PrimitiveType type)
+    {
+        switch (type)
+        {
+            case sf::Points :     return sf::Points;
+            case sf::Lines :
+            case sf::LinesStrip : return sf::Lines;
+            default :             return sf::Triangles;
+        }
+    }
+
+    // Get the number of vertices that a primitive produces once converted to its batch type
+    unsigned int getBatchVertexCount(sf::PrimitiveType type, unsigned int vertexCount)
+    {
+        switch (type)
+        {
+            default :
+            case sf::Points :         return vertexCount;
+            case sf::Lines :          return vertexCount - vertexCount % 2;
+            case sf::LinesStrip :     return vertexCount > 1 ? (vertexCount - 1) * 2 : 0;
+            case sf::Triangles :      return vertexCount - vertexCount % 3;
+            case sf::TrianglesStrip :
+            case sf::TrianglesFan :   return vertexCount > 2 ? (vertexCount - 2) * 3 : 0;
+            case sf::Quads :          return vertexCount / 4 * 6;
+        }
+    }
+}
+
+
 namespace sf
 {
+////////////////////////////////////////////////////////////
+RenderTarget::Statistics::Statistics() :
+drawCalls      (0),
+batches        (0),
+vertices       (0),
+textureBreaks  (0),
+blendModeBreaks(0),
+shaderBreaks   (0),
+primitiveBreaks(0),
+viewBreaks     (0),
+overflowBreaks (0),
+explicitBreaks (0)
+{
+}
+
+
 ////////////////////////////////////////////////////////////
 RenderTarget::RenderTarget() :
-m_defaultView(),
-m_view       (),
-m_cache      (),
-m_shader     (NULL)
+m_defaultView        (),
+m_view               (),
+m_cache              (),
+m_shader             (NULL),
+m_batchingEnabled    (false),
+m_batch              (),
+m_statistics         (),
+m_lastStatistics     (),
+m_frameBlock         (),
+m_clock              (),
+m_drawBlock          (),
+m_instancingShader   (NULL),
+m_distanceFieldShader(NULL)
 {
     m_cache.glStatesSet = false;
 }
@@ -50,12 +236,26 @@ m_shader     (NULL)
 ////////////////////////////////////////////////////////////
 RenderTarget::~RenderTarget()
 {
+    // The texture and the shader of the pending batch must not refer to a destroyed target
+    if (!m_batch.vertices.empty())
+    {
+        if (m_batch.texture && (m_batch.texture->m_batchTarget == this))
+            m_batch.texture->m_batchTarget = NULL;
+        if (m_batch.shader && (m_batch.shader->m_batchTarget == this))
+            m_batch.shader->m_batchTarget = NULL;
+    }
+
+    delete m_instancingShader;
+    delete m_distanceFieldShader;
 }
 
 
 ////////////////////////////////////////////////////////////
 void RenderTarget::clear(const Color& color)
 {
+    // Pending draws must not be rendered on top of the cleared contents
+    flushBatch(ExplicitFlush);
+
     if (activate(true))
     {
         glCheck(glClearColor(color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f));
@@ -67,6 +267,9 @@ void RenderTarget::clear(const Color& color)
 ////////////////////////////////////////////////////////////
 void RenderTarget::setView(const View& view)
 {
+    // The pending batch was built for the previous view
+    flushBatch(ViewChange);
+
     m_view = view;
     m_cache.viewChanged = true;
 }
@@ -170,6 +373,252 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
     if (!vertices || (vertexCount == 0))
         return;
 
+    m_statistics.drawCalls++;
+
+    if (m_batchingEnabled)
+        batchPrimitives(vertices, vertexCount, type, states);
+    else
+        drawPrimitives(vertices, vertexCount, type, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::draw(const VertexBuffer& vertexBuffer, const RenderStates& states)
+{
+    draw(vertexBuffer, 0, vertexBuffer.getVertexCount(), states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::draw(const VertexBuffer& vertexBuffer, unsigned int firstVertex,
+                        unsigned int vertexCount, const RenderStates& states)
+{
+    // Clamp the range to the size of the buffer
+    unsigned int size = vertexBuffer.getVertexCount();
+    if (firstVertex >= size)
+        return;
+    vertexCount = std::min(vertexCount, size - firstVertex);
+
+    // Nothing to draw?
+    if (!vertexBuffer.getNativeHandle() || (vertexCount == 0))
+        return;
+
+    m_statistics.drawCalls++;
+
+    // The vertices are already in the graphics card memory, they can't be merged with the batch
+    flushBatch(ExplicitFlush);
+
+    // Make sure we are active and have a shader to draw with
+    if (activate(true) && m_shader)
+    {
+        // First set the persistent OpenGL states if it's the very first call
+        if (!m_cache.glStatesSet)
+            resetGLStates();
+
+        // Vertex buffers are never pre-transformed
+        applyTransform(states.transform);
+
+        // Apply the view, blend mode, texture and shader
+        applyStates(states);
+
+        // Setup the pointers to the vertices' components, as offsets in the buffer
+        const char* data = NULL;
+        glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, vertexBuffer.getNativeHandle()));
+        glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
+        glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
+        glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
+
+        // Draw the primitives
+        glCheck(glDrawArrays(primitiveModes[vertexBuffer.getPrimitiveType()], firstVertex, vertexCount));
+        glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0));
+        m_statistics.batches++;
+        m_statistics.vertices += vertexCount;
+
+        // Unbind the shader, if any
+        if (states.shader)
+            applyShader(NULL);
+
+        // The pointers now refer to the buffer, the next draw must set them again
+        m_cache.useVertexCache = false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawInstanced(const InstancedSprite& sprite, const RenderStates& states)
+{
+    // Nothing to draw?
+    std::size_t instanceCount = sprite.getInstanceCount();
+    if (instanceCount == 0)
+        return;
+
+    m_statistics.drawCalls++;
+
+    // The quads are generated by the graphics card, they can't be merged with the batch
+    flushBatch(ExplicitFlush);
+
+    // Make sure we are active and have a shader to draw with
+    if (activate(true) && m_shader && InstancedSprite::isAvailable())
+    {
+        // First set the persistent OpenGL states if it's the very first call
+        if (!m_cache.glStatesSet)
+            resetGLStates();
+
+        // Use the built-in instancing program, unless a custom shader is given
+        const Shader* shader = states.shader ? states.shader : getInstancingShader();
+        if (!shader || !shader->getNativeHandle())
+            return;
+
+        // Send the modified instances to the graphics card
+        unsigned int instanceBuffer = sprite.update();
+        if (!instanceBuffer)
+            return;
+
+        // Update the per-draw states shared by the shaders
+        if (!m_drawBlock.getNativeHandle() && !m_drawBlock.create(drawBlockName, drawBlockSize))
+            return;
+        float textureMatrix[16] = {1.f, 0.f, 0.f, 0.f,
+                                   0.f, 1.f, 0.f, 0.f,
+                                   0.f, 0.f, 1.f, 0.f,
+                                   0.f, 0.f, 0.f, 1.f};
+        if (states.texture)
+            getTextureMatrix(*states.texture, textureMatrix);
+        m_drawBlock.setParameter(drawTransform, states.transform);
+        m_drawBlock.setData(drawTextureMatrix, textureMatrix, sizeof(textureMatrix));
+        m_drawBlock.setParameter(drawTextured, states.texture ? 1.f : 0.f);
+        UniformBlock::bind(&m_drawBlock);
+
+        // Apply the view, blend mode, texture and shader
+        RenderStates instanceStates(states);
+        instanceStates.shader = shader;
+        applyStates(instanceStates);
+
+        // Setup the per-instance attributes, as offsets in the instance buffer
+        GLhandleARB program = shader->getNativeHandle();
+        GLsizei stride = sizeof(InstancedSprite::Instance);
+        glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, instanceBuffer));
+        GLint row0  = enableInstanceAttribute(program, "sf_InstanceRow0", 3, GL_FLOAT, GL_FALSE, stride, 0);
+        GLint row1  = enableInstanceAttribute(program, "sf_InstanceRow1", 3, GL_FLOAT, GL_FALSE, stride, 12);
+        GLint rect  = enableInstanceAttribute(program, "sf_InstanceTextureRect", 4, GL_FLOAT, GL_FALSE, stride, 24);
+        GLint color = enableInstanceAttribute(program, "sf_InstanceColor", 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, 40);
+
+        // Draw all the quads at once
+        glCheck(glDrawArraysInstancedARB(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instanceCount)));
+        m_statistics.batches++;
+        m_statistics.vertices += static_cast<unsigned int>(instanceCount * 4);
+
+        // Restore the attributes, so that they don't affect the next draws
+        disableInstanceAttribute(row0);
+        disableInstanceAttribute(row1);
+        disableInstanceAttribute(rect);
+        disableInstanceAttribute(color);
+        glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0));
+
+        // Unbind the shader
+        applyShader(NULL);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawDistanceField(const Vertex* vertices, unsigned int vertexCount, PrimitiveType type,
+                                     float edge, float outline, const Color& outlineColor,
+                                     const RenderStates& states)
+{
+    // Nothing to draw?
+    if (!vertices || (vertexCount == 0))
+        return;
+
+    // A custom shader replaces the built-in program, like with a regular draw
+    if (states.shader || !activate(true))
+    {
+        draw(vertices, vertexCount, type, states);
+        return;
+    }
+
+    Shader* shader = getDistanceFieldShader();
+    if (!shader)
+    {
+        // Without the program, the alpha test keeps the pixels inside the shapes:
+        // the edges are aliased and there's no outline
+        static bool warned = false;
+        if (!warned)
+        {
+            err() << "The distance field shader is not supported by your system, distance fields are drawn without antialiasing nor outline" << std::endl;
+            warned = true;
+        }
+
+        // The batch must be drawn with the alpha test enabled, and the
+        // previous one without it
+        flushBatch(ShaderChange);
+        if (!m_cache.glStatesSet)
+            resetGLStates();
+
+        glCheck(glEnable(GL_ALPHA_TEST));
+        glCheck(glAlphaFunc(GL_GEQUAL, edge));
+        draw(vertices, vertexCount, type, states);
+        flushBatch(ShaderChange);
+        glCheck(glDisable(GL_ALPHA_TEST));
+        return;
+    }
+
+    // The parameters are shared by all the draws that use the program: draws with
+    // different parameters can't be in the same batch
+    const DistanceFieldStyle& style = m_distanceFieldStyle;
+    if ((edge != style.edge) || (outline != style.outline) || (outlineColor != style.outlineColor))
+    {
+        if (m_batch.shader == shader)
+            flushBatch(ShaderChange);
+
+        shader->setParameter("sf_Edge", edge);
+        shader->setParameter("sf_Outline", outline);
+        shader->setParameter("sf_OutlineColor", outlineColor);
+        m_distanceFieldStyle.edge         = edge;
+        m_distanceFieldStyle.outline      = outline;
+        m_distanceFieldStyle.outlineColor = outlineColor;
+    }
+
+    RenderStates distanceFieldStates(states);
+    distanceFieldStates.shader = shader;
+    draw(vertices, vertexCount, type, distanceFieldStates);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::setBatchingEnabled(bool enabled)
+{
+    if (!enabled)
+        flushBatch(ExplicitFlush);
+
+    m_batchingEnabled = enabled;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isBatchingEnabled() const
+{
+    return m_batchingEnabled;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::flush()
+{
+    flushBatch(ExplicitFlush);
+}
+
+
+////////////////////////////////////////////////////////////
+const RenderTarget::Statistics& RenderTarget::getStatistics() const
+{
+    return m_lastStatistics;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawPrimitives(const Vertex* vertices, unsigned int vertexCount,
+                                  PrimitiveType type, const RenderStates& states)
+{
     // Make sure we are active and have a shader to draw with
     if (activate(true) && m_shader)
     {
@@ -202,22 +651,8 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
             applyTransform(states.transform);
         }
 
-        // Apply the view
-        if (m_cache.viewChanged)
-            applyCurrentView();
-
-        // Apply the blend mode
-        if (states.blendMode != m_cache.lastBlendMode)
-            applyBlendMode(states.blendMode);
-
-        // Apply the texture
-        Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
-        if (textureId != m_cache.lastTextureId)
-            applyTexture(states.texture);
-
-        // Apply the shader
-        if (states.shader)
-            applyShader(states.shader);
+        // Apply the view, blend mode, texture and shader
+        applyStates(states);
 
         // If we pre-transform the vertices, we must use our internal vertex cache
         if (useVertexCache)
@@ -238,13 +673,10 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
             glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
         }
 
-        // Find the OpenGL primitive type
-        static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
-                                       GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN, GL_QUADS};
-        GLenum mode = modes[type];
-
         // Draw the primitives
-        glCheck(glDrawArrays(mode, 0, vertexCount));
+        glCheck(glDrawArrays(primitiveModes[type], 0, vertexCount));
+        m_statistics.batches++;
+        m_statistics.vertices += vertexCount;
 
         // Unbind the shader, if any
         if (states.shader)
@@ -256,9 +688,202 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::batchPrimitives(const Vertex* vertices, unsigned int vertexCount,
+                                   PrimitiveType type, const RenderStates& states)
+{
+    // Find out how the primitives will be stored in the batch
+    PrimitiveType batchType = getBatchType(type);
+    unsigned int batchCount = getBatchVertexCount(type, vertexCount);
+    if (batchCount == 0)
+        return;
+
+    // Geometry that doesn't fit in a batch is drawn directly
+    if (batchCount > Batch::MaxVertexCount)
+    {
+        flushBatch(Overflow);
+        drawPrimitives(vertices, vertexCount, type, states);
+        return;
+    }
+
+    // Flush the pending batch if it can't be extended with these primitives
+    Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
+    if (!m_batch.vertices.empty())
+    {
+        if (textureId != m_batch.textureId)
+            flushBatch(TextureChange);
+        else if (states.blendMode != m_batch.blendMode)
+            flushBatch(BlendModeChange);
+        else if (states.shader != m_batch.shader)
+            flushBatch(ShaderChange);
+        else if (batchType != m_batch.type)
+            flushBatch(PrimitiveChange);
+        else if (m_batch.vertices.size() + batchCount > Batch::MaxVertexCount)
+            flushBatch(Overflow);
+    }
+
+    // Start a new batch if needed
+    if (m_batch.vertices.empty())
+    {
+        m_batch.type      = batchType;
+        m_batch.blendMode = states.blendMode;
+        m_batch.texture   = states.texture;
+        m_batch.textureId = textureId;
+        m_batch.shader    = states.shader;
+
+        // Tell the texture, so that modifying or destroying it draws the batch first;
+        // a batch of another target using the same texture must be drawn now
+        if (states.texture)
+        {
+            states.texture->flushPendingBatch();
+            states.texture->m_batchTarget = this;
+        }
+
+        // Same for the parameters of the shader
+        if (states.shader)
+        {
+            states.shader->flushPendingBatch();
+            states.shader->m_batchTarget = this;
+        }
+    }
+
+    // Pre-transform the vertices and append them, converted to the batch primitive type
+    std::size_t first = m_batch.vertices.size();
+    m_batch.vertices.resize(first + batchCount);
+    Vertex* out = &m_batch.vertices[first];
+    const Transform& transform = states.transform;
+
+    switch (type)
+    {
+        default :
+        case Points :
+        case Lines :
+        case Triangles :
+        {
+            for (unsigned int i = 0; i < batchCount; ++i)
+                copyTransformed(*out++, vertices[i], transform);
+            break;
+        }
+
+        case LinesStrip :
+        {
+            for (unsigned int i = 0; i + 1 < vertexCount; ++i)
+            {
+                copyTransformed(*out++, vertices[i], transform);
+                copyTransformed(*out++, vertices[i + 1], transform);
+            }
+            break;
+        }
+
+        case TrianglesStrip :
+        {
+            // Every other triangle is flipped to keep a consistent winding
+            for (unsigned int i = 0; i + 2 < vertexCount; ++i)
+            {
+                copyTransformed(*out++, vertices[i + (i % 2)], transform);
+                copyTransformed(*out++, vertices[i + 1 - (i % 2)], transform);
+                copyTransformed(*out++, vertices[i + 2], transform);
+            }
+            break;
+        }
+
+        case TrianglesFan :
+        {
+            Vertex center;
+            copyTransformed(center, vertices[0], transform);
+            for (unsigned int i = 1; i + 1 < vertexCount; ++i)
+            {
+                *out++ = center;
+                copyTransformed(*out++, vertices[i], transform);
+                copyTransformed(*out++, vertices[i + 1], transform);
+            }
+            break;
+        }
+
+        case Quads :
+        {
+            for (unsigned int i = 0; i + 3 < vertexCount; i += 4)
+            {
+                Vertex* quad = out;
+                copyTransformed(quad[0], vertices[i], transform);
+                copyTransformed(quad[1], vertices[i + 1], transform);
+                copyTransformed(quad[2], vertices[i + 2], transform);
+                quad[3] = quad[0];
+                quad[4] = quad[2];
+                copyTransformed(quad[5], vertices[i + 3], transform);
+                out += 6;
+            }
+            break;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::applyStates(const RenderStates& states)
+{
+    // Apply the view
+    if (m_cache.viewChanged)
+        applyCurrentView();
+
+    // Apply the blend mode
+    if (states.blendMode != m_cache.lastBlendMode)
+        applyBlendMode(states.blendMode);
+
+    // Apply the texture
+    Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
+    if (textureId != m_cache.lastTextureId)
+        applyTexture(states.texture);
+
+    // Apply the shader
+    if (states.shader)
+        applyShader(states.shader);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::flushBatch(FlushCause cause)
+{
+    // Nothing to draw?
+    if (m_batch.vertices.empty())
+        return;
+
+    switch (cause)
+    {
+        case TextureChange :   m_statistics.textureBreaks++;   break;
+        case BlendModeChange : m_statistics.blendModeBreaks++; break;
+        case ShaderChange :    m_statistics.shaderBreaks++;    break;
+        case PrimitiveChange : m_statistics.primitiveBreaks++; break;
+        case ViewChange :      m_statistics.viewBreaks++;      break;
+        case Overflow :        m_statistics.overflowBreaks++;  break;
+        case ExplicitFlush :   m_statistics.explicitBreaks++;  break;
+    }
+
+    // Take the vertices out of the batch before drawing them, so that
+    // the batch is already empty if drawing causes a recursive flush
+    std::vector<Vertex> vertices;
+    vertices.swap(m_batch.vertices);
+
+    // The texture and the parameters of the shader can change freely again
+    if (m_batch.texture && (m_batch.texture->m_batchTarget == this))
+        m_batch.texture->m_batchTarget = NULL;
+    if (m_batch.shader && (m_batch.shader->m_batchTarget == this))
+        m_batch.shader->m_batchTarget = NULL;
+
+    RenderStates states(m_batch.blendMode, Transform::Identity, m_batch.texture, m_batch.shader);
+    drawPrimitives(&vertices[0], static_cast<unsigned int>(vertices.size()), m_batch.type, states);
+
+    // Give the storage back to the batch so that it doesn't have to be reallocated
+    vertices.clear();
+    m_batch.vertices.swap(vertices);
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::pushGLStates()
 {
+    flushBatch(ExplicitFlush);
+
     if (activate(true))
     {
         glCheck(glPushClientAttrib(GL_CLIENT_ALL_ATTRIB_BITS));
@@ -278,6 +903,8 @@ void RenderTarget::pushGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::popGLStates()
 {
+    flushBatch(ExplicitFlush);
+
     if (activate(true))
     {
         glCheck(glMatrixMode(GL_PROJECTION));
@@ -295,11 +922,17 @@ void RenderTarget::popGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::resetGLStates()
 {
+    flushBatch(ExplicitFlush);
+
     if (activate(true))
     {
         // Make sure that GLEW is initialized
         priv::ensureGlewInit();
 
+        // Create the per-frame uniform block, if the system supports it
+        if (!m_frameBlock.getNativeHandle() && UniformBlock::isAvailable())
+            m_frameBlock.create(frameBlockName, frameBlockSize);
+
         // Define the default OpenGL states
         glCheck(glDisable(GL_CULL_FACE));
         glCheck(glDisable(GL_LIGHTING));
@@ -334,6 +967,24 @@ void RenderTarget::initialize(sf::Shader* shader)
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::finishFrame()
+{
+    m_lastStatistics = m_statistics;
+    m_statistics = Statistics();
+
+    // Refresh the per-frame uniform block (time) on the first draw of the next frame
+    m_cache.viewChanged = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::invalidateGLStates()
+{
+    m_cache.glStatesSet = false;
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyCurrentView()
 {
@@ -341,7 +992,19 @@ void RenderTarget::applyCurrentView()
     IntRect viewport = getViewport(m_view);
     int top = getSize().y - (viewport.top + viewport.height);
     glCheck(glViewport(viewport.left, top, viewport.width, viewport.height));
-    
+
+    // Update the per-frame states shared by all the shaders, in a single transfer
+    if (m_frameBlock.getNativeHandle())
+    {
+        float viewportValues[4] = {static_cast<float>(viewport.left), static_cast<float>(viewport.top),
+                                   static_cast<float>(viewport.width), static_cast<float>(viewport.height)};
+
+        m_frameBlock.setParameter(frameViewMatrix, m_view.getTransform());
+        m_frameBlock.setData(frameViewport, viewportValues, sizeof(viewportValues));
+        m_frameBlock.setParameter(frameTime, m_clock.getElapsedTime().asSeconds());
+        UniformBlock::bind(&m_frameBlock);
+    }
+
     m_cache.viewChanged = false;
 }
 
@@ -385,6 +1048,98 @@ void RenderTarget::applyBlendMode(BlendMode mode)
     m_cache.lastBlendMode = mode;
 }
 
+
+////////////////////////////////////////////////////////////
+void RenderTarget::applyTransform(const Transform& transform)
+{
+    // No need to call glMatrixMode(GL_MODELVIEW), it is always the
+    // current mode (for optimization purpose, since it's the most used)
+    glCheck(glLoadMatrixf(transform.getMatrix()));
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::applyTexture(const Texture* texture)
+{
+    if (texture && texture->m_texture)
+    {
+        glCheck(glBindTexture(GL_TEXTURE_2D, texture->m_texture));
+
+        // Texture coordinates are given in pixels, so we have to convert them
+        GLfloat matrix[16] = {1.f, 0.f, 0.f, 0.f,
+                              0.f, 1.f, 0.f, 0.f,
+                              0.f, 0.f, 1.f, 0.f,
+                              0.f, 0.f, 0.f, 1.f};
+        getTextureMatrix(*texture, matrix);
+
+        glCheck(glMatrixMode(GL_TEXTURE));
+        glCheck(glLoadMatrixf(matrix));
+        glCheck(glMatrixMode(GL_MODELVIEW));
+    }
+    else
+    {
+        glCheck(glBindTexture(GL_TEXTURE_2D, 0));
+    }
+
+    m_cache.lastTextureId = texture ? texture->m_cacheId : 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::applyShader(const Shader* shader)
+{
+    Shader::bind(shader);
+}
+
+
+////////////////////////////////////////////////////////////
+const Shader* RenderTarget::getInstancingShader()
+{
+    if (!m_instancingShader)
+    {
+        m_instancingShader = new Shader;
+        m_instancingShader->loadFromMemory(instancingVertexShader, "", instancingFragmentShader);
+    }
+
+    return m_instancingShader->getNativeHandle() ? m_instancingShader : NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+Shader* RenderTarget::getDistanceFieldShader()
+{
+    if (!m_distanceFieldShader)
+    {
+        // Don't try to compile the program if it can't work (the compiler would report errors)
+        m_distanceFieldShader = new Shader;
+        if (Font::isDistanceFieldAvailable())
+            m_distanceFieldShader->loadFromMemory(distanceFieldVertexShader, "", distanceFieldFragmentShader);
+
+        // Force the parameters to be sent on the first draw
+        m_distanceFieldStyle.edge         = -1.f;
+        m_distanceFieldStyle.outline      = -1.f;
+        m_distanceFieldStyle.outlineColor = Color::Transparent;
+    }
+
+    return m_distanceFieldShader->getNativeHandle() ? m_distanceFieldShader : NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::getTextureMatrix(const Texture& texture, float* matrix)
+{
+    // Convert the coordinates to the normalized range, and
+    // flip them if the pixels are flipped
+    matrix[0] = 1.f / texture.m_actualSize.x;
+    matrix[5] = 1.f / texture.m_actualSize.y;
+
+    if (texture.m_pixelsFlipped)
+    {
+        matrix[5] = -matrix[5];
+        matrix[13] = static_cast<float>(texture.m_size.y) / texture.m_actualSize.y;
+    }
+}
+
 } // namespace sf
 
 
@@ -395,6 +1150,11 @@ void RenderTarget::applyBlendMode(BlendMode mode)
 //   If SetView was called since last draw, the projection
 //   matrix is updated. We don't need more, the view doesn't
 //   change frequently.
+//   The projection matrix reaches the shaders through the
+//   "sf_Frame" uniform block, which all of them share: a view
+//   change costs one buffer update no matter how many shaders
+//   exist. The block is also refreshed once per frame, for the
+//   time.
 //
 // * Transform
 //   The transform matrix is usually expensive because each
@@ -421,5 +1181,14 @@ void RenderTarget::applyBlendMode(BlendMode mode)
 //   like matrices or textures. The only optimization that we
 //   do is that we avoid setting a null shader if there was
 //   already none for the previous draw.
+//
+// * Batching
+//   When batching is enabled, the vertices of consecutive draws
+//   that share the same texture, blending mode and shader are
+//   pre-transformed and appended to a single vertex stream, which
+//   is drawn with the identity transform when the states change.
+//   Strips, fans and quads are converted to lists so that they can
+//   be merged. The texture is compared with its cache identifier,
+//   for the same reasons as above.
 // 
 ////////////////////////////////////////////////////////////
@@ -50,9 +50,23 @@ RenderTexture::~RenderTexture()
 
 ////////////////////////////////////////////////////////////
 bool RenderTexture::create(unsigned int width, unsigned int height, sf::Shader* shader, bool depthBuffer)
+{
+    return create(width, height, shader, ContextSettings(depthBuffer ? 32 : 0), Texture::RGBA8, NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTexture::create(unsigned int width, unsigned int height, sf::Shader* shader, const ContextSettings& settings, Texture::PixelFormat format)
+{
+    return create(width, height, shader, settings, format, NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTexture::create(unsigned int width, unsigned int height, sf::Shader* shader, const ContextSettings& settings, Texture::PixelFormat format, priv::RenderTextureContext* sharedContext)
 {
     // Create the texture
-    if (!m_texture.create(width, height))
+    if (!m_texture.create(width, height, format))
     {
         err() << "Impossible to create render texture (failed to create the target texture)" << std::endl;
         return false;
@@ -66,7 +80,7 @@ bool RenderTexture::create(unsigned int width, unsigned int height, sf::Shader*
     if (priv::RenderTextureImplFBO::isAvailable())
     {
         // Use frame-buffer object (FBO)
-        m_impl = new priv::RenderTextureImplFBO;
+        m_impl = new priv::RenderTextureImplFBO(sharedContext);
     }
     else
     {
@@ -75,7 +89,7 @@ bool RenderTexture::create(unsigned int width, unsigned int height, sf::Shader*
     }
 
     // Initialize the render texture
-    if (!m_impl->create(width, height, m_texture.m_texture, depthBuffer))
+    if (!m_impl->create(width, height, m_texture.m_texture, format, settings))
         return false;
 
     // We can now initialize the render target part
@@ -116,19 +130,44 @@ bool RenderTexture::isRepeated() const
 ////////////////////////////////////////////////////////////
 bool RenderTexture::setActive(bool active)
 {
-    return m_impl && m_impl->activate(active);
+    // Rendering modifies the target texture: the draws already batched
+    // with it, in other render targets, must use its previous contents
+    if (active)
+        m_texture.flushPendingBatch();
+
+    if (!m_impl || !m_impl->activate(active))
+        return false;
+
+    // Another render texture may have changed the states of our context
+    if (active && m_impl->contextStatesChanged())
+        invalidateGLStates();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTexture::generateMipmap()
+{
+    return m_texture.generateMipmap();
 }
 
 
 ////////////////////////////////////////////////////////////
 void RenderTexture::display()
 {
+    // Draw the pending batch before updating the texture
+    flush();
+
     // Update the target texture
     if (setActive(true))
     {
         m_impl->updateTexture(m_texture.m_texture);
         m_texture.m_pixelsFlipped = true;
+        m_texture.invalidateMipmap();
     }
+
+    finishFrame();
 }
 
 
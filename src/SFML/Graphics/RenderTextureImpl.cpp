@@ -38,6 +38,14 @@ RenderTextureImpl::~RenderTextureImpl()
     // Nothing to do
 }
 
+
+////////////////////////////////////////////////////////////
+bool RenderTextureImpl::contextStatesChanged()
+{
+    // By default each implementation owns its context
+    return false;
+}
+
 } // namespace priv
 
 } // namespace sf
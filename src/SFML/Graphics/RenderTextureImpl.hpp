@@ -28,6 +28,8 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Window/ContextSettings.hpp>
 #include <SFML/System/NonCopyable.hpp>
 
 
@@ -52,15 +54,16 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Create the render texture implementation
     ///
-    /// \param width       Width of the texture to render to
-    /// \param height      Height of the texture to render to
-    /// \param textureId   OpenGL identifier of the target texture
-    /// \param depthBuffer Is a depth buffer requested?
+    /// \param width     Width of the texture to render to
+    /// \param height    Height of the texture to render to
+    /// \param textureId OpenGL identifier of the target texture
+    /// \param format    Pixel format of the target texture
+    /// \param settings  Requested depth buffer and antialiasing level
     ///
     /// \return True if creation has been successful
     ///
     ////////////////////////////////////////////////////////////
-    virtual bool create(unsigned int width, unsigned int height, unsigned int textureId, bool depthBuffer) = 0;
+    virtual bool create(unsigned int width, unsigned int height, unsigned int textureId, Texture::PixelFormat format, const ContextSettings& settings) = 0;
 
     ////////////////////////////////////////////////////////////
     /// \brief Activate or deactivate the render texture for rendering
@@ -79,6 +82,18 @@ public :
     ///
     ////////////////////////////////////////////////////////////
     virtual void updateTexture(unsigned int textureId) = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the states of the OpenGL context may
+    ///        have been changed since the last activation
+    ///
+    /// This happens when the context is shared with other
+    /// render textures. Calling this function resets the flag.
+    ///
+    /// \return True if the OpenGL states must be set again
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool contextStatesChanged();
 };
 
 } // namespace priv
@@ -55,14 +55,20 @@ RenderTextureImplDefault::~RenderTextureImplDefault()
 
 
 ////////////////////////////////////////////////////////////
-bool RenderTextureImplDefault::create(unsigned int width, unsigned int height, unsigned int, bool depthBuffer)
+bool RenderTextureImplDefault::create(unsigned int width, unsigned int height, unsigned int, Texture::PixelFormat format, const ContextSettings& settings)
 {
     // Store the dimensions
     m_width = width;
     m_height = height;
 
-    // Create the in-memory OpenGL context
-    m_context = new Context(ContextSettings(depthBuffer ? 32 : 0), width, height);
+    // Depth textures are filled by copying the depth buffer of the context
+    ContextSettings contextSettings = settings;
+    if ((format == Texture::Depth) && (contextSettings.depthBits == 0))
+        contextSettings.depthBits = 24;
+
+    // Create the in-memory OpenGL context; when it is multisampled,
+    // copying its pixels to the texture resolves the samples
+    m_context = new Context(contextSettings, width, height);
 
     return true;
 }
@@ -26,7 +26,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/RenderTextureImplFBO.hpp>
-#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/TextureFormat.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
 #include <SFML/System/Err.hpp>
 
@@ -36,9 +36,17 @@ namespace sf
 namespace priv
 {
 ////////////////////////////////////////////////////////////
-RenderTextureImplFBO::RenderTextureImplFBO() :
-m_frameBuffer(0),
-m_depthBuffer(0)
+RenderTextureImplFBO::RenderTextureImplFBO(RenderTextureContext* sharedContext) :
+m_context           (NULL),
+m_sharedContext     (sharedContext),
+m_frameBuffer       (0),
+m_depthBuffer       (0),
+m_sampleBuffer      (0),
+m_resolveFrameBuffer(0),
+m_width             (0),
+m_height            (0),
+m_depthTarget       (false),
+m_statesChanged     (false)
 {
 
 }
@@ -47,7 +55,21 @@ m_depthBuffer(0)
 ////////////////////////////////////////////////////////////
 RenderTextureImplFBO::~RenderTextureImplFBO()
 {
-    ensureGlContext();
+    // Frame buffers are not shared between contexts, so they must
+    // be destroyed in the one which created them
+    if (m_sharedContext)
+    {
+        m_sharedContext->context.setActive(true);
+        if (m_sharedContext->frameBuffer == m_frameBuffer)
+        {
+            glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0));
+            m_sharedContext->frameBuffer = 0;
+        }
+    }
+    else
+    {
+        ensureGlContext();
+    }
 
     // Destroy the depth buffer
     if (m_depthBuffer)
@@ -56,12 +78,24 @@ RenderTextureImplFBO::~RenderTextureImplFBO()
         glCheck(glDeleteRenderbuffersEXT(1, &depthBuffer));
     }
 
-    // Destroy the frame buffer
+    // Destroy the multisampled buffer
+    if (m_sampleBuffer)
+    {
+        GLuint sampleBuffer = static_cast<GLuint>(m_sampleBuffer);
+        glCheck(glDeleteRenderbuffersEXT(1, &sampleBuffer));
+    }
+
+    // Destroy the frame buffers
     if (m_frameBuffer)
     {
         GLuint frameBuffer = static_cast<GLuint>(m_frameBuffer);
         glCheck(glDeleteFramebuffersEXT(1, &frameBuffer));
     }
+    if (m_resolveFrameBuffer)
+    {
+        GLuint resolveFrameBuffer = static_cast<GLuint>(m_resolveFrameBuffer);
+        glCheck(glDeleteFramebuffersEXT(1, &resolveFrameBuffer));
+    }
 
     // Delete the context
     delete m_context;
@@ -81,10 +115,47 @@ bool RenderTextureImplFBO::isAvailable()
 
 
 ////////////////////////////////////////////////////////////
-bool RenderTextureImplFBO::create(unsigned int width, unsigned int height, unsigned int textureId, bool depthBuffer)
+bool RenderTextureImplFBO::create(unsigned int width, unsigned int height, unsigned int textureId, Texture::PixelFormat format, const ContextSettings& settings)
 {
-    // Create the context
-    m_context = new Context;
+    // Create the context, or reuse the shared one
+    if (m_sharedContext)
+    {
+        if (!m_sharedContext->context.setActive(true))
+        {
+            err() << "Impossible to create render texture (failed to activate the shared context)" << std::endl;
+            return false;
+        }
+    }
+    else
+    {
+        m_context = new Context;
+    }
+
+    // Store the dimensions
+    m_width = width;
+    m_height = height;
+
+    // Depth textures are attached as the depth buffer, and the frame buffer has no color buffer
+    m_depthTarget = (format == Texture::Depth);
+    GLenum attachment = m_depthTarget ? GL_DEPTH_ATTACHMENT_EXT : GL_COLOR_ATTACHMENT0_EXT;
+
+    // Check the number of samples of the color and depth buffers
+    unsigned int samples = settings.antialiasingLevel;
+    if (samples > 0)
+    {
+        if (GLEW_EXT_framebuffer_multisample && GLEW_EXT_framebuffer_blit)
+        {
+            GLint maxSamples = 0;
+            glCheck(glGetIntegerv(GL_MAX_SAMPLES_EXT, &maxSamples));
+            if (samples > static_cast<unsigned int>(maxSamples))
+                samples = static_cast<unsigned int>(maxSamples);
+        }
+        else
+        {
+            err() << "Multisampled render textures are not supported by your system, antialiasing is disabled" << std::endl;
+            samples = 0;
+        }
+    }
 
     // Create the framebuffer object
     GLuint frameBuffer = 0;
@@ -96,9 +167,20 @@ bool RenderTextureImplFBO::create(unsigned int width, unsigned int height, unsig
         return false;
     }
     glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_frameBuffer));
+    if (m_sharedContext)
+    {
+        m_sharedContext->frameBuffer = m_frameBuffer;
+        m_statesChanged = true;
+    }
+
+    if (m_depthTarget)
+    {
+        glCheck(glDrawBuffer(GL_NONE));
+        glCheck(glReadBuffer(GL_NONE));
+    }
 
     // Create the depth buffer if requested
-    if (depthBuffer)
+    if ((settings.depthBits > 0) && !m_depthTarget)
     {
         GLuint depth = 0;
         glCheck(glGenRenderbuffersEXT(1, &depth));
@@ -109,12 +191,33 @@ bool RenderTextureImplFBO::create(unsigned int width, unsigned int height, unsig
             return false;
         }
         glCheck(glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, m_depthBuffer));
-        glCheck(glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_DEPTH_COMPONENT, width, height));
+        if (samples > 0)
+            glCheck(glRenderbufferStorageMultisampleEXT(GL_RENDERBUFFER_EXT, samples, GL_DEPTH_COMPONENT, width, height));
+        else
+            glCheck(glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_DEPTH_COMPONENT, width, height));
         glCheck(glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT, GL_RENDERBUFFER_EXT, m_depthBuffer));
     }
 
-    // Link the texture to the frame buffer
-    glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, textureId, 0));
+    if (samples > 0)
+    {
+        // Render to a multisampled buffer, which is resolved into the texture in updateTexture
+        GLuint buffer = 0;
+        glCheck(glGenRenderbuffersEXT(1, &buffer));
+        m_sampleBuffer = static_cast<unsigned int>(buffer);
+        if (!m_sampleBuffer)
+        {
+            err() << "Impossible to create render texture (failed to create the multisampled buffer)" << std::endl;
+            return false;
+        }
+        glCheck(glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, m_sampleBuffer));
+        glCheck(glRenderbufferStorageMultisampleEXT(GL_RENDERBUFFER_EXT, samples, getTextureFormat(format).internalFormat, width, height));
+        glCheck(glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, attachment, GL_RENDERBUFFER_EXT, m_sampleBuffer));
+    }
+    else
+    {
+        // Link the texture to the frame buffer
+        glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, attachment, GL_TEXTURE_2D, textureId, 0));
+    }
 
     // A final check, just to be sure...
     if (glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT) != GL_FRAMEBUFFER_COMPLETE_EXT)
@@ -124,6 +227,33 @@ bool RenderTextureImplFBO::create(unsigned int width, unsigned int height, unsig
         return false;
     }
 
+    if (samples > 0)
+    {
+        // Create the frame buffer into which the samples are resolved
+        GLuint resolveFrameBuffer = 0;
+        glCheck(glGenFramebuffersEXT(1, &resolveFrameBuffer));
+        m_resolveFrameBuffer = static_cast<unsigned int>(resolveFrameBuffer);
+        if (!m_resolveFrameBuffer)
+        {
+            err() << "Impossible to create render texture (failed to create the resolve frame buffer object)" << std::endl;
+            return false;
+        }
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_resolveFrameBuffer));
+        glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, attachment, GL_TEXTURE_2D, textureId, 0));
+        if (m_depthTarget)
+        {
+            glCheck(glDrawBuffer(GL_NONE));
+            glCheck(glReadBuffer(GL_NONE));
+        }
+        bool complete = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT;
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_frameBuffer));
+        if (!complete)
+        {
+            err() << "Impossible to create render texture (failed to link the target texture to the resolve frame buffer)" << std::endl;
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -131,16 +261,50 @@ bool RenderTextureImplFBO::create(unsigned int width, unsigned int height, unsig
 ////////////////////////////////////////////////////////////
 bool RenderTextureImplFBO::activate(bool active)
 {
-    return m_context->setActive(active);
+    if (!m_sharedContext)
+        return m_context->setActive(active);
+
+    if (!m_sharedContext->context.setActive(active))
+        return false;
+
+    // Bind our frame buffer if another render texture was using the context
+    if (active && (m_sharedContext->frameBuffer != m_frameBuffer))
+    {
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_frameBuffer));
+        m_sharedContext->frameBuffer = m_frameBuffer;
+        m_statesChanged = true;
+    }
+
+    return true;
 }
 
 
 ////////////////////////////////////////////////////////////
 void RenderTextureImplFBO::updateTexture(unsigned int)
 {
+    // Resolve the samples of the multisampled buffer into the texture
+    if (m_resolveFrameBuffer)
+    {
+        glCheck(glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, m_frameBuffer));
+        glCheck(glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, m_resolveFrameBuffer));
+        GLbitfield mask = m_depthTarget ? GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT;
+        glCheck(glBlitFramebufferEXT(0, 0, m_width, m_height, 0, 0, m_width, m_height, mask, GL_NEAREST));
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_frameBuffer));
+    }
+
     glFlush();
 }
 
+
+////////////////////////////////////////////////////////////
+bool RenderTextureImplFBO::contextStatesChanged()
+{
+    bool changed = m_statesChanged;
+    m_statesChanged = false;
+
+    return changed;
+}
+
 } // namespace priv
 
 } // namespace sf
@@ -31,12 +31,32 @@
 #include <SFML/Graphics/RenderTextureImpl.hpp>
 #include <SFML/Window/Context.hpp>
 #include <SFML/Window/GlResource.hpp>
+#include <cstddef>
 
 
 namespace sf
 {
 namespace priv
 {
+////////////////////////////////////////////////////////////
+/// \brief OpenGL context shared by several FBO render textures
+///
+////////////////////////////////////////////////////////////
+struct RenderTextureContext
+{
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderTextureContext() :
+    frameBuffer(0)
+    {
+    }
+
+    Context      context;     ///< Context in which all the frame buffers live
+    unsigned int frameBuffer; ///< Frame buffer currently bound in the context
+};
+
 ////////////////////////////////////////////////////////////
 /// \brief Specialization of RenderTextureImpl using the
 ///        FrameBuffer Object OpenGL extension
@@ -49,8 +69,14 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
+    /// If \a sharedContext is NULL, the render texture creates
+    /// its own OpenGL context. Otherwise its frame buffer is
+    /// created in the given context, which must outlive it.
+    ///
+    /// \param sharedContext Context to share with other render textures
+    ///
     ////////////////////////////////////////////////////////////
-    RenderTextureImplFBO();
+    RenderTextureImplFBO(RenderTextureContext* sharedContext = NULL);
 
     ////////////////////////////////////////////////////////////
     /// \brief Destructor
@@ -71,15 +97,16 @@ private :
     ////////////////////////////////////////////////////////////
     /// \brief Create the render texture implementation
     ///
-    /// \param width       Width of the texture to render to
-    /// \param height      Height of the texture to render to
-    /// \param textureId   OpenGL identifier of the target texture
-    /// \param depthBuffer Is a depth buffer requested?
+    /// \param width     Width of the texture to render to
+    /// \param height    Height of the texture to render to
+    /// \param textureId OpenGL identifier of the target texture
+    /// \param format    Pixel format of the target texture
+    /// \param settings  Requested depth buffer and antialiasing level
     ///
     /// \return True if creation has been successful
     ///
     ////////////////////////////////////////////////////////////
-    virtual bool create(unsigned int width, unsigned int height, unsigned int textureId, bool depthBuffer);
+    virtual bool create(unsigned int width, unsigned int height, unsigned int textureId, Texture::PixelFormat format, const ContextSettings& settings);
 
     ////////////////////////////////////////////////////////////
     /// \brief Activate or deactivate the render texture for rendering
@@ -99,12 +126,28 @@ private :
     ////////////////////////////////////////////////////////////
     virtual void updateTexture(unsigned textureId);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the states of the OpenGL context may
+    ///        have been changed since the last activation
+    ///
+    /// \return True if the OpenGL states must be set again
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool contextStatesChanged();
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Context*     m_context;     ///< Needs a separate OpenGL context for not messing up the other ones
-    unsigned int m_frameBuffer; ///< OpenGL frame buffer object
-    unsigned int m_depthBuffer; ///< Optional depth buffer attached to the frame buffer
+    Context*              m_context;            ///< Needs a separate OpenGL context for not messing up the other ones
+    RenderTextureContext* m_sharedContext;      ///< Context shared with other render textures, if any
+    unsigned int          m_frameBuffer;        ///< OpenGL frame buffer object
+    unsigned int          m_depthBuffer;        ///< Optional depth buffer attached to the frame buffer
+    unsigned int          m_sampleBuffer;       ///< Multisampled buffer attached to the frame buffer in place of the texture, if antialiasing is enabled
+    unsigned int          m_resolveFrameBuffer; ///< Frame buffer object of the target texture, if antialiasing is enabled
+    unsigned int          m_width;              ///< Width of the render texture
+    unsigned int          m_height;             ///< Height of the render texture
+    bool                  m_depthTarget;        ///< Is the target texture a depth texture?
+    bool                  m_statesChanged;      ///< Has another render texture used the shared context since our last activation?
 };
 
 } // namespace priv
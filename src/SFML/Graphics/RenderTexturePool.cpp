@@ -0,0 +1,210 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/RenderTexturePool.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/RenderTextureImplFBO.hpp>
+#include <SFML/System/Err.hpp>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+RenderTexturePool::Statistics::Statistics() :
+acquired (0),
+reused   (0),
+created  (0),
+destroyed(0),
+available(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+RenderTexturePool::RenderTexturePool(Shader* shader) :
+m_shader        (shader),
+m_context       (NULL),
+m_entries       (),
+m_frame         (0),
+m_maxIdleFrames (2),
+m_statistics    (),
+m_lastStatistics()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+RenderTexturePool::~RenderTexturePool()
+{
+    // The render textures must be destroyed before the context that holds their frame buffers
+    for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        delete it->texture;
+
+    delete m_context;
+}
+
+
+////////////////////////////////////////////////////////////
+RenderTexture* RenderTexturePool::acquire(unsigned int width, unsigned int height, bool depthBuffer, Texture::PixelFormat format)
+{
+    // Reuse a released render texture with the same properties, if any
+    for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (!it->used && (it->width == width) && (it->height == height) && (it->depthBuffer == depthBuffer) && (it->format == format))
+        {
+            it->used = true;
+            it->lastFrame = m_frame;
+
+            // Restore the default settings, which the previous user may have changed
+            RenderTexture& texture = *it->texture;
+            texture.setView(texture.getDefaultView());
+            texture.setSmooth(false);
+            texture.setRepeated(false);
+
+            m_statistics.acquired++;
+            m_statistics.reused++;
+            return &texture;
+        }
+    }
+
+    // Create the shared context on first use, if the render textures can share one
+    if (!m_context && priv::RenderTextureImplFBO::isAvailable())
+        m_context = new priv::RenderTextureContext;
+
+    // None available: create a new one
+    RenderTexture* texture = new RenderTexture;
+    if (!texture->create(width, height, m_shader, ContextSettings(depthBuffer ? 32 : 0), format, m_context))
+    {
+        delete texture;
+        return NULL;
+    }
+
+    Entry entry;
+    entry.texture     = texture;
+    entry.width       = width;
+    entry.height      = height;
+    entry.depthBuffer = depthBuffer;
+    entry.format      = format;
+    entry.used        = true;
+    entry.lastFrame   = m_frame;
+    m_entries.push_back(entry);
+
+    m_statistics.acquired++;
+    m_statistics.created++;
+    return texture;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTexturePool::release(RenderTexture& texture)
+{
+    for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->texture == &texture)
+        {
+            if (!it->used)
+                err() << "Render texture released twice to the pool" << std::endl;
+
+            // Draw what's left, so that the next user starts with an empty batch
+            texture.flush();
+            it->used = false;
+            return;
+        }
+    }
+
+    err() << "Cannot release a render texture which doesn't belong to the pool" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTexturePool::nextFrame()
+{
+    // Frames in which a render texture was not acquired, including the one that ends
+    evict(static_cast<Uint64>(m_maxIdleFrames) + 1);
+
+    m_statistics.available = 0;
+    for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (!it->used)
+            m_statistics.available++;
+    }
+
+    m_lastStatistics = m_statistics;
+    m_statistics = Statistics();
+    m_frame++;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTexturePool::setMaxIdleFrames(unsigned int frames)
+{
+    m_maxIdleFrames = frames;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int RenderTexturePool::getMaxIdleFrames() const
+{
+    return m_maxIdleFrames;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTexturePool::clear()
+{
+    evict(0);
+}
+
+
+////////////////////////////////////////////////////////////
+const RenderTexturePool::Statistics& RenderTexturePool::getStatistics() const
+{
+    return m_lastStatistics;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTexturePool::evict(Uint64 idleFrames)
+{
+    std::vector<Entry>::iterator end = m_entries.begin();
+    for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (!it->used && (m_frame - it->lastFrame >= idleFrames))
+        {
+            delete it->texture;
+            m_statistics.destroyed++;
+        }
+        else
+        {
+            *end++ = *it;
+        }
+    }
+    m_entries.erase(end, m_entries.end());
+}
+
+} // namespace sf
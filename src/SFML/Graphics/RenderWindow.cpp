@@ -83,8 +83,11 @@ Vector2u RenderWindow::getSize() const
 
 
 ////////////////////////////////////////////////////////////
-Image RenderWindow::capture() const
+Image RenderWindow::capture()
 {
+    // The pending batch must be in the back buffer before it is read
+    onCapture();
+
     Image image;
     if (setActive())
     {
@@ -114,6 +117,24 @@ void RenderWindow::onCreate()
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderWindow::onDisplay()
+{
+    // Draw the pending batch before swapping the buffers
+    flush();
+
+    finishFrame();
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderWindow::onCapture()
+{
+    // Draw the pending batch before the back buffer is read
+    flush();
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderWindow::onResize()
 {
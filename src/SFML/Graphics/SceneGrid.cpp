@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SceneGrid.hpp>
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+    // Maximum number of cells in which a node is registered; larger nodes are always returned
+    const int maxCellsPerNode = 64;
+
+    // Build the key of a cell from its coordinates
+    sf::Uint64 makeKey(int x, int y)
+    {
+        return (static_cast<sf::Uint64>(static_cast<sf::Uint32>(x)) << 32) | static_cast<sf::Uint32>(y);
+    }
+
+    // Remove the first occurrence of a node from a list, without preserving the order
+    void removeNode(std::vector<const sf::SceneNode*>& nodes, const sf::SceneNode* node)
+    {
+        std::vector<const sf::SceneNode*>::iterator it = std::find(nodes.begin(), nodes.end(), node);
+        if (it != nodes.end())
+        {
+            *it = nodes.back();
+            nodes.pop_back();
+        }
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+SceneGrid::SceneGrid(float cellSize) :
+m_cellSize (cellSize),
+m_cells    (),
+m_unbounded()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+IntRect SceneGrid::insert(const SceneNode* node, const FloatRect& bounds)
+{
+    // Nodes without bounds can't be located, and large nodes would fill too many cells
+    IntRect cells = getCells(bounds);
+    if ((bounds.width <= 0) || (bounds.height <= 0) || (static_cast<double>(cells.width) * cells.height > maxCellsPerNode))
+    {
+        m_unbounded.push_back(node);
+        return IntRect();
+    }
+
+    for (int x = cells.left; x < cells.left + cells.width; ++x)
+        for (int y = cells.top; y < cells.top + cells.height; ++y)
+            m_cells[makeKey(x, y)].push_back(node);
+
+    return cells;
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneGrid::remove(const SceneNode* node, const IntRect& cells)
+{
+    if ((cells.width == 0) || (cells.height == 0))
+    {
+        removeNode(m_unbounded, node);
+        return;
+    }
+
+    for (int x = cells.left; x < cells.left + cells.width; ++x)
+    {
+        for (int y = cells.top; y < cells.top + cells.height; ++y)
+        {
+            CellMap::iterator it = m_cells.find(makeKey(x, y));
+            if (it != m_cells.end())
+            {
+                removeNode(it->second, node);
+                if (it->second.empty())
+                    m_cells.erase(it);
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneGrid::query(const FloatRect& area, std::vector<const SceneNode*>& nodes) const
+{
+    nodes.insert(nodes.end(), m_unbounded.begin(), m_unbounded.end());
+
+    // Visit the cells overlapped by the area, or the stored cells if there are fewer of them
+    IntRect cells = getCells(area);
+    if (static_cast<double>(cells.width) * cells.height <= m_cells.size())
+    {
+        for (int x = cells.left; x < cells.left + cells.width; ++x)
+        {
+            for (int y = cells.top; y < cells.top + cells.height; ++y)
+            {
+                CellMap::const_iterator it = m_cells.find(makeKey(x, y));
+                if (it != m_cells.end())
+                    nodes.insert(nodes.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+    else
+    {
+        for (CellMap::const_iterator it = m_cells.begin(); it != m_cells.end(); ++it)
+        {
+            int x = static_cast<Int32>(static_cast<Uint32>(it->first >> 32));
+            int y = static_cast<Int32>(static_cast<Uint32>(it->first));
+            if (cells.contains(x, y))
+                nodes.insert(nodes.end(), it->second.begin(), it->second.end());
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+IntRect SceneGrid::getCells(const FloatRect& rect) const
+{
+    // Clamp the coordinates so that huge rectangles don't overflow
+    const float limit = 1 << 28;
+    float left   = std::max(-limit, std::min(limit, std::floor(rect.left / m_cellSize)));
+    float top    = std::max(-limit, std::min(limit, std::floor(rect.top / m_cellSize)));
+    float right  = std::max(-limit, std::min(limit, std::floor((rect.left + rect.width) / m_cellSize)));
+    float bottom = std::max(-limit, std::min(limit, std::floor((rect.top + rect.height) / m_cellSize)));
+
+    return IntRect(static_cast<int>(left), static_cast<int>(top),
+                   static_cast<int>(right - left) + 1, static_cast<int>(bottom - top) + 1);
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_SCENEGRID_HPP
+#define SFML_SCENEGRID_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Config.hpp>
+#include <map>
+#include <vector>
+
+
+namespace sf
+{
+class SceneNode;
+
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Spatial index of the nodes of a scene
+///
+/// The scene is divided into square cells of a fixed size,
+/// and each node is registered in all the cells that its
+/// bounding rectangle overlaps. Only the cells that contain
+/// nodes are stored. Nodes which have no bounds, or which
+/// cover too many cells, are kept in a separate list and
+/// returned by every query.
+///
+////////////////////////////////////////////////////////////
+class SceneGrid
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the grid with the size of its cells
+    ///
+    /// \param cellSize Size of the cells
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit SceneGrid(float cellSize);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Register a node in the grid
+    ///
+    /// \param node   Node to register
+    /// \param bounds Bounding rectangle of the node
+    ///
+    /// \return Range of cells in which the node was registered, to pass to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    IntRect insert(const SceneNode* node, const FloatRect& bounds);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unregister a node from the grid
+    ///
+    /// \param node  Node to unregister
+    /// \param cells Range of cells returned by insert
+    ///
+    ////////////////////////////////////////////////////////////
+    void remove(const SceneNode* node, const IntRect& cells);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Collect the nodes which may overlap an area
+    ///
+    /// The nodes registered in several cells may be returned
+    /// several times, and the nodes are not tested against
+    /// the area: only their cells are.
+    ///
+    /// \param area  Area to query
+    /// \param nodes Vector to which the nodes are appended
+    ///
+    ////////////////////////////////////////////////////////////
+    void query(const FloatRect& area, std::vector<const SceneNode*>& nodes) const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the range of cells overlapped by a rectangle
+    ///
+    /// \param rect Rectangle
+    ///
+    /// \return Range of cells, as (first column, first row, columns, rows)
+    ///
+    ////////////////////////////////////////////////////////////
+    IntRect getCells(const FloatRect& rect) const;
+
+    ////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////
+    typedef std::vector<const SceneNode*> NodeList;
+    typedef std::map<Uint64, NodeList> CellMap;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    float    m_cellSize;   ///< Size of the cells
+    CellMap  m_cells;      ///< Nodes registered in each cell, indexed by cell coordinates
+    NodeList m_unbounded;  ///< Nodes without bounds, or too large to be registered in cells
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_SCENEGRID_HPP
@@ -0,0 +1,468 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SceneNode.hpp>
+#include <SFML/Graphics/SceneGrid.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <functional>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+SceneNode::SceneNode() :
+m_parent                  (NULL),
+m_children                (),
+m_sceneTransform          (),
+m_sceneTransformNeedUpdate(true),
+m_boundsNeedUpdate        (false),
+m_registered              (false),
+m_sceneBounds             (),
+m_cells                   (),
+m_order                   (0),
+m_sortTexture             (NULL),
+m_grid                    (NULL),
+m_dirtyNodes              (),
+m_visibleNodes            (),
+m_orderNeedUpdate         (true),
+m_sortByTexture           (false),
+m_cellSize                (256.f)
+{
+    // The node is the root of its own scene
+    addToScene(*this);
+}
+
+
+////////////////////////////////////////////////////////////
+SceneNode::~SceneNode()
+{
+    if (m_parent)
+        m_parent->detachChild(*this);
+
+    while (!m_children.empty())
+        detachChild(*m_children.back());
+
+    delete m_grid;
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::attachChild(SceneNode& child)
+{
+    // Already attached: nothing to do
+    if (child.m_parent == this)
+        return;
+
+    // Make sure that we don't create a cycle
+    for (const SceneNode* node = this; node; node = node->m_parent)
+    {
+        if (node == &child)
+        {
+            err() << "Failed to attach scene node (a node can't be attached to itself or to its descendants)" << std::endl;
+            return;
+        }
+    }
+
+    // Remove the child from its current scene
+    SceneNode& oldRoot = child.getRoot();
+    child.removeFromScene(oldRoot);
+    if (child.m_parent)
+    {
+        std::vector<SceneNode*>& siblings = child.m_parent->m_children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), &child));
+        oldRoot.m_orderNeedUpdate = true;
+    }
+    else
+    {
+        // The child was a root: its index is no longer used
+        delete child.m_grid;
+        child.m_grid = NULL;
+    }
+
+    // Add it to ours
+    child.m_parent = this;
+    m_children.push_back(&child);
+
+    SceneNode& root = getRoot();
+    root.m_orderNeedUpdate = true;
+    child.addToScene(root);
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::detachChild(SceneNode& child)
+{
+    if (child.m_parent != this)
+        return;
+
+    // Remove the child from our scene
+    SceneNode& root = getRoot();
+    child.removeFromScene(root);
+    m_children.erase(std::find(m_children.begin(), m_children.end(), &child));
+    root.m_orderNeedUpdate = true;
+
+    // It becomes the root of its own scene
+    child.m_parent = NULL;
+    child.m_orderNeedUpdate = true;
+    child.addToScene(child);
+}
+
+
+////////////////////////////////////////////////////////////
+SceneNode* SceneNode::getParent() const
+{
+    return m_parent;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SceneNode::getChildCount() const
+{
+    return m_children.size();
+}
+
+
+////////////////////////////////////////////////////////////
+SceneNode& SceneNode::getChild(std::size_t index) const
+{
+    return *m_children[index];
+}
+
+
+////////////////////////////////////////////////////////////
+Transform SceneNode::getWorldTransform() const
+{
+    return getRoot().getTransform() * getSceneTransform();
+}
+
+
+////////////////////////////////////////////////////////////
+FloatRect SceneNode::getLocalBounds() const
+{
+    return FloatRect();
+}
+
+
+////////////////////////////////////////////////////////////
+FloatRect SceneNode::getGlobalBounds() const
+{
+    return getWorldTransform().transformRect(getLocalBounds());
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::setSortByTexture(bool sort)
+{
+    m_sortByTexture = sort;
+}
+
+
+////////////////////////////////////////////////////////////
+bool SceneNode::isSortedByTexture() const
+{
+    return m_sortByTexture;
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::setCellSize(float size)
+{
+    if ((size > 0) && (size != m_cellSize))
+    {
+        m_cellSize = size;
+
+        // Rebuild the index of the scene with the new cells
+        if (!m_parent)
+        {
+            removeFromScene(*this);
+            delete m_grid;
+            m_grid = NULL;
+            addToScene(*this);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+float SceneNode::getCellSize() const
+{
+    return m_cellSize;
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::drawCurrent(RenderTarget&, RenderStates) const
+{
+    // Nothing by default
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture* SceneNode::getTexture() const
+{
+    return NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::invalidateBounds()
+{
+    if (!m_boundsNeedUpdate)
+    {
+        m_boundsNeedUpdate = true;
+        getRoot().m_dirtyNodes.push_back(this);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::onTransformChange()
+{
+    // The transform of the root is not part of the scene transforms
+    if (m_parent)
+        invalidate(getRoot());
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::draw(RenderTarget& target, RenderStates states) const
+{
+    // A node which is not a root draws its subtree at its position in the world
+    if (m_parent)
+    {
+        states.transform *= m_parent->getWorldTransform();
+        drawSubtree(target, states);
+        return;
+    }
+
+    updateScene();
+
+    // Compute the area of the scene covered by the view
+    states.transform *= getTransform();
+    const View& view = target.getView();
+    FloatRect area = view.getInverseTransform().transformRect(FloatRect(-1, -1, 2, 2));
+    area = states.transform.getInverse().transformRect(area);
+
+    // Collect the nodes which overlap it; the nodes without bounds are always drawn
+    m_visibleNodes.clear();
+    m_grid->query(area, m_visibleNodes);
+    std::sort(m_visibleNodes.begin(), m_visibleNodes.end());
+    m_visibleNodes.erase(std::unique(m_visibleNodes.begin(), m_visibleNodes.end()), m_visibleNodes.end());
+
+    std::vector<const SceneNode*>::iterator end = m_visibleNodes.begin();
+    for (std::vector<const SceneNode*>::const_iterator it = m_visibleNodes.begin(); it != m_visibleNodes.end(); ++it)
+    {
+        const FloatRect& bounds = (*it)->m_sceneBounds;
+        if ((bounds.width <= 0) || (bounds.height <= 0) || bounds.intersects(area))
+            *end++ = *it;
+    }
+    m_visibleNodes.erase(end, m_visibleNodes.end());
+
+    // Put them in draw order
+    if (m_sortByTexture)
+    {
+        for (std::vector<const SceneNode*>::const_iterator it = m_visibleNodes.begin(); it != m_visibleNodes.end(); ++it)
+            (*it)->m_sortTexture = (*it)->getTexture();
+        std::sort(m_visibleNodes.begin(), m_visibleNodes.end(), &SceneNode::compareTexture);
+    }
+    else
+    {
+        std::sort(m_visibleNodes.begin(), m_visibleNodes.end(), &SceneNode::compareOrder);
+    }
+
+    // Draw them
+    for (std::vector<const SceneNode*>::const_iterator it = m_visibleNodes.begin(); it != m_visibleNodes.end(); ++it)
+    {
+        RenderStates nodeStates(states);
+        nodeStates.transform *= (*it)->getSceneTransform();
+        (*it)->drawCurrent(target, nodeStates);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::drawSubtree(RenderTarget& target, RenderStates states) const
+{
+    states.transform *= getTransform();
+    drawCurrent(target, states);
+
+    for (std::vector<SceneNode*>::const_iterator it = m_children.begin(); it != m_children.end(); ++it)
+        (*it)->drawSubtree(target, states);
+}
+
+
+////////////////////////////////////////////////////////////
+SceneNode& SceneNode::getRoot() const
+{
+    const SceneNode* node = this;
+    while (node->m_parent)
+        node = node->m_parent;
+
+    return *const_cast<SceneNode*>(node);
+}
+
+
+////////////////////////////////////////////////////////////
+const Transform& SceneNode::getSceneTransform() const
+{
+    // Recompute the scene transform if needed
+    if (m_sceneTransformNeedUpdate)
+    {
+        if (m_parent)
+            m_sceneTransform = m_parent->getSceneTransform() * getTransform();
+        else
+            m_sceneTransform = Transform::Identity;
+        m_sceneTransformNeedUpdate = false;
+    }
+
+    return m_sceneTransform;
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::invalidate(SceneNode& root)
+{
+    m_sceneTransformNeedUpdate = true;
+    if (!m_boundsNeedUpdate)
+    {
+        m_boundsNeedUpdate = true;
+        root.m_dirtyNodes.push_back(this);
+    }
+
+    // If a child is already invalid, so are its descendants
+    for (std::vector<SceneNode*>::iterator it = m_children.begin(); it != m_children.end(); ++it)
+    {
+        if (!(*it)->m_sceneTransformNeedUpdate)
+            (*it)->invalidate(root);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::addToScene(SceneNode& root)
+{
+    m_sceneTransformNeedUpdate = true;
+    m_boundsNeedUpdate = true;
+    root.m_dirtyNodes.push_back(this);
+
+    for (std::vector<SceneNode*>::iterator it = m_children.begin(); it != m_children.end(); ++it)
+        (*it)->addToScene(root);
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::removeFromScene(SceneNode& root)
+{
+    // Unregister the subtree, which also clears the flags of its dirty nodes
+    unregister(root);
+
+    // Remove these nodes from the list of dirty nodes of the scene
+    std::vector<SceneNode*>::iterator end = root.m_dirtyNodes.begin();
+    for (std::vector<SceneNode*>::iterator it = root.m_dirtyNodes.begin(); it != root.m_dirtyNodes.end(); ++it)
+    {
+        if ((*it)->m_boundsNeedUpdate)
+            *end++ = *it;
+    }
+    root.m_dirtyNodes.erase(end, root.m_dirtyNodes.end());
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::unregister(SceneNode& root)
+{
+    if (m_registered)
+    {
+        root.m_grid->remove(this, m_cells);
+        m_registered = false;
+    }
+    m_boundsNeedUpdate = false;
+
+    for (std::vector<SceneNode*>::iterator it = m_children.begin(); it != m_children.end(); ++it)
+        (*it)->unregister(root);
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::updateScene() const
+{
+    if (!m_grid)
+        m_grid = new priv::SceneGrid(m_cellSize);
+
+    // Relocate the nodes whose bounds changed
+    for (std::vector<SceneNode*>::const_iterator it = m_dirtyNodes.begin(); it != m_dirtyNodes.end(); ++it)
+    {
+        SceneNode& node = **it;
+        if (node.m_registered)
+            m_grid->remove(&node, node.m_cells);
+
+        node.m_sceneBounds      = node.getSceneTransform().transformRect(node.getLocalBounds());
+        node.m_cells            = m_grid->insert(&node, node.m_sceneBounds);
+        node.m_registered       = true;
+        node.m_boundsNeedUpdate = false;
+    }
+    m_dirtyNodes.clear();
+
+    // Number the nodes in draw order if the hierarchy changed
+    if (m_orderNeedUpdate)
+    {
+        std::size_t order = 0;
+        updateOrder(order);
+        m_orderNeedUpdate = false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SceneNode::updateOrder(std::size_t& order) const
+{
+    m_order = order++;
+
+    for (std::vector<SceneNode*>::const_iterator it = m_children.begin(); it != m_children.end(); ++it)
+        (*it)->updateOrder(order);
+}
+
+
+////////////////////////////////////////////////////////////
+bool SceneNode::compareOrder(const SceneNode* left, const SceneNode* right)
+{
+    return left->m_order < right->m_order;
+}
+
+
+////////////////////////////////////////////////////////////
+bool SceneNode::compareTexture(const SceneNode* left, const SceneNode* right)
+{
+    if (left->m_sortTexture != right->m_sortTexture)
+        return std::less<const Texture*>()(left->m_sortTexture, right->m_sortTexture);
+
+    return left->m_order < right->m_order;
+}
+
+} // namespace sf
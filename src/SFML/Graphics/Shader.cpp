@@ -27,14 +27,45 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/UniformBlock.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
 #include <SFML/System/InputStream.hpp>
 #include <SFML/System/Err.hpp>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
 
+namespace
+{
+    // Hash a parameter name (FNV-1a)
+    sf::Uint32 hashName(const std::string& name)
+    {
+        sf::Uint32 hash = 2166136261u;
+        for (std::string::const_iterator it = name.begin(); it != name.end(); ++it)
+        {
+            hash ^= static_cast<unsigned char>(*it);
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+
+    // Insert a handle in a hash table whose size is a power of two
+    void insertHandle(std::vector<int>& buckets, sf::Uint32 hash, int handle)
+    {
+        std::size_t mask = buckets.size() - 1;
+        std::size_t i = hash & mask;
+        while (buckets[i] != -1)
+            i = (i + 1) & mask;
+
+        buckets[i] = handle;
+    }
+}
+
+
 namespace sf
 {
 ////////////////////////////////////////////////////////////
@@ -44,7 +75,9 @@ Shader::CurrentTextureType Shader::CurrentTexture;
 ////////////////////////////////////////////////////////////
 Shader::Shader() :
 m_shaderProgram (0),
-m_currentTexture(-1)
+m_currentTexture(-1),
+m_uniformsDirty (false),
+m_batchTarget   (NULL)
 {
 }
 
@@ -52,6 +85,9 @@ m_currentTexture(-1)
 ////////////////////////////////////////////////////////////
 Shader::~Shader()
 {
+    // Draw the pending batch that uses the shader while it still exists
+    flushPendingBatch();
+
     ensureGlContext();
 
     // Destroy effect program
@@ -147,8 +183,10 @@ bool Shader::loadFromMemory(const std::string& shader, Type type)
 ////////////////////////////////////////////////////////////
 bool Shader::loadFromMemory(const std::string& vertexShader, const std::string& geometryShader, const std::string& fragmentShader)
 {
-    // Compile the shader program
-    return compile(vertexShader.c_str(), geometryShader.c_str(), fragmentShader.c_str());
+    // Compile the shader program, empty sources are not part of it
+    return compile(vertexShader.empty()   ? NULL : vertexShader.c_str(),
+                   geometryShader.empty() ? NULL : geometryShader.c_str(),
+                   fragmentShader.empty() ? NULL : fragmentShader.c_str());
 }
 
 
@@ -210,21 +248,11 @@ void Shader::setParameter(const std::string& name, float x)
 {
     if (m_shaderProgram)
     {
-        ensureGlContext();
-
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
-            glCheck(glUniform1fARB(location, x));
+        UniformHandle handle = getUniformHandle(name);
+        if (handle != -1)
+            setParameter(handle, x);
         else
             err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
-
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
     }
 }
 
@@ -234,21 +262,11 @@ void Shader::setParameter(const std::string& name, float x, float y)
 {
     if (m_shaderProgram)
     {
-        ensureGlContext();
-
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
-            glCheck(glUniform2fARB(location, x, y));
+        UniformHandle handle = getUniformHandle(name);
+        if (handle != -1)
+            setParameter(handle, x, y);
         else
             err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
-
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
     }
 }
 
@@ -258,21 +276,11 @@ void Shader::setParameter(const std::string& name, float x, float y, float z)
 {
     if (m_shaderProgram)
     {
-        ensureGlContext();
-
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
-            glCheck(glUniform3fARB(location, x, y, z));
+        UniformHandle handle = getUniformHandle(name);
+        if (handle != -1)
+            setParameter(handle, x, y, z);
         else
             err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
-
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
     }
 }
 
@@ -282,21 +290,11 @@ void Shader::setParameter(const std::string& name, float x, float y, float z, fl
 {
     if (m_shaderProgram)
     {
-        ensureGlContext();
-
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
-            glCheck(glUniform4fARB(location, x, y, z, w));
+        UniformHandle handle = getUniformHandle(name);
+        if (handle != -1)
+            setParameter(handle, x, y, z, w);
         else
             err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
-
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
     }
 }
 
@@ -327,21 +325,11 @@ void Shader::setParameter(const std::string& name, const sf::Transform& transfor
 {
     if (m_shaderProgram)
     {
-        ensureGlContext();
-
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
-            glCheck(glUniformMatrix4fvARB(location, 1, GL_FALSE, transform.getMatrix()));
+        UniformHandle handle = getUniformHandle(name);
+        if (handle != -1)
+            setParameter(handle, transform);
         else
             err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
-
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
     }
 }
 
@@ -351,21 +339,24 @@ void Shader::setParameter(const std::string& name, const Texture& texture)
 {
     if (m_shaderProgram)
     {
-        ensureGlContext();
-
         // Find the location of the variable in the shader
-        int location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location == -1)
+        UniformHandle handle = getUniformHandle(name);
+        if (handle == -1)
         {
             err() << "Texture \"" << name << "\" not found in shader" << std::endl;
             return;
         }
+        int location = m_uniforms[handle].location;
+
+        // Draws already batched with the shader must keep the previous texture
+        flushPendingBatch();
 
         // Store the location -> texture mapping
         TextureTable::iterator it = m_textures.find(location);
         if (it == m_textures.end())
         {
             // New entry, make sure there are enough texture units
+            ensureGlContext();
             static const GLint maxUnits = getMaxTextureUnits();
             if (m_textures.size() + 1 >= static_cast<std::size_t>(maxUnits))
             {
@@ -389,16 +380,112 @@ void Shader::setParameter(const std::string& name, CurrentTextureType)
 {
     if (m_shaderProgram)
     {
-        ensureGlContext();
-
         // Find the location of the variable in the shader
-        m_currentTexture = glGetUniformLocationARB(m_shaderProgram, name.c_str());
+        UniformHandle handle = getUniformHandle(name);
+        flushPendingBatch();
+        m_currentTexture = (handle != -1) ? m_uniforms[handle].location : -1;
         if (m_currentTexture == -1)
             err() << "Texture \"" << name << "\" not found in shader" << std::endl;
     }
 }
 
 
+////////////////////////////////////////////////////////////
+Shader::UniformHandle Shader::getUniformHandle(const std::string& name) const
+{
+    if (!m_shaderProgram)
+        return -1;
+
+    // Look for the name in the hash table
+    Uint32 hash = hashName(name);
+    if (!m_uniformBuckets.empty())
+    {
+        std::size_t mask = m_uniformBuckets.size() - 1;
+        for (std::size_t i = hash & mask; m_uniformBuckets[i] != -1; i = (i + 1) & mask)
+        {
+            const Uniform& uniform = m_uniforms[m_uniformBuckets[i]];
+            if ((uniform.hash == hash) && (uniform.name == name))
+                return (uniform.location != -1) ? m_uniformBuckets[i] : -1;
+        }
+    }
+
+    // Not found: it may be a name that is not enumerated by OpenGL (like an
+    // element of an array), ask for its location and remember the answer
+    ensureGlContext();
+    GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
+    UniformHandle handle = addUniform(name, location);
+
+    return (location != -1) ? handle : -1;
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(UniformHandle handle, float x)
+{
+    float values[] = {x};
+    stageUniform(handle, values, 1);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(UniformHandle handle, float x, float y)
+{
+    float values[] = {x, y};
+    stageUniform(handle, values, 2);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(UniformHandle handle, float x, float y, float z)
+{
+    float values[] = {x, y, z};
+    stageUniform(handle, values, 3);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(UniformHandle handle, float x, float y, float z, float w)
+{
+    float values[] = {x, y, z, w};
+    stageUniform(handle, values, 4);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(UniformHandle handle, const Vector2f& v)
+{
+    setParameter(handle, v.x, v.y);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(UniformHandle handle, const Vector3f& v)
+{
+    setParameter(handle, v.x, v.y, v.z);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(UniformHandle handle, const Color& color)
+{
+    setParameter(handle, color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(UniformHandle handle, const sf::Transform& transform)
+{
+    stageUniform(handle, transform.getMatrix(), 16);
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Shader::getNativeHandle() const
+{
+    return m_shaderProgram;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Shader::bind(const Shader* shader)
 {
@@ -409,6 +496,9 @@ void Shader::bind(const Shader* shader)
         // Enable the program
         glCheck(glUseProgramObjectARB(shader->m_shaderProgram));
 
+        // Upload the parameters that changed since the last bind
+        shader->uploadUniforms();
+
         // Bind the textures
         shader->bindTextures();
 
@@ -620,9 +710,193 @@ bool Shader::compile(const char* vertexShaderCode, const char* geometryShaderCod
         return false;
     }
 
+    // Resolve the locations of all the parameters once and for all
+    buildUniformTable();
 
+    // Connect the shared uniform blocks
+    bindUniformBlocks();
 
     return true;
 }
 
+
+////////////////////////////////////////////////////////////
+void Shader::buildUniformTable()
+{
+    m_uniforms.clear();
+    m_uniformBuckets.clear();
+    m_uniformsDirty = false;
+
+    // Get the number of active uniforms and the length of the longest name
+    GLint count = 0;
+    GLint maxLength = 0;
+    glCheck(glGetObjectParameterivARB(m_shaderProgram, GL_OBJECT_ACTIVE_UNIFORMS_ARB, &count));
+    glCheck(glGetObjectParameterivARB(m_shaderProgram, GL_OBJECT_ACTIVE_UNIFORM_MAX_LENGTH_ARB, &maxLength));
+    if ((count <= 0) || (maxLength <= 0))
+        return;
+
+    std::vector<GLcharARB> buffer(maxLength + 1);
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glCheck(glGetActiveUniformARB(m_shaderProgram, i, maxLength + 1, &length, &size, &type, &buffer[0]));
+        std::string name(&buffer[0], length);
+
+        // Arrays are reported with the name of their first element, register them by their name
+        std::string::size_type bracket = name.find("[0]");
+        if ((bracket != std::string::npos) && (bracket + 3 == name.size()))
+            name.erase(bracket);
+
+        // Built-in variables (gl_*) have no location
+        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
+        if (location != -1)
+            addUniform(name, location);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::bindUniformBlocks()
+{
+    if (!UniformBlock::isAvailable())
+        return;
+
+    // Get the number of active blocks and the length of the longest name
+    GLint count = 0;
+    GLint maxLength = 0;
+    glCheck(glGetProgramiv(m_shaderProgram, GL_ACTIVE_UNIFORM_BLOCKS, &count));
+    glCheck(glGetProgramiv(m_shaderProgram, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength));
+    if ((count <= 0) || (maxLength <= 0))
+        return;
+
+    GLint maxBindings = 0;
+    glCheck(glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindings));
+
+    std::vector<GLchar> buffer(maxLength + 1);
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        glCheck(glGetActiveUniformBlockName(m_shaderProgram, i, maxLength + 1, &length, &buffer[0]));
+        std::string name(&buffer[0], length);
+
+        unsigned int bindingPoint = UniformBlock::getBindingPoint(name);
+        if (bindingPoint < static_cast<unsigned int>(maxBindings))
+            glCheck(glUniformBlockBinding(m_shaderProgram, i, bindingPoint));
+        else
+            err() << "Uniform block \"" << name << "\" cannot be bound: the maximum number of uniform blocks ("
+                  << maxBindings << ") has been reached" << std::endl;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+Shader::UniformHandle Shader::addUniform(const std::string& name, int location) const
+{
+    Uniform uniform;
+    uniform.name     = name;
+    uniform.hash     = hashName(name);
+    uniform.location = location;
+    uniform.size     = 0;
+    uniform.dirty    = false;
+    m_uniforms.push_back(uniform);
+
+    UniformHandle handle = static_cast<UniformHandle>(m_uniforms.size() - 1);
+
+    // Keep the hash table at most half full, so that probe sequences stay short
+    if (m_uniforms.size() * 2 > m_uniformBuckets.size())
+    {
+        std::size_t bucketCount = m_uniformBuckets.empty() ? 16 : m_uniformBuckets.size() * 2;
+        m_uniformBuckets.assign(bucketCount, -1);
+        for (std::size_t i = 0; i < m_uniforms.size(); ++i)
+            insertHandle(m_uniformBuckets, m_uniforms[i].hash, static_cast<int>(i));
+    }
+    else
+    {
+        insertHandle(m_uniformBuckets, uniform.hash, handle);
+    }
+
+    return handle;
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::stageUniform(UniformHandle handle, const float* values, int size)
+{
+    if ((handle < 0) || (handle >= static_cast<UniformHandle>(m_uniforms.size())))
+        return;
+
+    Uniform& uniform = m_uniforms[handle];
+    if (uniform.location == -1)
+        return;
+
+    // Nothing to do if the value doesn't change
+    if ((uniform.size == size) && std::equal(values, values + size, uniform.values))
+        return;
+
+    // Draws already batched with the shader must keep the previous value
+    flushPendingBatch();
+
+    std::copy(values, values + size, uniform.values);
+    uniform.size = size;
+    uniform.dirty = true;
+    m_uniformsDirty = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::flushPendingBatch() const
+{
+    if (m_batchTarget)
+        m_batchTarget->flushBatch(RenderTarget::ShaderChange);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::uploadUniforms() const
+{
+    if (!m_uniformsDirty)
+        return;
+
+    for (UniformTable::iterator it = m_uniforms.begin(); it != m_uniforms.end(); ++it)
+    {
+        if (!it->dirty)
+            continue;
+
+        const float* v = it->values;
+        switch (it->size)
+        {
+            case 1 :  glCheck(glUniform1fARB(it->location, v[0]));                   break;
+            case 2 :  glCheck(glUniform2fARB(it->location, v[0], v[1]));             break;
+            case 3 :  glCheck(glUniform3fARB(it->location, v[0], v[1], v[2]));       break;
+            case 4 :  glCheck(glUniform4fARB(it->location, v[0], v[1], v[2], v[3])); break;
+            case 16 : glCheck(glUniformMatrix4fvARB(it->location, 1, GL_FALSE, v));  break;
+            default : break;
+        }
+
+        it->dirty = false;
+    }
+
+    m_uniformsDirty = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::bindTextures() const
+{
+    TextureTable::const_iterator it = m_textures.begin();
+    for (std::size_t i = 0; i < m_textures.size(); ++i)
+    {
+        GLint index = static_cast<GLsizei>(i + 1);
+        glCheck(glUniform1iARB(it->first, index));
+        glCheck(glActiveTextureARB(GL_TEXTURE0_ARB + index));
+        glCheck(glBindTexture(GL_TEXTURE_2D, it->second->m_texture));
+        ++it;
+    }
+
+    // Make sure that the texture unit which is left active is the number 0
+    glCheck(glActiveTextureARB(GL_TEXTURE0_ARB));
+}
+
 } // namespace sf
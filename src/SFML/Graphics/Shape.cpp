@@ -86,7 +86,7 @@ const Texture* Shape::getTexture() const
 void Shape::setTextureRect(const IntRect& rect)
 {
     m_textureRect = rect;
-    updateTexCoords();
+    m_texCoordsNeedUpdate = true;
 }
 
 
@@ -101,7 +101,7 @@ const IntRect& Shape::getTextureRect() const
 void Shape::setFillColor(const Color& color)
 {
     m_fillColor = color;
-    updateFillColors();
+    m_fillColorsNeedUpdate = true;
 }
 
 
@@ -116,7 +116,7 @@ const Color& Shape::getFillColor() const
 void Shape::setOutlineColor(const Color& color)
 {
     m_outlineColor = color;
-    updateOutlineColors();
+    m_outlineColorsNeedUpdate = true;
 }
 
 
@@ -131,7 +131,7 @@ const Color& Shape::getOutlineColor() const
 void Shape::setOutlineThickness(float thickness)
 {
     m_outlineThickness = thickness;
-    update(); // recompute everything because the whole shape must be offset
+    m_outlineNeedUpdate = true; // the fill is not affected, only the outline must be offset
 }
 
 
@@ -145,6 +145,8 @@ float Shape::getOutlineThickness() const
 ////////////////////////////////////////////////////////////
 FloatRect Shape::getLocalBounds() const
 {
+    ensureUpdate();
+
     return m_bounds;
 }
 
@@ -158,21 +160,98 @@ FloatRect Shape::getGlobalBounds() const
 
 ////////////////////////////////////////////////////////////
 Shape::Shape() :
-m_texture         (NULL),
-m_textureRect     (),
-m_fillColor       (255, 255, 255),
-m_outlineColor    (255, 255, 255),
-m_outlineThickness(0),
-m_vertices        (TrianglesFan),
-m_outlineVertices (TrianglesStrip),
-m_insideBounds    (),
-m_bounds          ()
+m_texture                (NULL),
+m_textureRect            (),
+m_fillColor              (255, 255, 255),
+m_outlineColor           (255, 255, 255),
+m_outlineThickness       (0),
+m_vertices               (TrianglesFan),
+m_outlineVertices        (TrianglesStrip),
+m_insideBounds           (),
+m_bounds                 (),
+m_geometryNeedUpdate     (true),
+m_fillColorsNeedUpdate   (true),
+m_texCoordsNeedUpdate    (true),
+m_outlineNeedUpdate      (true),
+m_outlineColorsNeedUpdate(true)
 {
 }
 
 
 ////////////////////////////////////////////////////////////
 void Shape::update()
+{
+    m_geometryNeedUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Shape::draw(RenderTarget& target, RenderStates states) const
+{
+    ensureUpdate();
+
+    states.transform *= getTransform();
+
+    // Render the inside
+    states.texture = m_texture;
+    target.draw(m_vertices, states);
+
+    // Render the outline
+    if (m_outlineThickness != 0)
+    {
+        states.texture = NULL;
+        target.draw(m_outlineVertices, states);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Shape::ensureUpdate() const
+{
+    // Derived classes may change their number of points without calling update
+    unsigned int count = getPointCount();
+    if (m_vertices.getVertexCount() != ((count < 3) ? 0 : count + 2))
+        m_geometryNeedUpdate = true;
+
+    // Everything depends on the position of the points
+    if (m_geometryNeedUpdate)
+    {
+        updateGeometry();
+        m_geometryNeedUpdate   = false;
+        m_fillColorsNeedUpdate = true;
+        m_texCoordsNeedUpdate  = true;
+        m_outlineNeedUpdate    = true;
+    }
+
+    if (m_fillColorsNeedUpdate)
+    {
+        updateFillColors();
+        m_fillColorsNeedUpdate = false;
+    }
+
+    if (m_texCoordsNeedUpdate)
+    {
+        updateTexCoords();
+        m_texCoordsNeedUpdate = false;
+    }
+
+    if (m_outlineNeedUpdate)
+    {
+        updateOutline();
+        m_outlineNeedUpdate       = false;
+        m_outlineColorsNeedUpdate = true;
+    }
+
+    if (m_outlineColorsNeedUpdate)
+    {
+        updateOutlineColors();
+        m_outlineColorsNeedUpdate = false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Shape::updateGeometry() const
 {
     // Get the total number of points of the shape
     unsigned int count = getPointCount();
@@ -197,38 +276,11 @@ void Shape::update()
     // Compute the center and make it the first vertex
     m_vertices[0].position.x = m_insideBounds.left + m_insideBounds.width / 2;
     m_vertices[0].position.y = m_insideBounds.top + m_insideBounds.height / 2;
-
-    // Color
-    updateFillColors();
-
-    // Texture coordinates
-    updateTexCoords();
-
-    // Outline
-    updateOutline();
-}
-
-
-////////////////////////////////////////////////////////////
-void Shape::draw(RenderTarget& target, RenderStates states) const
-{
-    states.transform *= getTransform();
-
-    // Render the inside
-    states.texture = m_texture;
-    target.draw(m_vertices, states);
-
-    // Render the outline
-    if (m_outlineThickness != 0)
-    {
-        states.texture = NULL;
-        target.draw(m_outlineVertices, states);
-    }
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shape::updateFillColors()
+void Shape::updateFillColors() const
 {
     for (unsigned int i = 0; i < m_vertices.getVertexCount(); ++i)
         m_vertices[i].color = m_fillColor;
@@ -236,7 +288,7 @@ void Shape::updateFillColors()
 
 
 ////////////////////////////////////////////////////////////
-void Shape::updateTexCoords()
+void Shape::updateTexCoords() const
 {
     for (unsigned int i = 0; i < m_vertices.getVertexCount(); ++i)
     {
@@ -249,8 +301,16 @@ void Shape::updateTexCoords()
 
 
 ////////////////////////////////////////////////////////////
-void Shape::updateOutline()
+void Shape::updateOutline() const
 {
+    // No fill: no outline
+    if (m_vertices.getVertexCount() < 3)
+    {
+        m_outlineVertices.resize(0);
+        m_bounds = FloatRect();
+        return;
+    }
+
     unsigned int count = m_vertices.getVertexCount() - 2;
     m_outlineVertices.resize((count + 1) * 2);
 
@@ -287,16 +347,13 @@ void Shape::updateOutline()
     m_outlineVertices[count * 2 + 0].position = m_outlineVertices[0].position;
     m_outlineVertices[count * 2 + 1].position = m_outlineVertices[1].position;
 
-    // Update outline colors
-    updateOutlineColors();
-
     // Update the shape's bounds
     m_bounds = m_outlineVertices.getBounds();
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shape::updateOutlineColors()
+void Shape::updateOutlineColors() const
 {
     for (unsigned int i = 0; i < m_outlineVertices.getVertexCount(); ++i)
         m_outlineVertices[i].color = m_outlineColor;
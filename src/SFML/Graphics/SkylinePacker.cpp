@@ -0,0 +1,210 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SkylinePacker.hpp>
+#include <algorithm>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+SkylinePacker::SkylinePacker(unsigned int width, unsigned int height) :
+m_skyline (),
+m_width   (0),
+m_height  (0),
+m_usedArea(0)
+{
+    reset(width, height);
+}
+
+
+////////////////////////////////////////////////////////////
+void SkylinePacker::reset(unsigned int width, unsigned int height)
+{
+    m_width    = width;
+    m_height   = height;
+    m_usedArea = 0;
+
+    // Start with a flat skyline covering the whole bottom of the bin
+    m_skyline.clear();
+    if (width > 0)
+        m_skyline.push_back(Segment(0, 0, width));
+}
+
+
+////////////////////////////////////////////////////////////
+void SkylinePacker::grow(unsigned int width, unsigned int height)
+{
+    // The new columns on the right are empty
+    if (width > m_width)
+    {
+        m_skyline.push_back(Segment(m_width, 0, width - m_width));
+        m_width = width;
+        merge();
+    }
+
+    if (height > m_height)
+        m_height = height;
+}
+
+
+////////////////////////////////////////////////////////////
+bool SkylinePacker::insert(unsigned int width, unsigned int height, IntRect& rect)
+{
+    if ((width == 0) || (height == 0))
+        return false;
+
+    // Find the segment where the top of the rectangle is the lowest;
+    // on a tie, prefer the narrowest segment, which wastes less room
+    std::size_t  bestIndex  = m_skyline.size();
+    unsigned int bestTop    = 0;
+    unsigned int bestBottom = 0;
+    unsigned int bestWidth  = 0;
+    for (std::size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        unsigned int y;
+        if (!fits(i, width, height, y))
+            continue;
+
+        unsigned int top = y + height;
+        if ((bestIndex == m_skyline.size()) || (top < bestTop) ||
+            ((top == bestTop) && (m_skyline[i].width < bestWidth)))
+        {
+            bestIndex  = i;
+            bestTop    = top;
+            bestBottom = y;
+            bestWidth  = m_skyline[i].width;
+        }
+    }
+
+    // The bin is full
+    if (bestIndex == m_skyline.size())
+        return false;
+
+    rect = IntRect(m_skyline[bestIndex].x, bestBottom, width, height);
+
+    // Insert the top of the rectangle in the skyline...
+    Segment segment(m_skyline[bestIndex].x, bestTop, width);
+    m_skyline.insert(m_skyline.begin() + bestIndex, segment);
+
+    // ... and shrink or remove the segments that it now covers
+    unsigned int right = segment.x + segment.width;
+    std::size_t i = bestIndex + 1;
+    while ((i < m_skyline.size()) && (m_skyline[i].x < right))
+    {
+        unsigned int segmentRight = m_skyline[i].x + m_skyline[i].width;
+        if (segmentRight <= right)
+        {
+            m_skyline.erase(m_skyline.begin() + i);
+        }
+        else
+        {
+            m_skyline[i].width = segmentRight - right;
+            m_skyline[i].x     = right;
+            break;
+        }
+    }
+
+    merge();
+    m_usedArea += static_cast<unsigned long>(width) * height;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SkylinePacker::getWidth() const
+{
+    return m_width;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SkylinePacker::getHeight() const
+{
+    return m_height;
+}
+
+
+////////////////////////////////////////////////////////////
+float SkylinePacker::getOccupancy() const
+{
+    if ((m_width == 0) || (m_height == 0))
+        return 0.f;
+
+    return static_cast<float>(m_usedArea) / (static_cast<float>(m_width) * m_height);
+}
+
+
+////////////////////////////////////////////////////////////
+bool SkylinePacker::fits(std::size_t index, unsigned int width, unsigned int height, unsigned int& y) const
+{
+    // The rectangle must not go past the right of the bin
+    if (m_skyline[index].x + width > m_width)
+        return false;
+
+    // The rectangle rests on the highest segment that it spans
+    y = 0;
+    unsigned int remaining = width;
+    for (std::size_t i = index; remaining > 0; ++i)
+    {
+        if (m_skyline[i].y > y)
+            y = m_skyline[i].y;
+
+        if (y + height > m_height)
+            return false;
+
+        remaining -= std::min(remaining, m_skyline[i].width);
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void SkylinePacker::merge()
+{
+    for (std::size_t i = 1; i < m_skyline.size();)
+    {
+        if (m_skyline[i - 1].y == m_skyline[i].y)
+        {
+            m_skyline[i - 1].width += m_skyline[i].width;
+            m_skyline.erase(m_skyline.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_SKYLINEPACKER_HPP
+#define SFML_SKYLINEPACKER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Rect.hpp>
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Rectangle packer using the skyline bottom-left algorithm
+///
+/// The packer keeps track of the top edge (the "skyline") of
+/// the rectangles already placed in the bin, and puts each new
+/// rectangle at the position where its top is the lowest,
+/// preferring the segments that waste the least width. This
+/// packs rectangles of various sizes much more tightly than
+/// a row packer, while insertion stays linear in the number
+/// of skyline segments.
+///
+////////////////////////////////////////////////////////////
+class SkylinePacker
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the packer with the size of its bin
+    ///
+    /// \param width  Width of the bin
+    /// \param height Height of the bin
+    ///
+    ////////////////////////////////////////////////////////////
+    SkylinePacker(unsigned int width = 0, unsigned int height = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the rectangles and change the size of the bin
+    ///
+    /// \param width  New width of the bin
+    /// \param height New height of the bin
+    ///
+    ////////////////////////////////////////////////////////////
+    void reset(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enlarge the bin, keeping the rectangles already placed
+    ///
+    /// The new size can't be smaller than the current one.
+    ///
+    /// \param width  New width of the bin
+    /// \param height New height of the bin
+    ///
+    ////////////////////////////////////////////////////////////
+    void grow(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find room for a new rectangle and reserve it
+    ///
+    /// \param width  Width of the rectangle
+    /// \param height Height of the rectangle
+    /// \param rect   Receives the area reserved for the rectangle
+    ///
+    /// \return True if the rectangle was placed, false if the bin is full
+    ///
+    ////////////////////////////////////////////////////////////
+    bool insert(unsigned int width, unsigned int height, IntRect& rect);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the width of the bin
+    ///
+    /// \return Width of the bin
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getWidth() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the height of the bin
+    ///
+    /// \return Height of the bin
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getHeight() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the ratio of the bin covered by rectangles
+    ///
+    /// \return Used area divided by the area of the bin, in [0, 1]
+    ///
+    ////////////////////////////////////////////////////////////
+    float getOccupancy() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Segment of the skyline
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Segment
+    {
+        Segment(unsigned int left, unsigned int top, unsigned int length) : x(left), y(top), width(length) {}
+
+        unsigned int x;     ///< Left of the segment
+        unsigned int y;     ///< Height of the skyline over the segment
+        unsigned int width; ///< Width of the segment
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check if a rectangle can be placed at the left of a segment
+    ///
+    /// \param index  Index of the segment
+    /// \param width  Width of the rectangle
+    /// \param height Height of the rectangle
+    /// \param y      Receives the top of the rectangle if it fits
+    ///
+    /// \return True if the rectangle fits
+    ///
+    ////////////////////////////////////////////////////////////
+    bool fits(std::size_t index, unsigned int width, unsigned int height, unsigned int& y) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Merge the adjacent segments which have the same height
+    ///
+    ////////////////////////////////////////////////////////////
+    void merge();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Segment> m_skyline;  ///< Segments of the skyline, from left to right
+    unsigned int         m_width;    ///< Width of the bin
+    unsigned int         m_height;   ///< Height of the bin
+    unsigned long        m_usedArea; ///< Area covered by the rectangles placed so far
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_SKYLINEPACKER_HPP
@@ -28,20 +28,58 @@
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
-#include <cassert>
+#include <algorithm>
+#include <limits>
+
+
+namespace
+{
+    // Distance by which the bold style pushes the outlines of distance field glyphs outwards
+    float getBoldWeight(unsigned int characterSize)
+    {
+        return characterSize / 64.f;
+    }
+
+    // Extend a bounding box, given as (left, top, right, bottom), to the vertices that follow the index first
+    void extendBounds(float box[4], const sf::VertexArray& vertices, unsigned int first)
+    {
+        for (unsigned int i = first; i < vertices.getVertexCount(); ++i)
+        {
+            const sf::Vector2f& position = vertices[i].position;
+            box[0] = std::min(box[0], position.x);
+            box[1] = std::min(box[1], position.y);
+            box[2] = std::max(box[2], position.x);
+            box[3] = std::max(box[3], position.y);
+        }
+    }
+
+    // Convert a bounding box to a rectangle, empty if the box doesn't contain any vertex
+    sf::FloatRect toRect(const float box[4], unsigned int vertexCount)
+    {
+        if (vertexCount == 0)
+            return sf::FloatRect();
+
+        return sf::FloatRect(box[0], box[1], box[2] - box[0], box[3] - box[1]);
+    }
+}
 
 
 namespace sf
 {
 ////////////////////////////////////////////////////////////
 Text::Text() :
-m_string       (),
-m_font         (NULL),
-m_characterSize(30),
-m_style        (Regular),
-m_color        (255, 255, 255),
-m_vertices     (Quads),
-m_bounds       ()
+m_string          (),
+m_font            (NULL),
+m_characterSize   (30),
+m_style           (Regular),
+m_color           (255, 255, 255),
+m_outlineColor    (0, 0, 0),
+m_outlineThickness(0.f),
+m_vertices           (Quads),
+m_bounds             (),
+m_layouts            (),
+m_geometryUpdateStart(0),
+m_geometryNeedUpdate (false)
 {
 
 }
@@ -49,23 +87,74 @@ m_bounds       ()
 
 ////////////////////////////////////////////////////////////
 Text::Text(const String& string, const Font& font, unsigned int characterSize) :
-m_string       (string),
-m_font         (&font),
-m_characterSize(characterSize),
-m_style        (Regular),
-m_color        (255, 255, 255),
-m_vertices     (Quads),
-m_bounds       ()
+m_string          (string),
+m_font            (&font),
+m_characterSize   (characterSize),
+m_style           (Regular),
+m_color           (255, 255, 255),
+m_outlineColor    (0, 0, 0),
+m_outlineThickness(0.f),
+m_vertices           (Quads),
+m_bounds             (),
+m_layouts            (),
+m_geometryUpdateStart(0),
+m_geometryNeedUpdate (true)
 {
-    updateGeometry();
+
 }
 
 
 ////////////////////////////////////////////////////////////
 void Text::setString(const String& string)
 {
-    m_string = string;
-    updateGeometry();
+    // Keep the geometry of the characters that didn't change
+    std::size_t start = 0;
+    std::size_t count = std::min(m_string.getSize(), string.getSize());
+    while ((start < count) && (m_string[start] == string[start]))
+        ++start;
+
+    if ((start < m_string.getSize()) || (start < string.getSize()))
+    {
+        m_string = string;
+        invalidateGeometry(start);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::append(const String& string)
+{
+    if (!string.isEmpty())
+    {
+        invalidateGeometry(m_string.getSize());
+        m_string += string;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::insert(std::size_t position, const String& string)
+{
+    // Adjust the position if it's out of range
+    if (position > m_string.getSize())
+        position = m_string.getSize();
+
+    if (!string.isEmpty())
+    {
+        m_string.insert(position, string);
+        invalidateGeometry(position);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::erase(std::size_t position, std::size_t count)
+{
+    if ((position < m_string.getSize()) && (count > 0))
+    {
+        m_string.erase(position, count);
+        invalidateGeometry(position);
+    }
 }
 
 
@@ -75,7 +164,7 @@ void Text::setFont(const Font& font)
     if (m_font != &font)
     {
         m_font = &font;
-        updateGeometry();
+        invalidateGeometry(0);
     }
 }
 
@@ -86,7 +175,7 @@ void Text::setCharacterSize(unsigned int size)
     if (m_characterSize != size)
     {
         m_characterSize = size;
-        updateGeometry();
+        invalidateGeometry(0);
     }
 }
 
@@ -97,7 +186,7 @@ void Text::setStyle(Uint32 style)
     if (m_style != style)
     {
         m_style = style;
-        updateGeometry();
+        invalidateGeometry(0);
     }
 }
 
@@ -114,6 +203,20 @@ void Text::setColor(const Color& color)
 }
 
 
+////////////////////////////////////////////////////////////
+void Text::setOutlineColor(const Color& color)
+{
+    m_outlineColor = color;
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::setOutlineThickness(float thickness)
+{
+    m_outlineThickness = thickness;
+}
+
+
 ////////////////////////////////////////////////////////////
 const String& Text::getString() const
 {
@@ -149,6 +252,20 @@ const Color& Text::getColor() const
 }
 
 
+////////////////////////////////////////////////////////////
+const Color& Text::getOutlineColor() const
+{
+    return m_outlineColor;
+}
+
+
+////////////////////////////////////////////////////////////
+float Text::getOutlineThickness() const
+{
+    return m_outlineThickness;
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2f Text::findCharacterPos(std::size_t index) const
 {
@@ -156,37 +273,18 @@ Vector2f Text::findCharacterPos(std::size_t index) const
     if (!m_font)
         return Vector2f();
 
+    ensureGeometryUpdate();
+
     // Adjust the index if it's out of range
     if (index > m_string.getSize())
         index = m_string.getSize();
 
-    // Precompute the variables needed by the algorithm
-    bool  bold   = (m_style & Bold) != 0;
-    float hspace = static_cast<float>(m_font->getGlyph(L' ', m_characterSize, bold).advance);
-    float vspace = static_cast<float>(m_font->getLineSpacing(m_characterSize));
-
-    // Compute the position
+    // Get the position from the layout, whose first line starts at the character size
     Vector2f position;
-    Uint32 prevChar = 0;
-    for (std::size_t i = 0; i < index; ++i)
+    if (index < m_layouts.size())
     {
-        Uint32 curChar = m_string[i];
-
-        // Apply the kerning offset
-        position.x += static_cast<float>(m_font->getKerning(prevChar, curChar, m_characterSize));
-        prevChar = curChar;
-
-        // Handle special characters
-        switch (curChar)
-        {
-            case L' ' :  position.x += hspace;                 continue;
-            case L'\t' : position.x += hspace * 4;             continue;
-            case L'\n' : position.y += vspace; position.x = 0; continue;
-            case L'\v' : position.y += vspace * 4;             continue;
-        }
-
-        // For regular characters, add the advance offset of the glyph
-        position.x += static_cast<float>(m_font->getGlyph(curChar, m_characterSize, bold).advance);
+        position = m_layouts[index].position;
+        position.y -= m_characterSize;
     }
 
     // Transform the position to global coordinates
@@ -199,6 +297,8 @@ Vector2f Text::findCharacterPos(std::size_t index) const
 ////////////////////////////////////////////////////////////
 FloatRect Text::getLocalBounds() const
 {
+    ensureGeometryUpdate();
+
     return m_bounds;
 }
 
@@ -215,49 +315,119 @@ void Text::draw(RenderTarget& target, RenderStates states) const
 {
     if (m_font)
     {
+        ensureGeometryUpdate();
+
         states.transform *= getTransform();
         states.texture = &m_font->getTexture(m_characterSize);
-        target.draw(m_vertices, states);
+
+        if (m_font->isDistanceField() && (m_vertices.getVertexCount() > 0))
+        {
+            // Convert the bold weight and the outline thickness to values of the distance
+            // field, whose range covers twice the spread once scaled to the character size
+            float range   = 2 * m_font->getDistanceFieldSpread() * m_characterSize / m_font->getDistanceFieldSize();
+            float weight  = (m_style & Bold) ? getBoldWeight(m_characterSize) : 0.f;
+            float edge    = 0.5f - weight / range;
+            float outline = m_outlineThickness / range;
+
+            target.drawDistanceField(&m_vertices[0], m_vertices.getVertexCount(), m_vertices.getPrimitiveType(),
+                                     edge, outline, m_outlineColor, states);
+        }
+        else
+        {
+            target.draw(m_vertices, states);
+        }
     }
 }
 
 
 ////////////////////////////////////////////////////////////
-void Text::updateGeometry()
+void Text::invalidateGeometry(std::size_t start)
 {
-    // Clear the previous geometry
-    m_vertices.clear();
-    m_bounds = FloatRect();
+    if (!m_geometryNeedUpdate || (start < m_geometryUpdateStart))
+        m_geometryUpdateStart = start;
 
-    // No font: nothing to draw
-    if (!m_font)
+    m_geometryNeedUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::ensureGeometryUpdate() const
+{
+    // Nothing to do if the geometry is up to date
+    if (!m_geometryNeedUpdate)
         return;
 
-    // No text: nothing to draw
-    if (m_string.isEmpty())
+    m_geometryNeedUpdate = false;
+
+    // No font or no text: nothing to draw
+    if (!m_font || m_string.isEmpty())
+    {
+        m_vertices.clear();
+        m_bounds = FloatRect();
+        m_layouts.clear();
         return;
+    }
+
+    // Distance field glyphs are loaded at a reference size and scaled to the character size
+    bool         distanceField = m_font->isDistanceField();
+    unsigned int glyphSize     = distanceField ? m_font->getDistanceFieldSize() : m_characterSize;
+    float        scale         = static_cast<float>(m_characterSize) / glyphSize;
 
     // Compute values related to the text style
     bool  bold               = (m_style & Bold) != 0;
+    float boldAdvance        = (distanceField && bold) ? 2 * getBoldWeight(m_characterSize) : 0.f;
     bool  underlined         = (m_style & Underlined) != 0;
     float italic             = (m_style & Italic) ? 0.208f : 0.f; // 12 degrees
     float underlineOffset    = m_characterSize * 0.1f;
     float underlineThickness = m_characterSize * (bold ? 0.1f : 0.07f);
 
     // Precompute the variables needed by the algorithm
-    float hspace = static_cast<float>(m_font->getGlyph(L' ', m_characterSize, bold).advance);
-    float vspace = static_cast<float>(m_font->getLineSpacing(m_characterSize));
+    float hspace = m_font->getGlyph(L' ', glyphSize, bold).advance * scale + boldAdvance;
+    float vspace = m_font->getLineSpacing(glyphSize) * scale;
     float x      = 0.f;
     float y      = static_cast<float>(m_characterSize);
+    float box[4] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                    -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()};
+
+    // The characters that precede the first change keep their geometry:
+    // resume the layout from the state that was recorded before it
+    std::size_t start = m_layouts.empty() ? 0 : std::min(m_geometryUpdateStart, m_layouts.size() - 1);
+    start = std::min(start, m_string.getSize());
+    if (start > 0)
+    {
+        const Layout& layout = m_layouts[start];
+        x = layout.position.x;
+        y = layout.position.y;
+        if (layout.vertexCount > 0)
+        {
+            box[0] = layout.bounds.left;
+            box[1] = layout.bounds.top;
+            box[2] = layout.bounds.left + layout.bounds.width;
+            box[3] = layout.bounds.top + layout.bounds.height;
+        }
+        m_vertices.resize(layout.vertexCount);
+    }
+    else
+    {
+        m_vertices.clear();
+    }
+    m_layouts.resize(start);
 
     // Create one quad for each character
-    Uint32 prevChar = 0;
-    for (std::size_t i = 0; i < m_string.getSize(); ++i)
+    Uint32 prevChar = (start > 0) ? m_string[start - 1] : 0;
+    unsigned int boundsVertexCount = m_vertices.getVertexCount();
+    for (std::size_t i = start; i < m_string.getSize(); ++i)
     {
         Uint32 curChar = m_string[i];
 
+        // Record the layout state, so that later changes can resume from this character
+        extendBounds(box, m_vertices, boundsVertexCount);
+        boundsVertexCount = m_vertices.getVertexCount();
+        Layout layout = {Vector2f(x, y), boundsVertexCount, toRect(box, boundsVertexCount)};
+        m_layouts.push_back(layout);
+
         // Apply the kerning offset
-        x += static_cast<float>(m_font->getKerning(prevChar, curChar, m_characterSize));
+        x += m_font->getKerning(prevChar, curChar, glyphSize) * scale;
         prevChar = curChar;
 
         // If we're using the underlined style and there's a new line, draw a line
@@ -282,12 +452,12 @@ void Text::updateGeometry()
         }
 
         // Extract the current glyph's description
-        const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, bold);
+        const Glyph& glyph = m_font->getGlyph(curChar, glyphSize, bold);
 
-        int left   = glyph.bounds.left;
-        int top    = glyph.bounds.top;
-        int right  = glyph.bounds.left + glyph.bounds.width;
-        int bottom = glyph.bounds.top  + glyph.bounds.height;
+        float left   = glyph.bounds.left * scale;
+        float top    = glyph.bounds.top * scale;
+        float right  = (glyph.bounds.left + glyph.bounds.width) * scale;
+        float bottom = (glyph.bounds.top  + glyph.bounds.height) * scale;
 
         float u1 = static_cast<float>(glyph.textureRect.left);
         float v1 = static_cast<float>(glyph.textureRect.top);
@@ -301,9 +471,15 @@ void Text::updateGeometry()
         m_vertices.append(Vertex(Vector2f(x + left  - italic * bottom, y + bottom), m_color, Vector2f(u1, v2)));
 
         // Advance to the next character
-        x += glyph.advance;
+        x += glyph.advance * scale + boldAdvance;
     }
 
+    // Record the layout state at the end of the string
+    extendBounds(box, m_vertices, boundsVertexCount);
+    boundsVertexCount = m_vertices.getVertexCount();
+    Layout layout = {Vector2f(x, y), boundsVertexCount, toRect(box, boundsVertexCount)};
+    m_layouts.push_back(layout);
+
     // If we're using the underlined style, add the last line
     if (underlined)
     {
@@ -317,7 +493,8 @@ void Text::updateGeometry()
     }
 
     // Recompute the bounding rectangle
-    m_bounds = m_vertices.getBounds();
+    extendBounds(box, m_vertices, boundsVertexCount);
+    m_bounds = toRect(box, m_vertices.getVertexCount());
 }
 
 } // namespace sf
@@ -29,12 +29,19 @@
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
 #include <SFML/Graphics/TextureSaver.hpp>
+#include <SFML/Graphics/TextureReadback.hpp>
+#include <SFML/Graphics/TextureFormat.hpp>
+#include <SFML/Graphics/TextureContainer.hpp>
+#include <SFML/Graphics/PixelKernels.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Window/Window.hpp>
 #include <SFML/System/Mutex.hpp>
 #include <SFML/System/Lock.hpp>
 #include <SFML/System/Err.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <vector>
 
 
 namespace
@@ -49,6 +56,33 @@ namespace
         sf::Lock lock(mutex);
         return id++;
     }
+
+    // Tell whether a pixel format stores blocks of compressed pixels
+    bool isCompressed(sf::Texture::PixelFormat format)
+    {
+        return sf::priv::getTextureFormat(format).blockSize > 0;
+    }
+
+    // Get the number of components of the pixels exchanged with the client
+    std::size_t getComponentCount(GLenum pixelFormat)
+    {
+        switch (pixelFormat)
+        {
+            case GL_RED :
+            case GL_DEPTH_COMPONENT : return 1;
+            case GL_RG :              return 2;
+            default :                 return 4;
+        }
+    }
+
+    // Get the minifying filter; with a mipmap, it samples the closest levels
+    GLint getMinFilter(bool smooth, bool mipmap)
+    {
+        if (mipmap)
+            return smooth ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+        else
+            return smooth ? GL_LINEAR : GL_NEAREST;
+    }
 }
 
 
@@ -56,36 +90,67 @@ namespace sf
 {
 ////////////////////////////////////////////////////////////
 Texture::Texture() :
-m_size         (0, 0),
-m_actualSize   (0, 0),
-m_texture      (0),
-m_isSmooth     (false),
-m_isRepeated   (false),
-m_pixelsFlipped(false),
-m_cacheId      (getUniqueId())
+m_size            (0, 0),
+m_actualSize      (0, 0),
+m_format          (RGBA8),
+m_hasMipmap       (false),
+m_texture         (0),
+m_isSmooth        (false),
+m_anisotropy      (1),
+m_isRepeated      (false),
+m_pixelsFlipped   (false),
+m_cacheId         (getUniqueId()),
+m_nextUploadBuffer(0),
+m_batchTarget     (NULL)
 {
-
+    m_uploadBuffers[0] = m_uploadBuffers[1] = 0;
+    m_uploadFences[0]  = m_uploadFences[1]  = NULL;
 }
 
 
 ////////////////////////////////////////////////////////////
 Texture::Texture(const Texture& copy) :
-m_size         (0, 0),
-m_actualSize   (0, 0),
-m_texture      (0),
-m_isSmooth     (copy.m_isSmooth),
-m_isRepeated   (copy.m_isRepeated),
-m_pixelsFlipped(false),
-m_cacheId      (getUniqueId())
+m_size            (0, 0),
+m_actualSize      (0, 0),
+m_format          (RGBA8),
+m_hasMipmap       (false),
+m_texture         (0),
+m_isSmooth        (copy.m_isSmooth),
+m_anisotropy      (copy.m_anisotropy),
+m_isRepeated      (copy.m_isRepeated),
+m_pixelsFlipped   (false),
+m_cacheId         (getUniqueId()),
+m_nextUploadBuffer(0),
+m_batchTarget     (NULL)
 {
+    m_uploadBuffers[0] = m_uploadBuffers[1] = 0;
+    m_uploadFences[0]  = m_uploadFences[1]  = NULL;
+
     if (copy.m_texture)
-        loadFromImage(copy.copyToImage());
+    {
+        if (isCompressed(copy.m_format))
+        {
+            // Compressed textures can't be rendered to, copy their blocks through the system memory
+            ensureGlContext();
+            priv::TextureContainer container;
+            if (container.loadFromTexture(copy))
+                loadFromContainer(container, IntRect());
+        }
+        else if (create(copy.m_size.x, copy.m_size.y, copy.m_format))
+        {
+            // Copy the pixels on the graphics card, to keep the format of the source
+            update(copy);
+        }
+    }
 }
 
 
 ////////////////////////////////////////////////////////////
 Texture::~Texture()
 {
+    // Draw the pending batch that uses the texture while it still exists
+    flushPendingBatch();
+
     // Destroy the OpenGL texture
     if (m_texture)
     {
@@ -94,11 +159,26 @@ Texture::~Texture()
         GLuint texture = static_cast<GLuint>(m_texture);
         glCheck(glDeleteTextures(1, &texture));
     }
+
+    // Destroy the resources of the asynchronous updates
+    if (m_uploadBuffers[0])
+    {
+        ensureGlContext();
+
+        for (int i = 0; i < 2; ++i)
+        {
+            if (m_uploadFences[i])
+                glCheck(glDeleteSync(static_cast<GLsync>(m_uploadFences[i])));
+        }
+
+        GLuint buffers[2] = {m_uploadBuffers[0], m_uploadBuffers[1]};
+        glCheck(glDeleteBuffersARB(2, buffers));
+    }
 }
 
 
 ////////////////////////////////////////////////////////////
-bool Texture::create(unsigned int width, unsigned int height)
+bool Texture::create(unsigned int width, unsigned int height, PixelFormat format)
 {
     // Check if texture parameters are valid before creating it
     if ((width == 0) || (height == 0))
@@ -107,6 +187,18 @@ bool Texture::create(unsigned int width, unsigned int height)
         return false;
     }
 
+    // Check the pixel format
+    if (isCompressed(format))
+    {
+        err() << "Failed to create texture, compressed textures can only be loaded from DDS or KTX files" << std::endl;
+        return false;
+    }
+    if (!isPixelFormatAvailable(format))
+    {
+        err() << "Failed to create texture, its pixel format is not supported by your system" << std::endl;
+        return false;
+    }
+
     // Compute the internal texture dimensions depending on NPOT textures support
     Vector2u actualSize(getValidSize(width), getValidSize(height));
 
@@ -121,10 +213,15 @@ bool Texture::create(unsigned int width, unsigned int height)
         return false;
     }
 
+    // Draws already batched with the texture must keep its previous contents
+    flushPendingBatch();
+
     // All the validity checks passed, we can store the new texture settings
     m_size.x        = width;
     m_size.y        = height;
     m_actualSize    = actualSize;
+    m_format        = format;
+    m_hasMipmap     = false;
     m_pixelsFlipped = false;
 
     ensureGlContext();
@@ -141,12 +238,16 @@ bool Texture::create(unsigned int width, unsigned int height)
     priv::TextureSaver save;
 
     // Initialize the texture
+    priv::TextureFormat textureFormat = priv::getTextureFormat(m_format);
     glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-    glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_actualSize.x, m_actualSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+    glCheck(glTexImage2D(GL_TEXTURE_2D, 0, textureFormat.internalFormat, m_actualSize.x, m_actualSize.y, 0, textureFormat.pixelFormat, GL_UNSIGNED_BYTE, NULL));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
-    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinFilter(m_isSmooth, false)));
+    if (m_anisotropy > 1)
+        applyAnisotropy();
     m_cacheId = getUniqueId();
 
     return true;
@@ -156,6 +257,13 @@ bool Texture::create(unsigned int width, unsigned int height)
 ////////////////////////////////////////////////////////////
 bool Texture::loadFromFile(const std::string& filename, const IntRect& area)
 {
+    // Compressed textures are uploaded as they are, without being decoded
+    if (priv::TextureContainer::isContainerFile(filename))
+    {
+        priv::TextureContainer container;
+        return container.loadFromFile(filename) && loadFromContainer(container, area);
+    }
+
     Image image;
     return image.loadFromFile(filename) && loadFromImage(image, area);
 }
@@ -164,6 +272,13 @@ bool Texture::loadFromFile(const std::string& filename, const IntRect& area)
 ////////////////////////////////////////////////////////////
 bool Texture::loadFromMemory(const void* data, std::size_t size, const IntRect& area)
 {
+    // Compressed textures are uploaded as they are, without being decoded
+    if (priv::TextureContainer::isContainer(data, size))
+    {
+        priv::TextureContainer container;
+        return container.loadFromMemory(data, size) && loadFromContainer(container, area);
+    }
+
     Image image;
     return image.loadFromMemory(data, size) && loadFromImage(image, area);
 }
@@ -172,6 +287,13 @@ bool Texture::loadFromMemory(const void* data, std::size_t size, const IntRect&
 ////////////////////////////////////////////////////////////
 bool Texture::loadFromStream(InputStream& stream, const IntRect& area)
 {
+    // Compressed textures are uploaded as they are, without being decoded
+    if (priv::TextureContainer::isContainerStream(stream))
+    {
+        priv::TextureContainer container;
+        return container.loadFromStream(stream) && loadFromContainer(container, area);
+    }
+
     Image image;
     return image.loadFromStream(stream) && loadFromImage(image, area);
 }
@@ -213,17 +335,9 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
         // Create the texture and upload the pixels
         if (create(rectangle.width, rectangle.height))
         {
-            // Make sure that the current texture binding will be preserved
-            priv::TextureSaver save;
-
-            // Copy the pixels to the texture, row by row
-            const Uint8* pixels = image.getPixelsPtr() + 4 * (rectangle.left + (width * rectangle.top));
-            glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-            for (int i = 0; i < rectangle.height; ++i)
-            {
-                glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, i, rectangle.width, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
-                pixels += 4 * width;
-            }
+            // Copy the pixels to the texture, in a single call: the stride of
+            // the view makes OpenGL skip the pixels of the image outside the area
+            update(ImageView(image).getSubView(rectangle));
 
             return true;
         }
@@ -236,66 +350,113 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
 
 
 ////////////////////////////////////////////////////////////
-Vector2u Texture::getSize() const
+bool Texture::loadFromContainer(const priv::TextureContainer& container, const IntRect& area)
 {
-    return m_size;
-}
+    Vector2u size = container.getSize();
 
+    // Blocks of compressed pixels can't be cropped
+    if ((area.width != 0) && (area.height != 0) &&
+        ((area.left > 0) || (area.top > 0) || (area.left + area.width < static_cast<int>(size.x)) || (area.top + area.height < static_cast<int>(size.y))))
+    {
+        err() << "Failed to load compressed texture, loading a sub-area is not supported" << std::endl;
+        return false;
+    }
 
-////////////////////////////////////////////////////////////
-Image Texture::copyToImage() const
-{
-    // Easy case: empty texture
-    if (!m_texture)
-        return Image();
+    // Check the pixel format
+    if (!isPixelFormatAvailable(container.getFormat()))
+    {
+        err() << "Failed to load compressed texture, its pixel format is not supported by your system" << std::endl;
+        return false;
+    }
+
+    // Compressed textures can't be padded to a power of two size
+    if ((getValidSize(size.x) != size.x) || (getValidSize(size.y) != size.y))
+    {
+        err() << "Failed to load compressed texture, its size (" << size.x << "x" << size.y << ") "
+              << "is not a power of two, which your system requires" << std::endl;
+        return false;
+    }
+
+    // Check the maximum texture size
+    unsigned int maxSize = getMaximumSize();
+    if ((size.x > maxSize) || (size.y > maxSize))
+    {
+        err() << "Failed to load compressed texture, its size is too high "
+              << "(" << size.x << "x" << size.y << ", "
+              << "maximum is " << maxSize << "x" << maxSize << ")"
+              << std::endl;
+        return false;
+    }
+
+    // Draws already batched with the texture must keep its previous contents
+    flushPendingBatch();
+
+    // All the validity checks passed, we can store the new texture settings
+    const std::vector<priv::TextureContainer::Level>& levels = container.getLevels();
+    m_size          = size;
+    m_actualSize    = size;
+    m_format        = container.getFormat();
+    m_hasMipmap     = (levels.size() > 1);
+    m_pixelsFlipped = container.isFlipped();
 
     ensureGlContext();
 
+    // Create the OpenGL texture if it doesn't exist yet
+    if (!m_texture)
+    {
+        GLuint texture;
+        glCheck(glGenTextures(1, &texture));
+        m_texture = static_cast<unsigned int>(texture);
+    }
+
     // Make sure that the current texture binding will be preserved
     priv::TextureSaver save;
 
-    // Create an array of pixels
-    std::vector<Uint8> pixels(m_size.x * m_size.y * 4);
-
-    if ((m_size == m_actualSize) && !m_pixelsFlipped)
+    // Upload the blocks of all the levels, the graphics card decompresses them when sampling
+    GLint internalFormat = priv::getTextureFormat(m_format).internalFormat;
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    for (std::size_t i = 0; i < levels.size(); ++i)
     {
-        // Texture is not padded nor flipped, we can use a direct copy
-        glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-        glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+        const priv::TextureContainer::Level& level = levels[i];
+        glCheck(glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), internalFormat, level.size.x, level.size.y, 0,
+                                       static_cast<GLsizei>(level.length), container.getBlocks(level)));
     }
-    else
-    {
-        // Texture is either padded or flipped, we have to use a slower algorithm
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size() - 1)));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinFilter(m_isSmooth, m_hasMipmap)));
+    if (m_anisotropy > 1)
+        applyAnisotropy();
+    m_cacheId = getUniqueId();
 
-        // All the pixels will first be copied to a temporary array
-        std::vector<Uint8> allPixels(m_actualSize.x * m_actualSize.y * 4);
-        glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-        glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &allPixels[0]));
+    return true;
+}
 
-        // Then we copy the useful pixels from the temporary array to the final one
-        const Uint8* src = &allPixels[0];
-        Uint8* dst = &pixels[0];
-        int srcPitch = m_actualSize.x * 4;
-        int dstPitch = m_size.x * 4;
 
-        // Handle the case where source pixels are flipped vertically
-        if (m_pixelsFlipped)
-        {
-            src += srcPitch * (m_size.y - 1);
-            srcPitch = -srcPitch;
-        }
+////////////////////////////////////////////////////////////
+Vector2u Texture::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+Texture::PixelFormat Texture::getPixelFormat() const
+{
+    return m_format;
+}
 
-        for (unsigned int i = 0; i < m_size.y; ++i)
-        {
-            std::memcpy(dst, src, dstPitch);
-            src += srcPitch;
-            dst += dstPitch;
-        }
-    }
 
-    // Create the image
+////////////////////////////////////////////////////////////
+Image Texture::copyToImage() const
+{
+    // Download the pixels and write them directly into the image, the
+    // readback takes care of the padding and orientation of the texture
     Image image;
-    image.create(m_size.x, m_size.y, &pixels[0]);
+    TextureReadback readback;
+    if (readback.start(*this))
+        readback.copyTo(image);
 
     return image;
 }
@@ -311,22 +472,38 @@ void Texture::update(const Uint8* pixels)
 
 ////////////////////////////////////////////////////////////
 void Texture::update(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y)
+{
+    update(ImageView(pixels, width, height), x, y);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::update(const float* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y)
 {
     assert(x + width <= m_size.x);
     assert(y + height <= m_size.y);
 
+    if (isCompressed(m_format))
+    {
+        err() << "Failed to update texture, compressed textures can't be updated with pixels" << std::endl;
+        return;
+    }
+
     if (pixels && m_texture)
     {
+        flushPendingBatch();
         ensureGlContext();
 
         // Make sure that the current texture binding will be preserved
         priv::TextureSaver save;
 
-        // Copy pixels from the given array to the texture
+        // Copy the values from the given array to the texture, they have the channels of its format
+        priv::TextureFormat format = priv::getTextureFormat(m_format);
         glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-        glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+        glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format.pixelFormat, GL_FLOAT, pixels));
         m_pixelsFlipped = false;
         m_cacheId = getUniqueId();
+        invalidateMipmap();
     }
 }
 
@@ -347,18 +524,218 @@ void Texture::update(const Image& image, unsigned int x, unsigned int y)
 
 
 ////////////////////////////////////////////////////////////
-void Texture::update(const Window& window)
+void Texture::update(const ImageView& view, unsigned int x, unsigned int y)
+{
+    assert(x + view.width <= m_size.x);
+    assert(y + view.height <= m_size.y);
+    assert(view.stride % 4 == 0);
+
+    if (m_format == Depth)
+    {
+        err() << "Failed to update texture, depth textures can't be updated with RGBA pixels" << std::endl;
+        return;
+    }
+    if (isCompressed(m_format))
+    {
+        err() << "Failed to update texture, compressed textures can't be updated with pixels" << std::endl;
+        return;
+    }
+
+    if (view.pixels && m_texture)
+    {
+        flushPendingBatch();
+        ensureGlContext();
+
+        // Make sure that the current texture binding will be preserved
+        priv::TextureSaver save;
+
+        // Copy pixels from the given array to the texture; the row
+        // length tells OpenGL to skip the padding at the end of the rows
+        bool padded = (view.stride != view.width * 4);
+        glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+        if (padded)
+            glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(view.stride / 4)));
+        glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, view.width, view.height, GL_RGBA, GL_UNSIGNED_BYTE, view.pixels));
+        if (padded)
+            glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+        m_pixelsFlipped = false;
+        m_cacheId = getUniqueId();
+        invalidateMipmap();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::update(const Texture& texture)
+{
+    update(texture, 0, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::update(const Texture& texture, unsigned int x, unsigned int y)
+{
+    assert(x + texture.m_size.x <= m_size.x);
+    assert(y + texture.m_size.y <= m_size.y);
+    assert(&texture != this);
+
+    if (!m_texture || !texture.m_texture)
+        return;
+
+    if (isCompressed(m_format))
+    {
+        err() << "Failed to update texture, compressed textures can't be updated with pixels" << std::endl;
+        return;
+    }
+
+    // Depth can't be converted to colors, nor colors to depth
+    bool depth = (texture.m_format == Depth);
+    if (depth != (m_format == Depth))
+    {
+        err() << "Failed to update texture, depth and color textures can't be copied to each other" << std::endl;
+        return;
+    }
+
+    flushPendingBatch();
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    // Copy the pixels on the graphics card when possible, so that they keep their precision;
+    // glCopyTexSubImage2D can't flip the rows of the textures filled from a render target
+    bool copied = false;
+    bool canBlit = GLEW_EXT_framebuffer_object && GLEW_EXT_framebuffer_blit;
+    if (canBlit || (GLEW_EXT_framebuffer_object && !texture.m_pixelsFlipped))
+    {
+        // Make sure that the current texture and framebuffer bindings will be preserved
+        priv::TextureSaver save;
+        GLint previousFrameBuffer = 0;
+        GLint previousReadFrameBuffer = 0;
+        GLint previousDrawFrameBuffer = 0;
+        if (canBlit)
+        {
+            glCheck(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING_EXT, &previousReadFrameBuffer));
+            glCheck(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING_EXT, &previousDrawFrameBuffer));
+        }
+        else
+        {
+            glCheck(glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &previousFrameBuffer));
+        }
+
+        // Attach the source texture to a temporary framebuffer; depth textures can only be depth attachments
+        GLenum attachment = depth ? GL_DEPTH_ATTACHMENT_EXT : GL_COLOR_ATTACHMENT0_EXT;
+        GLenum readTarget = canBlit ? GL_READ_FRAMEBUFFER_EXT : GL_FRAMEBUFFER_EXT;
+        GLuint frameBuffers[2] = {0, 0};
+        glCheck(glGenFramebuffersEXT(canBlit ? 2 : 1, frameBuffers));
+        glCheck(glBindFramebufferEXT(readTarget, frameBuffers[0]));
+        glCheck(glFramebufferTexture2DEXT(readTarget, attachment, GL_TEXTURE_2D, texture.m_texture, 0));
+        if (depth)
+            glCheck(glReadBuffer(GL_NONE));
+
+        if (canBlit)
+        {
+            // Attach this texture to a second framebuffer, and blit between them; the rows
+            // of flipped sources are flipped back by swapping the destination bounds
+            glCheck(glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, frameBuffers[1]));
+            glCheck(glFramebufferTexture2DEXT(GL_DRAW_FRAMEBUFFER_EXT, attachment, GL_TEXTURE_2D, m_texture, 0));
+            if (depth)
+                glCheck(glDrawBuffer(GL_NONE));
+
+            if ((glCheckFramebufferStatusEXT(GL_READ_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT) &&
+                (glCheckFramebufferStatusEXT(GL_DRAW_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT))
+            {
+                GLint width  = static_cast<GLint>(texture.m_size.x);
+                GLint height = static_cast<GLint>(texture.m_size.y);
+                GLint left   = static_cast<GLint>(x);
+                GLint top    = static_cast<GLint>(y);
+                GLint bottom = top + height;
+                if (texture.m_pixelsFlipped)
+                    std::swap(top, bottom);
+
+                glCheck(glBlitFramebufferEXT(0, 0, width, height, left, top, left + width, bottom,
+                                             depth ? GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT, GL_NEAREST));
+                copied = true;
+            }
+
+            glCheck(glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, static_cast<GLuint>(previousReadFrameBuffer)));
+            glCheck(glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, static_cast<GLuint>(previousDrawFrameBuffer)));
+        }
+        else
+        {
+            // Copy from the framebuffer to this texture, without leaving the graphics card
+            if (glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT)
+            {
+                glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+                glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, texture.m_size.x, texture.m_size.y));
+                copied = true;
+            }
+
+            glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, static_cast<GLuint>(previousFrameBuffer)));
+        }
+
+        glCheck(glDeleteFramebuffersEXT(canBlit ? 2 : 1, frameBuffers));
+    }
+
+    if (!copied)
+    {
+        // Go through the system memory, with floats so that no precision is lost
+        priv::TextureFormat format = priv::getTextureFormat(texture.m_format);
+        std::size_t components = getComponentCount(format.pixelFormat);
+        std::vector<float> storage(texture.m_actualSize.x * texture.m_actualSize.y * components);
+
+        // Make sure that the current texture binding will be preserved
+        priv::TextureSaver save;
+
+        glCheck(glBindTexture(GL_TEXTURE_2D, texture.m_texture));
+        glCheck(glGetTexImage(GL_TEXTURE_2D, 0, format.pixelFormat, GL_FLOAT, &storage[0]));
+
+        // Keep the visible rows only, in top to bottom order
+        std::size_t rowLength = texture.m_size.x * components;
+        std::vector<float> pixels(rowLength * texture.m_size.y);
+        for (unsigned int i = 0; i < texture.m_size.y; ++i)
+        {
+            unsigned int row = texture.m_pixelsFlipped ? texture.m_size.y - 1 - i : i;
+            const float* source = &storage[row * texture.m_actualSize.x * components];
+            std::copy(source, source + rowLength, &pixels[i * rowLength]);
+        }
+
+        glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+        glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, texture.m_size.x, texture.m_size.y, format.pixelFormat, GL_FLOAT, &pixels[0]));
+    }
+
+    m_pixelsFlipped = false;
+    m_cacheId = getUniqueId();
+    invalidateMipmap();
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::update(Window& window)
 {
     update(window, 0, 0);
 }
 
 
 ////////////////////////////////////////////////////////////
-void Texture::update(const Window& window, unsigned int x, unsigned int y)
+void Texture::update(Window& window, unsigned int x, unsigned int y)
 {
     assert(x + window.getSize().x <= m_size.x);
     assert(y + window.getSize().y <= m_size.y);
 
+    if (isCompressed(m_format))
+    {
+        err() << "Failed to update texture, compressed textures can't be updated with pixels" << std::endl;
+        return;
+    }
+
+    // Let the window finish its rendering before its back buffer is read
+    window.onCapture();
+
+    // Draws already batched with this texture must keep its previous contents
+    if (m_texture)
+        flushPendingBatch();
+
     if (m_texture && window.setActive(true))
     {
         // Make sure that the current texture binding will be preserved
@@ -369,10 +746,165 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
         glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, window.getSize().x, window.getSize().y));
         m_pixelsFlipped = true;
         m_cacheId = getUniqueId();
+        invalidateMipmap();
     }
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::updateAsync(const Uint8* pixels)
+{
+    // Update the whole texture
+    updateAsync(pixels, m_size.x, m_size.y, 0, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::updateAsync(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y)
+{
+    assert(x + width <= m_size.x);
+    assert(y + height <= m_size.y);
+
+    if (!pixels || !m_texture)
+        return;
+
+    // Fall back to a synchronous update if pixel buffers or fences are not supported,
+    // the synchronous update also reports the formats that can't be updated with RGBA pixels
+    if (!isAsyncUpdateAvailable() || (m_format == Depth) || isCompressed(m_format))
+    {
+        update(pixels, width, height, x, y);
+        return;
+    }
+
+    flushPendingBatch();
+    ensureGlContext();
+
+    // Create the pixel buffers if they don't exist yet
+    if (!m_uploadBuffers[0])
+    {
+        GLuint buffers[2];
+        glCheck(glGenBuffersARB(2, buffers));
+        m_uploadBuffers[0] = static_cast<unsigned int>(buffers[0]);
+        m_uploadBuffers[1] = static_cast<unsigned int>(buffers[1]);
+    }
+
+    // Use the pixel buffers alternately
+    unsigned int index = m_nextUploadBuffer;
+    m_nextUploadBuffer = 1 - index;
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    // Copy the pixels to the pixel buffer; the storage is specified again every time, so
+    // that the driver never waits for a previous transfer from the same buffer to finish
+    glCheck(glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_uploadBuffers[index]));
+    glCheck(glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, width * height * 4, pixels, GL_STREAM_DRAW_ARB));
+
+    // Start the transfer from the pixel buffer to the texture, it is performed in the background
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+    glCheck(glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0));
+
+    // Insert a fence, to know when the transfer is complete
+    if (m_uploadFences[index])
+        glCheck(glDeleteSync(static_cast<GLsync>(m_uploadFences[index])));
+    m_uploadFences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_pixelsFlipped = false;
+    m_cacheId = getUniqueId();
+    invalidateMipmap();
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::updateAsync(const Image& image, unsigned int x, unsigned int y)
+{
+    updateAsync(image.getPixelsPtr(), image.getSize().x, image.getSize().y, x, y);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::isUpdatePending() const
+{
+    if (!m_uploadFences[0] && !m_uploadFences[1])
+        return false;
+
+    ensureGlContext();
+
+    bool pending = false;
+    for (int i = 0; i < 2; ++i)
+    {
+        if (m_uploadFences[i])
+        {
+            // Poll the fence without waiting, and release it once signaled
+            GLsync fence = static_cast<GLsync>(m_uploadFences[i]);
+            GLenum status = glClientWaitSync(fence, 0, 0);
+            if ((status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED))
+            {
+                glCheck(glDeleteSync(fence));
+                m_uploadFences[i] = NULL;
+            }
+            else
+            {
+                pending = true;
+            }
+        }
+    }
+
+    return pending;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::generateMipmap()
+{
+    if (!m_texture)
+        return false;
+
+    // The blocks of compressed textures can't be averaged, only the levels stored in their file are available
+    if (isCompressed(m_format))
+    {
+        if (!m_hasMipmap)
+            err() << "Failed to generate mipmap, compressed textures only have the levels stored in their file" << std::endl;
+        return m_hasMipmap;
+    }
+
+    flushPendingBatch();
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    // Each level halves the size of the previous one, down to 1x1
+    unsigned int levels = 1;
+    for (unsigned int size = std::max(m_actualSize.x, m_actualSize.y); size > 1; size /= 2)
+        ++levels;
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    // Let the graphics card compute the levels if it can, otherwise average them in system memory
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    if (m_actualSize != m_size)
+        extendPadding();
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels - 1)));
+    if (GLEW_EXT_framebuffer_object)
+    {
+        glCheck(glGenerateMipmapEXT(GL_TEXTURE_2D));
+    }
+    else if (!generateMipmapLevels(levels))
+    {
+        glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+        return false;
+    }
+
+    m_hasMipmap = true;
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinFilter(m_isSmooth, m_hasMipmap)));
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::setSmooth(bool smooth)
 {
@@ -382,6 +914,7 @@ void Texture::setSmooth(bool smooth)
 
         if (m_texture)
         {
+            flushPendingBatch();
             ensureGlContext();
 
             // Make sure that the current texture binding will be preserved
@@ -389,7 +922,7 @@ void Texture::setSmooth(bool smooth)
 
             glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
             glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
-            glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+            glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinFilter(m_isSmooth, m_hasMipmap)));
         }
     }
 }
@@ -402,6 +935,36 @@ bool Texture::isSmooth() const
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::setAnisotropy(unsigned int level)
+{
+    level = std::max(level, 1u);
+    if (level != m_anisotropy)
+    {
+        m_anisotropy = level;
+
+        if (m_texture)
+        {
+            flushPendingBatch();
+            ensureGlContext();
+
+            // Make sure that the current texture binding will be preserved
+            priv::TextureSaver save;
+
+            glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+            applyAnisotropy();
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Texture::getAnisotropy() const
+{
+    return m_anisotropy;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::setRepeated(bool repeated)
 {
@@ -411,6 +974,7 @@ void Texture::setRepeated(bool repeated)
 
         if (m_texture)
         {
+            flushPendingBatch();
             ensureGlContext();
 
             // Make sure that the current texture binding will be preserved
@@ -443,23 +1007,240 @@ unsigned int Texture::getMaximumSize()
 }
 
 
+////////////////////////////////////////////////////////////
+unsigned int Texture::getMaximumAnisotropy()
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    if (!GLEW_EXT_texture_filter_anisotropic)
+        return 1;
+
+    GLfloat level;
+    glCheck(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &level));
+
+    return static_cast<unsigned int>(level);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::isAsyncUpdateAvailable()
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    return GLEW_ARB_pixel_buffer_object && GLEW_ARB_sync;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::isPixelFormatAvailable(PixelFormat format)
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    switch (format)
+    {
+        case R8 :
+        case RG8 :
+            return GLEW_VERSION_3_0 || GLEW_ARB_texture_rg;
+
+        case RGBA16F :
+        case RGBA32F :
+            return GLEW_VERSION_3_0 || GLEW_ARB_texture_float;
+
+        case Depth :
+            return GLEW_VERSION_1_4 || GLEW_ARB_depth_texture;
+
+        case BC1 :
+        case BC2 :
+        case BC3 :
+            return GLEW_EXT_texture_compression_s3tc != 0;
+
+        case BC4 :
+        case BC5 :
+            return GLEW_VERSION_3_0 || GLEW_ARB_texture_compression_rgtc;
+
+        case BC6H :
+        case BC7 :
+            return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+
+        case ETC2RGB :
+        case ETC2RGBA :
+            return GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility;
+
+        default :
+            return true;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 Texture& Texture::operator =(const Texture& right)
 {
     Texture temp(right);
 
-    std::swap(m_size,          temp.m_size);
-    std::swap(m_actualSize,    temp.m_actualSize);
-    std::swap(m_texture,       temp.m_texture);
-    std::swap(m_isSmooth,      temp.m_isSmooth);
-    std::swap(m_isRepeated,    temp.m_isRepeated);
-    std::swap(m_pixelsFlipped, temp.m_pixelsFlipped);
+    swap(temp);
     m_cacheId = getUniqueId();
 
     return *this;
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::swap(Texture& right)
+{
+    // Draws already batched with either texture must keep its current contents
+    flushPendingBatch();
+    right.flushPendingBatch();
+
+    std::swap(m_size,             right.m_size);
+    std::swap(m_actualSize,       right.m_actualSize);
+    std::swap(m_format,           right.m_format);
+    std::swap(m_hasMipmap,        right.m_hasMipmap);
+    std::swap(m_texture,          right.m_texture);
+    std::swap(m_isSmooth,         right.m_isSmooth);
+    std::swap(m_anisotropy,       right.m_anisotropy);
+    std::swap(m_isRepeated,       right.m_isRepeated);
+    std::swap(m_pixelsFlipped,    right.m_pixelsFlipped);
+    std::swap(m_cacheId,          right.m_cacheId);
+    std::swap(m_uploadBuffers[0], right.m_uploadBuffers[0]);
+    std::swap(m_uploadBuffers[1], right.m_uploadBuffers[1]);
+    std::swap(m_uploadFences[0],  right.m_uploadFences[0]);
+    std::swap(m_uploadFences[1],  right.m_uploadFences[1]);
+    std::swap(m_nextUploadBuffer, right.m_nextUploadBuffer);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::generateMipmapLevels(unsigned int levels)
+{
+    // Other formats would lose their precision or can't be read as colors
+    if ((m_format != R8) && (m_format != RG8) && (m_format != RGBA8))
+    {
+        err() << "Failed to generate mipmap, the levels of textures in this pixel format can only be "
+              << "generated by the graphics card (it requires OpenGL 3.0 or GL_EXT_framebuffer_object)" << std::endl;
+        return false;
+    }
+
+    // Download the base level; the rows are processed in the order they are
+    // stored, so that the levels have the same orientation as the base level
+    Vector2u size = m_actualSize;
+    std::vector<Uint8> pixels(size.x * size.y * 4);
+    glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+
+    GLint internalFormat = priv::getTextureFormat(m_format).internalFormat;
+    std::vector<Uint8> level;
+    for (unsigned int i = 1; i < levels; ++i)
+    {
+        Vector2u levelSize(std::max(size.x / 2, 1u), std::max(size.y / 2, 1u));
+        level.resize(levelSize.x * levelSize.y * 4);
+
+        // Average the blocks of 2x2 pixels; the last row or column of odd sizes
+        // is dropped, and the pixels of single rows or columns are repeated
+        for (unsigned int y = 0; y < levelSize.y; ++y)
+        {
+            const Uint8* row0 = &pixels[std::min(y * 2, size.y - 1) * size.x * 4];
+            const Uint8* row1 = &pixels[std::min(y * 2 + 1, size.y - 1) * size.x * 4];
+            Uint8* destination = &level[y * levelSize.x * 4];
+
+            if (size.x > 1)
+            {
+                priv::downsamplePixels(destination, row0, row1, levelSize.x);
+            }
+            else
+            {
+                Uint8 column[16];
+                std::memcpy(column,      row0, 4);
+                std::memcpy(column + 4,  row0, 4);
+                std::memcpy(column + 8,  row1, 4);
+                std::memcpy(column + 12, row1, 4);
+                priv::downsamplePixels(destination, column, column + 8, 1);
+            }
+        }
+
+        glCheck(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), internalFormat, levelSize.x, levelSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, &level[0]));
+
+        pixels.swap(level);
+        size = levelSize;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::extendPadding()
+{
+    // Go through the system memory, with floats so that no precision is lost
+    priv::TextureFormat format = priv::getTextureFormat(m_format);
+    std::size_t components = getComponentCount(format.pixelFormat);
+    std::size_t pixelSize = components * sizeof(float);
+    std::vector<float> pixels(m_actualSize.x * m_actualSize.y * components);
+    glCheck(glGetTexImage(GL_TEXTURE_2D, 0, format.pixelFormat, GL_FLOAT, &pixels[0]));
+
+    // The image is always in the first rows and columns, whether it's flipped or not
+    std::size_t rowLength = m_actualSize.x * components;
+    for (unsigned int y = 0; y < m_size.y; ++y)
+    {
+        float* row = &pixels[y * rowLength];
+        for (unsigned int x = m_size.x; x < m_actualSize.x; ++x)
+            std::memcpy(row + x * components, row + (m_size.x - 1) * components, pixelSize);
+    }
+    for (unsigned int y = m_size.y; y < m_actualSize.y; ++y)
+        std::copy(&pixels[(m_size.y - 1) * rowLength], &pixels[m_size.y * rowLength], &pixels[y * rowLength]);
+
+    glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_actualSize.x, m_actualSize.y, format.pixelFormat, GL_FLOAT, &pixels[0]));
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::flushPendingBatch() const
+{
+    if (m_batchTarget)
+        m_batchTarget->flushBatch(RenderTarget::TextureChange);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::invalidateMipmap()
+{
+    if (!m_hasMipmap)
+        return;
+
+    ensureGlContext();
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    // The levels are kept, but are not sampled anymore
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinFilter(m_isSmooth, false)));
+
+    m_hasMipmap = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::applyAnisotropy()
+{
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    if (GLEW_EXT_texture_filter_anisotropic)
+    {
+        GLfloat level = static_cast<GLfloat>(std::min(m_anisotropy, getMaximumAnisotropy()));
+        glCheck(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, level));
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 unsigned int Texture::getValidSize(unsigned int size)
 {
@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TextureAtlas.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/SkylinePacker.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+struct TextureAtlas::Page
+{
+    Texture             texture; ///< Texture containing the pixels of the images
+    priv::SkylinePacker packer;  ///< Allocator of the areas of the texture
+};
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::Region::Region() :
+texture(NULL),
+rect   ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::TextureAtlas(unsigned int pageSize, unsigned int padding) :
+m_pages   (),
+m_pageSize(pageSize),
+m_padding (padding),
+m_isSmooth(false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::~TextureAtlas()
+{
+    clear();
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::Region TextureAtlas::add(const Image& image)
+{
+    return add(image, IntRect());
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::Region TextureAtlas::add(const Image& image, const IntRect& sourceRect)
+{
+    // Adjust the source rectangle, an empty one means the whole image
+    int imageWidth  = static_cast<int>(image.getSize().x);
+    int imageHeight = static_cast<int>(image.getSize().y);
+    IntRect rect = sourceRect;
+    if ((rect.width == 0) || (rect.height == 0))
+        rect = IntRect(0, 0, imageWidth, imageHeight);
+    if (rect.left < 0) rect.left = 0;
+    if (rect.top < 0) rect.top = 0;
+    if (rect.left + rect.width > imageWidth) rect.width = imageWidth - rect.left;
+    if (rect.top + rect.height > imageHeight) rect.height = imageHeight - rect.top;
+    if ((rect.width <= 0) || (rect.height <= 0))
+    {
+        err() << "Failed to add image to texture atlas: the image is empty" << std::endl;
+        return Region();
+    }
+
+    // Reserve room for the image and its padding, in the first page that can hold it
+    unsigned int width  = rect.width + 2 * m_padding;
+    unsigned int height = rect.height + 2 * m_padding;
+    Page* page = NULL;
+    IntRect area;
+    for (std::vector<Page*>::iterator it = m_pages.begin(); (it != m_pages.end()) && !page; ++it)
+    {
+        if ((*it)->packer.insert(width, height, area))
+            page = *it;
+    }
+
+    // All the pages are full: create a new one, big enough for the image
+    if (!page)
+    {
+        page = createPage(std::max(m_pageSize, width), std::max(m_pageSize, height));
+        if (!page || !page->packer.insert(width, height, area))
+        {
+            err() << "Failed to add image to texture atlas: the image is too big ("
+                  << rect.width << "x" << rect.height << ")" << std::endl;
+            return Region();
+        }
+    }
+
+    // Upload only the reserved area: the image surrounded by a transparent padding
+    if ((m_padding == 0) && (rect.width == imageWidth) && (rect.height == imageHeight))
+    {
+        page->texture.update(image, area.left, area.top);
+    }
+    else
+    {
+        std::vector<Uint8> pixels(width * height * 4, 0);
+        const Uint8* source = image.getPixelsPtr() + (rect.left + rect.top * imageWidth) * 4;
+        Uint8* destination = &pixels[0] + (m_padding + m_padding * width) * 4;
+        for (int i = 0; i < rect.height; ++i)
+        {
+            std::memcpy(destination, source, rect.width * 4);
+            source += imageWidth * 4;
+            destination += width * 4;
+        }
+        page->texture.update(&pixels[0], width, height, area.left, area.top);
+    }
+
+    Region region;
+    region.texture = &page->texture;
+    region.rect    = IntRect(area.left + m_padding, area.top + m_padding, rect.width, rect.height);
+
+    return region;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::clear()
+{
+    for (std::vector<Page*>::iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+        delete *it;
+
+    m_pages.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::getPageCount() const
+{
+    return static_cast<unsigned int>(m_pages.size());
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& TextureAtlas::getTexture(unsigned int index) const
+{
+    assert(index < m_pages.size());
+    return m_pages[index]->texture;
+}
+
+
+////////////////////////////////////////////////////////////
+float TextureAtlas::getOccupancy(unsigned int index) const
+{
+    assert(index < m_pages.size());
+    return m_pages[index]->packer.getOccupancy();
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::setSmooth(bool smooth)
+{
+    m_isSmooth = smooth;
+
+    for (std::vector<Page*>::iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+        (*it)->texture.setSmooth(smooth);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::isSmooth() const
+{
+    return m_isSmooth;
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::Page* TextureAtlas::createPage(unsigned int width, unsigned int height)
+{
+    // Make sure that the page fits the limits of the graphics card
+    unsigned int maxSize = Texture::getMaximumSize();
+    width  = std::min(width, maxSize);
+    height = std::min(height, maxSize);
+
+    // The contents of the page are left undefined, only the reserved areas are ever uploaded
+    Page* page = new Page;
+    if (!page->texture.create(width, height))
+    {
+        delete page;
+        return NULL;
+    }
+    page->texture.setSmooth(m_isSmooth);
+    page->packer.reset(width, height);
+
+    m_pages.push_back(page);
+
+    return page;
+}
+
+} // namespace sf
@@ -0,0 +1,542 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TextureContainer.hpp>
+#include <SFML/Graphics/TextureFormat.hpp>
+#include <SFML/Graphics/TextureSaver.hpp>
+#include <SFML/System/InputStream.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+
+namespace
+{
+    // Identifiers at the beginning of the files
+    const sf::Uint8 ddsMagic[4]  = {'D', 'D', 'S', ' '};
+    const sf::Uint8 ktxMagic[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+    const std::size_t magicSize  = sizeof(ktxMagic);
+
+    // Sizes of the headers
+    const std::size_t ddsHeaderSize      = 128;
+    const std::size_t ddsDx10HeaderSize  = 20;
+    const std::size_t ktxHeaderSize      = 64;
+
+    // Read a 32-bits integer stored in little-endian or, if swap is true, in big-endian byte order
+    sf::Uint32 readUint32(const sf::Uint8* bytes, bool swap = false)
+    {
+        sf::Uint32 b0 = bytes[0], b1 = bytes[1], b2 = bytes[2], b3 = bytes[3];
+        if (swap)
+            return (b0 << 24) | (b1 << 16) | (b2 << 8) | b3;
+        else
+            return b0 | (b1 << 8) | (b2 << 16) | (b3 << 24);
+    }
+
+    // Build a DDS four-character code
+    sf::Uint32 fourCC(const char* code)
+    {
+        return readUint32(reinterpret_cast<const sf::Uint8*>(code));
+    }
+
+    // Get the size of the blocks of a mipmap level, in bytes
+    std::size_t getLevelLength(const sf::Vector2u& size, unsigned int blockSize)
+    {
+        std::size_t columns = std::max(1u, (size.x + 3) / 4);
+        std::size_t rows    = std::max(1u, (size.y + 3) / 4);
+
+        return columns * rows * blockSize;
+    }
+
+    // Get the size of the next mipmap level
+    sf::Vector2u getNextLevelSize(const sf::Vector2u& size)
+    {
+        return sf::Vector2u(std::max(1u, size.x / 2), std::max(1u, size.y / 2));
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+TextureContainer::TextureContainer() :
+m_format (Texture::BC1),
+m_size   (0, 0),
+m_flipped(false),
+m_levels (),
+m_data   ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::isContainer(const void* data, std::size_t size)
+{
+    if (!data || (size < magicSize))
+        return false;
+
+    return (std::memcmp(data, ddsMagic, sizeof(ddsMagic)) == 0) ||
+           (std::memcmp(data, ktxMagic, sizeof(ktxMagic)) == 0);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::isContainerFile(const std::string& filename)
+{
+    Uint8 header[magicSize];
+    std::ifstream file(filename.c_str(), std::ios_base::binary);
+
+    return file.read(reinterpret_cast<char*>(header), magicSize) && isContainer(header, magicSize);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::isContainerStream(InputStream& stream)
+{
+    Uint8 header[magicSize];
+    stream.seek(0);
+    bool container = (stream.read(header, magicSize) == static_cast<Int64>(magicSize)) && isContainer(header, magicSize);
+    stream.seek(0);
+
+    return container;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::loadFromFile(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios_base::binary);
+    if (!file)
+    {
+        err() << "Failed to load texture \"" << filename << "\". Reason : Unable to open file" << std::endl;
+        return false;
+    }
+
+    // Read the whole file, the blocks are uploaded from where they are
+    file.seekg(0, std::ios_base::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios_base::beg);
+    m_data.resize(static_cast<std::size_t>(size));
+    if ((size <= 0) || !file.read(reinterpret_cast<char*>(&m_data[0]), size))
+    {
+        err() << "Failed to load texture \"" << filename << "\". Reason : Unable to read file" << std::endl;
+        return false;
+    }
+
+    if (!parse())
+    {
+        err() << "Failed to load texture \"" << filename << "\"" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::loadFromMemory(const void* data, std::size_t size)
+{
+    if (!data || !size)
+    {
+        err() << "Failed to load texture from memory, no data provided" << std::endl;
+        return false;
+    }
+
+    const Uint8* bytes = static_cast<const Uint8*>(data);
+    m_data.assign(bytes, bytes + size);
+
+    if (!parse())
+    {
+        err() << "Failed to load texture from memory" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::loadFromStream(InputStream& stream)
+{
+    // Make sure that the stream's reading position is at the beginning
+    stream.seek(0);
+
+    Int64 size = stream.getSize();
+    if (size > 0)
+    {
+        m_data.resize(static_cast<std::size_t>(size));
+        if (stream.read(&m_data[0], size) == size && parse())
+            return true;
+    }
+
+    err() << "Failed to load texture from stream" << std::endl;
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::loadFromTexture(const Texture& texture)
+{
+    m_format  = texture.m_format;
+    m_size    = texture.m_size;
+    m_flipped = texture.m_pixelsFlipped;
+    m_levels.clear();
+    m_data.clear();
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+    glCheck(glBindTexture(GL_TEXTURE_2D, texture.m_texture));
+
+    // Read the levels which are defined
+    GLint maxLevel = 0;
+    glCheck(glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel));
+    for (GLint i = 0; i <= maxLevel; ++i)
+    {
+        GLint width = 0, height = 0, length = 0;
+        glCheck(glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_WIDTH, &width));
+        glCheck(glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_HEIGHT, &height));
+        glCheck(glGetTexLevelParameteriv(GL_TEXTURE_2D, i, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &length));
+        if ((width <= 0) || (height <= 0) || (length <= 0))
+            break;
+
+        Level level;
+        level.size   = Vector2u(width, height);
+        level.offset = m_data.size();
+        level.length = static_cast<std::size_t>(length);
+        m_levels.push_back(level);
+
+        m_data.resize(level.offset + level.length);
+        glCheck(glGetCompressedTexImage(GL_TEXTURE_2D, i, &m_data[level.offset]));
+    }
+
+    return !m_levels.empty();
+}
+
+
+////////////////////////////////////////////////////////////
+Texture::PixelFormat TextureContainer::getFormat() const
+{
+    return m_format;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u TextureContainer::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::isFlipped() const
+{
+    return m_flipped;
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<TextureContainer::Level>& TextureContainer::getLevels() const
+{
+    return m_levels;
+}
+
+
+////////////////////////////////////////////////////////////
+const Uint8* TextureContainer::getBlocks(const Level& level) const
+{
+    return &m_data[level.offset];
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::parse()
+{
+    m_levels.clear();
+    m_flipped = false;
+
+    if (m_data.size() >= sizeof(ktxMagic) && (std::memcmp(&m_data[0], ktxMagic, sizeof(ktxMagic)) == 0))
+        return parseKtx();
+    else if (m_data.size() >= sizeof(ddsMagic) && (std::memcmp(&m_data[0], ddsMagic, sizeof(ddsMagic)) == 0))
+        return parseDds();
+
+    err() << "Unknown texture container" << std::endl;
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::parseDds()
+{
+    if (m_data.size() < ddsHeaderSize)
+    {
+        err() << "Invalid DDS file, truncated header" << std::endl;
+        return false;
+    }
+
+    const Uint8* header = &m_data[0];
+    Uint32 height      = readUint32(header + 12);
+    Uint32 width       = readUint32(header + 16);
+    Uint32 levelCount  = readUint32(header + 28);
+    Uint32 formatFlags = readUint32(header + 80);
+    Uint32 code        = readUint32(header + 84);
+    Uint32 caps2       = readUint32(header + 112);
+
+    // Only compressed 2D textures are supported
+    const Uint32 fourCCFlag = 0x4;
+    const Uint32 cubemapOrVolumeFlags = 0x200 | 0x200000;
+    if (!(formatFlags & fourCCFlag))
+    {
+        err() << "Unsupported DDS file, only compressed textures can be loaded" << std::endl;
+        return false;
+    }
+    if (caps2 & cubemapOrVolumeFlags)
+    {
+        err() << "Unsupported DDS file, only 2D textures can be loaded" << std::endl;
+        return false;
+    }
+
+    std::size_t offset = ddsHeaderSize;
+    if (code == fourCC("DXT1"))
+    {
+        m_format = Texture::BC1;
+    }
+    else if ((code == fourCC("DXT2")) || (code == fourCC("DXT3")))
+    {
+        m_format = Texture::BC2;
+    }
+    else if ((code == fourCC("DXT4")) || (code == fourCC("DXT5")))
+    {
+        m_format = Texture::BC3;
+    }
+    else if ((code == fourCC("ATI1")) || (code == fourCC("BC4U")))
+    {
+        m_format = Texture::BC4;
+    }
+    else if ((code == fourCC("ATI2")) || (code == fourCC("BC5U")))
+    {
+        m_format = Texture::BC5;
+    }
+    else if (code == fourCC("DX10"))
+    {
+        // The DXGI format is given by the extended header
+        if (m_data.size() < ddsHeaderSize + ddsDx10HeaderSize)
+        {
+            err() << "Invalid DDS file, truncated header" << std::endl;
+            return false;
+        }
+
+        Uint32 dxgiFormat = readUint32(header + ddsHeaderSize);
+        Uint32 dimension  = readUint32(header + ddsHeaderSize + 4);
+        Uint32 arraySize  = readUint32(header + ddsHeaderSize + 12);
+        offset += ddsDx10HeaderSize;
+
+        const Uint32 texture2D = 3;
+        if ((dimension != texture2D) || (arraySize > 1))
+        {
+            err() << "Unsupported DDS file, only 2D textures can be loaded" << std::endl;
+            return false;
+        }
+
+        // sRGB formats are loaded as their linear counterpart
+        switch (dxgiFormat)
+        {
+            case 71 : case 72 : m_format = Texture::BC1;  break;
+            case 74 : case 75 : m_format = Texture::BC2;  break;
+            case 77 : case 78 : m_format = Texture::BC3;  break;
+            case 80 :           m_format = Texture::BC4;  break;
+            case 83 :           m_format = Texture::BC5;  break;
+            case 95 :           m_format = Texture::BC6H; break;
+            case 98 : case 99 : m_format = Texture::BC7;  break;
+
+            default :
+                err() << "Unsupported DDS file, unknown DXGI format " << dxgiFormat << std::endl;
+                return false;
+        }
+    }
+    else
+    {
+        err() << "Unsupported DDS file, unknown compressed format" << std::endl;
+        return false;
+    }
+
+    // Compute the layout of the levels
+    m_size = Vector2u(width, height);
+    if ((m_size.x == 0) || (m_size.y == 0))
+    {
+        err() << "Invalid DDS file, empty texture" << std::endl;
+        return false;
+    }
+
+    unsigned int blockSize = getTextureFormat(m_format).blockSize;
+    Vector2u size = m_size;
+    for (Uint32 i = 0; i < std::max(levelCount, 1u); ++i)
+    {
+        Level level;
+        level.size   = size;
+        level.offset = offset;
+        level.length = getLevelLength(size, blockSize);
+        if (level.offset + level.length > m_data.size())
+        {
+            err() << "Invalid DDS file, truncated data" << std::endl;
+            return false;
+        }
+        m_levels.push_back(level);
+
+        offset += level.length;
+        size = getNextLevelSize(size);
+    }
+
+    // The rows of DDS files are stored from top to bottom, like SFML expects them
+    m_flipped = false;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::parseKtx()
+{
+    if (m_data.size() < ktxHeaderSize)
+    {
+        err() << "Invalid KTX file, truncated header" << std::endl;
+        return false;
+    }
+
+    // The file may have been written with a different endianness
+    const Uint8* header = &m_data[0];
+    bool swap = (readUint32(header + 12) != 0x04030201);
+    if (swap && (readUint32(header + 12, true) != 0x04030201))
+    {
+        err() << "Invalid KTX file, unknown endianness" << std::endl;
+        return false;
+    }
+
+    Uint32 type           = readUint32(header + 16, swap);
+    Uint32 internalFormat = readUint32(header + 28, swap);
+    Uint32 width          = readUint32(header + 36, swap);
+    Uint32 height         = readUint32(header + 40, swap);
+    Uint32 depth          = readUint32(header + 44, swap);
+    Uint32 arraySize      = readUint32(header + 48, swap);
+    Uint32 faceCount      = readUint32(header + 52, swap);
+    Uint32 levelCount     = readUint32(header + 56, swap);
+    Uint32 keyValueSize   = readUint32(header + 60, swap);
+
+    // Only compressed 2D textures are supported
+    if (type != 0)
+    {
+        err() << "Unsupported KTX file, only compressed textures can be loaded" << std::endl;
+        return false;
+    }
+    if ((height == 0) || (depth > 0) || (arraySize > 0) || (faceCount != 1))
+    {
+        err() << "Unsupported KTX file, only 2D textures can be loaded" << std::endl;
+        return false;
+    }
+
+    switch (internalFormat)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT :
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT :          m_format = Texture::BC1;      break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT :          m_format = Texture::BC2;      break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT :          m_format = Texture::BC3;      break;
+        case GL_COMPRESSED_RED_RGTC1 :                   m_format = Texture::BC4;      break;
+        case GL_COMPRESSED_RG_RGTC2 :                    m_format = Texture::BC5;      break;
+        case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB : m_format = Texture::BC6H;     break;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM_ARB :         m_format = Texture::BC7;      break;
+        case GL_COMPRESSED_RGB8_ETC2 :                   m_format = Texture::ETC2RGB;  break;
+        case GL_COMPRESSED_RGBA8_ETC2_EAC :              m_format = Texture::ETC2RGBA; break;
+
+        default :
+            err() << "Unsupported KTX file, unknown compressed format 0x" << std::hex << internalFormat << std::dec << std::endl;
+            return false;
+    }
+
+    // Look for the orientation of the rows in the key/value pairs; like the usual
+    // tools, we assume that they are stored from top to bottom when it is not given
+    std::size_t offset = ktxHeaderSize;
+    std::size_t keyValueEnd = offset + keyValueSize;
+    if (keyValueEnd > m_data.size())
+    {
+        err() << "Invalid KTX file, truncated header" << std::endl;
+        return false;
+    }
+    while (offset + 4 <= keyValueEnd)
+    {
+        Uint32 pairSize = readUint32(&m_data[offset], swap);
+        offset += 4;
+        if (pairSize > keyValueEnd - offset)
+            break;
+
+        const char* pair = reinterpret_cast<const char*>(&m_data[offset]);
+        const char key[] = "KTXorientation";
+        if ((pairSize > sizeof(key)) && (std::memcmp(pair, key, sizeof(key)) == 0))
+        {
+            std::string value(pair + sizeof(key), pairSize - sizeof(key));
+            m_flipped = (value.find("T=u") != std::string::npos);
+        }
+
+        // Pairs are padded to a multiple of 4 bytes
+        offset += (pairSize + 3) & ~3u;
+    }
+    offset = keyValueEnd;
+
+    // Compute the layout of the levels, each one is preceded by its size
+    m_size = Vector2u(width, height);
+    unsigned int blockSize = getTextureFormat(m_format).blockSize;
+    Vector2u size = m_size;
+    for (Uint32 i = 0; i < std::max(levelCount, 1u); ++i)
+    {
+        if (offset + 4 > m_data.size())
+        {
+            err() << "Invalid KTX file, truncated data" << std::endl;
+            return false;
+        }
+
+        Level level;
+        level.size   = size;
+        level.offset = offset + 4;
+        level.length = readUint32(&m_data[offset], swap);
+        if ((level.length < getLevelLength(size, blockSize)) || (level.offset + level.length > m_data.size()))
+        {
+            err() << "Invalid KTX file, truncated data" << std::endl;
+            return false;
+        }
+        m_levels.push_back(level);
+
+        offset = level.offset + ((level.length + 3) & ~static_cast<std::size_t>(3));
+        size = getNextLevelSize(size);
+    }
+
+    return true;
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_TEXTURECONTAINER_HPP
+#define SFML_TEXTURECONTAINER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+
+namespace sf
+{
+class InputStream;
+
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Compressed texture read from a DDS or KTX file
+///
+/// The blocks of the texture and of its mipmap levels are
+/// kept as they are stored in the file, ready to be given
+/// to glCompressedTexImage2D.
+///
+////////////////////////////////////////////////////////////
+class TextureContainer
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mipmap level of the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Level
+    {
+        Vector2u    size;   ///< Size of the level, in pixels
+        std::size_t offset; ///< Offset of the blocks of the level in the data
+        std::size_t length; ///< Size of the blocks of the level, in bytes
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureContainer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether some data starts with a DDS or KTX header
+    ///
+    /// \param data Pointer to the data
+    /// \param size Size of the data, in bytes
+    ///
+    /// \return True if the data is a texture container
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isContainer(const void* data, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a file is a DDS or KTX file
+    ///
+    /// \param filename Path of the file
+    ///
+    /// \return True if the file is a texture container
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isContainerFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a stream contains a DDS or KTX file
+    ///
+    /// \param stream Stream to check, rewound to its beginning
+    ///
+    /// \return True if the stream contains a texture container
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isContainerStream(InputStream& stream);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the texture from a DDS or KTX file
+    ///
+    /// \param filename Path of the file
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the texture from a DDS or KTX file in memory
+    ///
+    /// \param data Pointer to the file data in memory
+    /// \param size Size of the data, in bytes
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromMemory(const void* data, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the texture from a DDS or KTX file in a stream
+    ///
+    /// \param stream Source stream to read from
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromStream(InputStream& stream);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read back the blocks of a compressed texture
+    ///
+    /// An OpenGL context must be active.
+    ///
+    /// \param texture Compressed texture to read
+    ///
+    /// \return True if reading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromTexture(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the compressed pixel format of the texture
+    ///
+    /// \return Pixel format
+    ///
+    ////////////////////////////////////////////////////////////
+    Texture::PixelFormat getFormat() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the texture
+    ///
+    /// \return Size of the first level, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the rows are stored from bottom to top
+    ///
+    /// \return True if the texture is flipped vertically
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isFlipped() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the mipmap levels of the texture
+    ///
+    /// \return Levels, from the largest to the smallest
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Level>& getLevels() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the blocks of a level
+    ///
+    /// \param level Level returned by getLevels
+    ///
+    /// \return Pointer to the blocks of the level
+    ///
+    ////////////////////////////////////////////////////////////
+    const Uint8* getBlocks(const Level& level) const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Parse the header of the DDS file stored in the data
+    ///
+    /// \return True if the file is valid and supported
+    ///
+    ////////////////////////////////////////////////////////////
+    bool parseDds();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Parse the header of the KTX file stored in the data
+    ///
+    /// \return True if the file is valid and supported
+    ///
+    ////////////////////////////////////////////////////////////
+    bool parseKtx();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Parse the file stored in the data
+    ///
+    /// \return True if the file is valid and supported
+    ///
+    ////////////////////////////////////////////////////////////
+    bool parse();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Texture::PixelFormat m_format;  ///< Compressed pixel format
+    Vector2u             m_size;    ///< Size of the first level, in pixels
+    bool                 m_flipped; ///< Are the rows stored from bottom to top?
+    std::vector<Level>   m_levels;  ///< Mipmap levels, from the largest to the smallest
+    std::vector<Uint8>   m_data;    ///< Contents of the file, or blocks read back from a texture
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_TEXTURECONTAINER_HPP
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TextureFormat.hpp>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+TextureFormat getTextureFormat(Texture::PixelFormat format)
+{
+    TextureFormat result;
+    result.pixelFormat = GL_RGBA;
+    result.blockSize   = 0;
+
+    switch (format)
+    {
+        case Texture::R8 :
+            result.internalFormat = GL_R8;
+            result.pixelFormat    = GL_RED;
+            break;
+
+        case Texture::RG8 :
+            result.internalFormat = GL_RG8;
+            result.pixelFormat    = GL_RG;
+            break;
+
+        case Texture::RGBA16F :
+            result.internalFormat = GL_RGBA16F_ARB;
+            result.pixelFormat    = GL_RGBA;
+            break;
+
+        case Texture::RGBA32F :
+            result.internalFormat = GL_RGBA32F_ARB;
+            result.pixelFormat    = GL_RGBA;
+            break;
+
+        case Texture::Depth :
+            result.internalFormat = GL_DEPTH_COMPONENT24;
+            result.pixelFormat    = GL_DEPTH_COMPONENT;
+            break;
+
+        case Texture::BC1 :
+            result.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+            result.blockSize      = 8;
+            break;
+
+        case Texture::BC2 :
+            result.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+            result.blockSize      = 16;
+            break;
+
+        case Texture::BC3 :
+            result.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            result.blockSize      = 16;
+            break;
+
+        case Texture::BC4 :
+            result.internalFormat = GL_COMPRESSED_RED_RGTC1;
+            result.blockSize      = 8;
+            break;
+
+        case Texture::BC5 :
+            result.internalFormat = GL_COMPRESSED_RG_RGTC2;
+            result.blockSize      = 16;
+            break;
+
+        case Texture::BC6H :
+            result.internalFormat = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB;
+            result.blockSize      = 16;
+            break;
+
+        case Texture::BC7 :
+            result.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM_ARB;
+            result.blockSize      = 16;
+            break;
+
+        case Texture::ETC2RGB :
+            result.internalFormat = GL_COMPRESSED_RGB8_ETC2;
+            result.blockSize      = 8;
+            break;
+
+        case Texture::ETC2RGBA :
+            result.internalFormat = GL_COMPRESSED_RGBA8_ETC2_EAC;
+            result.blockSize      = 16;
+            break;
+
+        default :
+        case Texture::RGBA8 :
+            result.internalFormat = GL_RGBA8;
+            result.pixelFormat    = GL_RGBA;
+            break;
+    }
+
+    return result;
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_TEXTUREFORMAT_HPP
+#define SFML_TEXTUREFORMAT_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief OpenGL description of a texture pixel format
+///
+////////////////////////////////////////////////////////////
+struct TextureFormat
+{
+    GLint        internalFormat; ///< Format of the pixels in the texture storage
+    GLenum       pixelFormat;    ///< Components of the pixels exchanged with the client
+    unsigned int blockSize;      ///< Size of a 4x4 block of pixels in bytes, 0 for uncompressed formats
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Get the OpenGL description of a texture pixel format
+///
+/// \param format Pixel format of the texture
+///
+/// \return OpenGL formats corresponding to \a format
+///
+////////////////////////////////////////////////////////////
+TextureFormat getTextureFormat(Texture::PixelFormat format);
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_TEXTUREFORMAT_HPP
@@ -0,0 +1,311 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TextureReadback.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Graphics/TextureSaver.hpp>
+#include <cstring>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+TextureReadback::TextureReadback() :
+m_buffer    (0),
+m_fence     (NULL),
+m_pixels    (),
+m_size      (0, 0),
+m_actualSize(0, 0),
+m_depth     (false),
+m_flipped   (false),
+m_started   (false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TextureReadback::~TextureReadback()
+{
+    if (m_buffer || m_fence)
+    {
+        ensureGlContext();
+
+        releaseFence();
+
+        if (m_buffer)
+        {
+            GLuint buffer = static_cast<GLuint>(m_buffer);
+            glCheck(glDeleteBuffersARB(1, &buffer));
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureReadback::start(const Texture& texture)
+{
+    // Easy case: empty texture
+    if (!texture.m_texture)
+        return false;
+
+    ensureGlContext();
+
+    // Discard the previous transfer
+    releaseFence();
+    m_started = false;
+
+    // Remember the layout of the texture, it may change before the pixels are retrieved
+    m_size       = texture.m_size;
+    m_actualSize = texture.m_actualSize;
+    m_depth      = (texture.m_format == Texture::Depth);
+    m_flipped    = texture.m_pixelsFlipped;
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+    glCheck(glBindTexture(GL_TEXTURE_2D, texture.m_texture));
+
+    // Depth textures can't be read as RGBA: read their depth as a single byte per pixel,
+    // without row padding, and expand it to gray levels when the pixels are retrieved
+    GLenum format = m_depth ? GL_DEPTH_COMPONENT : GL_RGBA;
+    std::size_t storageSize = m_actualSize.x * m_actualSize.y * getPixelSize();
+    if (m_depth)
+        glCheck(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+
+    if (isAvailable())
+    {
+        // Create the pixel buffer if it doesn't exist yet
+        if (!m_buffer)
+        {
+            GLuint buffer;
+            glCheck(glGenBuffersARB(1, &buffer));
+            m_buffer = static_cast<unsigned int>(buffer);
+        }
+
+        // Start the transfer from the texture to the pixel buffer, it is performed in the background
+        glCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_buffer));
+        glCheck(glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, storageSize, NULL, GL_STREAM_READ_ARB));
+        glCheck(glGetTexImage(GL_TEXTURE_2D, 0, format, GL_UNSIGNED_BYTE, NULL));
+        glCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0));
+
+        // Insert a fence, to know when the transfer is complete
+        m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    else
+    {
+        // Pixel buffers are not supported: download the pixels now
+        m_pixels.resize(storageSize);
+        glCheck(glGetTexImage(GL_TEXTURE_2D, 0, format, GL_UNSIGNED_BYTE, &m_pixels[0]));
+    }
+
+    if (m_depth)
+        glCheck(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+
+    m_started = true;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureReadback::isStarted() const
+{
+    return m_started;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureReadback::isReady() const
+{
+    if (!m_started)
+        return false;
+
+    // Synchronous downloads are always ready
+    if (!m_fence)
+        return true;
+
+    ensureGlContext();
+
+    // Poll the fence without waiting; flush the commands so that it is eventually signaled
+    GLenum status = glClientWaitSync(static_cast<GLsync>(m_fence), GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if ((status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED))
+    {
+        releaseFence();
+        return true;
+    }
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u TextureReadback::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureReadback::copyTo(Uint8* pixels)
+{
+    if (!m_started || !pixels)
+        return false;
+
+    if (m_pixels.empty())
+    {
+        ensureGlContext();
+
+        // Mapping the buffer waits for the transfer if it is not complete yet
+        bool success = false;
+        glCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_buffer));
+        const Uint8* source = static_cast<const Uint8*>(glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB));
+        if (source)
+        {
+            copyVisiblePixels(source, pixels);
+            glCheck(glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB));
+            success = true;
+        }
+        glCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0));
+
+        releaseFence();
+        m_started = false;
+
+        return success;
+    }
+    else
+    {
+        copyVisiblePixels(&m_pixels[0], pixels);
+        m_pixels.clear();
+        m_started = false;
+
+        return true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureReadback::copyTo(Image& image)
+{
+    if (!m_started)
+        return false;
+
+    image.cancelLoad();
+    image.releasePixels();
+    image.m_size = m_size;
+
+    // Pixels downloaded synchronously which need no adjustment can be given to the image as is
+    if (!m_pixels.empty() && (m_size == m_actualSize) && !m_flipped && !m_depth)
+    {
+        image.m_pixels.swap(m_pixels);
+        m_pixels.clear();
+        m_started = false;
+        return true;
+    }
+
+    // Write the pixels directly into the image
+    image.m_pixels.resize(m_size.x * m_size.y * 4);
+    return copyTo(&image.m_pixels[0]);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureReadback::isAvailable()
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    return GLEW_ARB_pixel_buffer_object && GLEW_ARB_sync;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureReadback::copyVisiblePixels(const Uint8* source, Uint8* destination) const
+{
+    int srcPitch = m_actualSize.x * getPixelSize();
+    int dstPitch = m_size.x * 4;
+
+    // Texture is not padded nor flipped, we can use a direct copy
+    if ((m_size == m_actualSize) && !m_flipped && !m_depth)
+    {
+        std::memcpy(destination, source, dstPitch * m_size.y);
+        return;
+    }
+
+    // Handle the case where source pixels are flipped vertically
+    if (m_flipped)
+    {
+        source += srcPitch * (m_size.y - 1);
+        srcPitch = -srcPitch;
+    }
+
+    // Copy the useful pixels, row by row
+    for (unsigned int i = 0; i < m_size.y; ++i)
+    {
+        if (m_depth)
+        {
+            // Expand the depth values to opaque gray levels
+            Uint8* pixel = destination;
+            for (unsigned int j = 0; j < m_size.x; ++j)
+            {
+                *pixel++ = source[j];
+                *pixel++ = source[j];
+                *pixel++ = source[j];
+                *pixel++ = 255;
+            }
+        }
+        else
+        {
+            std::memcpy(destination, source, dstPitch);
+        }
+        source += srcPitch;
+        destination += dstPitch;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureReadback::getPixelSize() const
+{
+    return m_depth ? 1 : 4;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureReadback::releaseFence() const
+{
+    if (m_fence)
+    {
+        glCheck(glDeleteSync(static_cast<GLsync>(m_fence)));
+        m_fence = NULL;
+    }
+}
+
+} // namespace sf
@@ -0,0 +1,426 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TileMap.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+
+namespace
+{
+    // Slot of the tiles which have no quad in their chunk
+    const sf::Uint16 noQuad = 0xFFFF;
+
+    // Maximum size of a chunk, so that the quads of a chunk can be numbered with 16 bits
+    const unsigned int maxChunkSize = 255;
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+struct TileMap::Chunk
+{
+    Chunk() : buffer(Quads, VertexBuffer::Static), vertices(), quads(), quadCount(0), lastFrame(0), needUpdate(true) {}
+
+    VertexBuffer        buffer;     ///< Geometry of the chunk in graphics memory
+    std::vector<Vertex> vertices;   ///< Geometry of the chunk, if vertex buffers are not available
+    std::vector<Uint16> quads;      ///< Index of the quad of each tile of the chunk, or noQuad
+    unsigned int        quadCount;  ///< Number of quads of the chunk
+    Uint64              lastFrame;  ///< Last frame in which the chunk was drawn
+    bool                needUpdate; ///< Must the geometry be rebuilt?
+};
+
+
+////////////////////////////////////////////////////////////
+TileMap::TileMap() :
+m_size      (0, 0),
+m_tileSize  (0, 0),
+m_chunkSize (0),
+m_chunkCount(0, 0),
+m_tileset   (NULL),
+m_tiles     (),
+m_chunks    (),
+m_cached    (),
+m_vertices  (),
+m_cacheSize (1024),
+m_frame     (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TileMap::TileMap(const TileMap& copy) :
+Drawable     (copy),
+Transformable(copy),
+m_size       (copy.m_size),
+m_tileSize   (copy.m_tileSize),
+m_chunkSize  (copy.m_chunkSize),
+m_chunkCount (copy.m_chunkCount),
+m_tileset    (copy.m_tileset),
+m_tiles      (copy.m_tiles),
+m_chunks     (copy.m_chunks.size(), NULL),
+m_cached     (),
+m_vertices   (),
+m_cacheSize  (copy.m_cacheSize),
+m_frame      (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TileMap::~TileMap()
+{
+    releaseChunks();
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::create(unsigned int width, unsigned int height, const Vector2u& tileSize, unsigned int chunkSize)
+{
+    releaseChunks();
+
+    m_size       = Vector2u(width, height);
+    m_tileSize   = tileSize;
+    m_chunkSize  = std::max(1u, std::min(chunkSize, maxChunkSize));
+    m_chunkCount = Vector2u((width + m_chunkSize - 1) / m_chunkSize, (height + m_chunkSize - 1) / m_chunkSize);
+    m_tiles.assign(static_cast<std::size_t>(width) * height, static_cast<Uint32>(EmptyTile));
+    m_chunks.assign(static_cast<std::size_t>(m_chunkCount.x) * m_chunkCount.y, NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u TileMap::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u TileMap::getTileSize() const
+{
+    return m_tileSize;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TileMap::getChunkSize() const
+{
+    return m_chunkSize;
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::setTileset(const Texture& texture)
+{
+    if (m_tileset != &texture)
+    {
+        m_tileset = &texture;
+
+        // The texture coordinates of all the tiles depend on the tileset
+        for (std::vector<std::size_t>::const_iterator it = m_cached.begin(); it != m_cached.end(); ++it)
+            m_chunks[*it]->needUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture* TileMap::getTileset() const
+{
+    return m_tileset;
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::setTile(unsigned int x, unsigned int y, Uint32 tile)
+{
+    if ((x >= m_size.x) || (y >= m_size.y))
+        return;
+
+    Uint32& current = m_tiles[static_cast<std::size_t>(y) * m_size.x + x];
+    if (current == tile)
+        return;
+
+    bool hadQuad = (current != EmptyTile);
+    current = tile;
+
+    // Nothing to do if the chunk is not cached, or if it must be rebuilt anyway
+    Chunk* chunk = m_chunks[static_cast<std::size_t>(y / m_chunkSize) * m_chunkCount.x + x / m_chunkSize];
+    if (!chunk || chunk->needUpdate)
+        return;
+
+    // Adding or removing a quad changes the layout of the chunk: rebuild it when it's drawn
+    if (!hadQuad || (tile == EmptyTile))
+    {
+        chunk->needUpdate = true;
+        return;
+    }
+
+    // Otherwise patch the quad of the tile in place
+    Uint16 quad = chunk->quads[(y % m_chunkSize) * m_chunkSize + x % m_chunkSize];
+    Vertex vertices[4];
+    buildQuad(x, y, tile, vertices);
+    if (chunk->vertices.empty())
+        chunk->buffer.update(vertices, 4, quad * 4);
+    else
+        std::copy(vertices, vertices + 4, chunk->vertices.begin() + quad * 4);
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 TileMap::getTile(unsigned int x, unsigned int y) const
+{
+    if ((x >= m_size.x) || (y >= m_size.y))
+        return EmptyTile;
+
+    return m_tiles[static_cast<std::size_t>(y) * m_size.x + x];
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::setTiles(const Uint32* tiles)
+{
+    if (tiles && !m_tiles.empty())
+    {
+        std::copy(tiles, tiles + m_tiles.size(), m_tiles.begin());
+
+        for (std::vector<std::size_t>::const_iterator it = m_cached.begin(); it != m_cached.end(); ++it)
+            m_chunks[*it]->needUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::setCacheSize(std::size_t chunkCount)
+{
+    m_cacheSize = chunkCount;
+    trimCache();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TileMap::getCacheSize() const
+{
+    return m_cacheSize;
+}
+
+
+////////////////////////////////////////////////////////////
+FloatRect TileMap::getLocalBounds() const
+{
+    return FloatRect(0.f, 0.f, static_cast<float>(m_size.x * m_tileSize.x), static_cast<float>(m_size.y * m_tileSize.y));
+}
+
+
+////////////////////////////////////////////////////////////
+FloatRect TileMap::getGlobalBounds() const
+{
+    return getTransform().transformRect(getLocalBounds());
+}
+
+
+////////////////////////////////////////////////////////////
+TileMap& TileMap::operator =(const TileMap& right)
+{
+    TileMap temp(right);
+
+    std::swap(static_cast<Transformable&>(*this), static_cast<Transformable&>(temp));
+    std::swap(m_size,       temp.m_size);
+    std::swap(m_tileSize,   temp.m_tileSize);
+    std::swap(m_chunkSize,  temp.m_chunkSize);
+    std::swap(m_chunkCount, temp.m_chunkCount);
+    std::swap(m_tileset,    temp.m_tileset);
+    std::swap(m_tiles,      temp.m_tiles);
+    std::swap(m_chunks,     temp.m_chunks);
+    std::swap(m_cached,     temp.m_cached);
+    std::swap(m_cacheSize,  temp.m_cacheSize);
+    std::swap(m_frame,      temp.m_frame);
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::draw(RenderTarget& target, RenderStates states) const
+{
+    if (m_chunks.empty() || (m_tileSize.x == 0) || (m_tileSize.y == 0))
+        return;
+
+    m_frame++;
+
+    states.transform *= getTransform();
+    states.texture = m_tileset;
+
+    // Compute the area of the map covered by the view
+    const View& view = target.getView();
+    FloatRect area = view.getInverseTransform().transformRect(FloatRect(-1, -1, 2, 2));
+    area = states.transform.getInverse().transformRect(area);
+
+    // Get the range of chunks that it overlaps
+    float chunkWidth  = static_cast<float>(m_chunkSize * m_tileSize.x);
+    float chunkHeight = static_cast<float>(m_chunkSize * m_tileSize.y);
+    float left   = std::max(0.f, std::floor(area.left / chunkWidth));
+    float top    = std::max(0.f, std::floor(area.top / chunkHeight));
+    float right  = std::min(static_cast<float>(m_chunkCount.x), std::floor((area.left + area.width) / chunkWidth) + 1);
+    float bottom = std::min(static_cast<float>(m_chunkCount.y), std::floor((area.top + area.height) / chunkHeight) + 1);
+
+    // Draw the visible chunks, building the ones that are not cached
+    for (unsigned int y = static_cast<unsigned int>(top); y < bottom; ++y)
+    {
+        for (unsigned int x = static_cast<unsigned int>(left); x < right; ++x)
+        {
+            std::size_t index = static_cast<std::size_t>(y) * m_chunkCount.x + x;
+            if (!m_chunks[index] || m_chunks[index]->needUpdate)
+                buildChunk(index);
+
+            Chunk& chunk = *m_chunks[index];
+            chunk.lastFrame = m_frame;
+
+            if (!chunk.vertices.empty())
+                target.draw(&chunk.vertices[0], chunk.quadCount * 4, Quads, states);
+            else if (chunk.quadCount > 0)
+                target.draw(chunk.buffer, 0, chunk.quadCount * 4, states);
+        }
+    }
+
+    trimCache();
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::buildQuad(unsigned int x, unsigned int y, Uint32 tile, Vertex* quad) const
+{
+    // Find the tile in the tileset
+    unsigned int columns = m_tileset ? std::max(1u, m_tileset->getSize().x / m_tileSize.x) : 1;
+    float u = static_cast<float>((tile % columns) * m_tileSize.x);
+    float v = static_cast<float>((tile / columns) * m_tileSize.y);
+
+    float left   = static_cast<float>(x * m_tileSize.x);
+    float top    = static_cast<float>(y * m_tileSize.y);
+    float width  = static_cast<float>(m_tileSize.x);
+    float height = static_cast<float>(m_tileSize.y);
+
+    quad[0] = Vertex(Vector2f(left,         top),          Vector2f(u,         v));
+    quad[1] = Vertex(Vector2f(left + width, top),          Vector2f(u + width, v));
+    quad[2] = Vertex(Vector2f(left + width, top + height), Vector2f(u + width, v + height));
+    quad[3] = Vertex(Vector2f(left,         top + height), Vector2f(u,         v + height));
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::buildChunk(std::size_t index) const
+{
+    Chunk*& chunk = m_chunks[index];
+    if (!chunk)
+    {
+        chunk = new Chunk;
+        m_cached.push_back(index);
+    }
+
+    // Gather the quads of the non-empty tiles of the chunk
+    unsigned int firstX = static_cast<unsigned int>(index % m_chunkCount.x) * m_chunkSize;
+    unsigned int firstY = static_cast<unsigned int>(index / m_chunkCount.x) * m_chunkSize;
+    unsigned int lastX  = std::min(firstX + m_chunkSize, m_size.x);
+    unsigned int lastY  = std::min(firstY + m_chunkSize, m_size.y);
+
+    m_vertices.clear();
+    chunk->quads.assign(m_chunkSize * m_chunkSize, noQuad);
+    chunk->quadCount = 0;
+    for (unsigned int y = firstY; y < lastY; ++y)
+    {
+        for (unsigned int x = firstX; x < lastX; ++x)
+        {
+            Uint32 tile = m_tiles[static_cast<std::size_t>(y) * m_size.x + x];
+            if (tile != EmptyTile)
+            {
+                chunk->quads[(y - firstY) * m_chunkSize + (x - firstX)] = static_cast<Uint16>(chunk->quadCount++);
+                m_vertices.resize(m_vertices.size() + 4);
+                buildQuad(x, y, tile, &m_vertices[m_vertices.size() - 4]);
+            }
+        }
+    }
+
+    // Upload them to graphics memory, or keep them in system memory if vertex buffers are not supported
+    chunk->vertices.clear();
+    if (!m_vertices.empty())
+    {
+        if (!VertexBuffer::isAvailable() || !chunk->buffer.create(static_cast<unsigned int>(m_vertices.size())) ||
+            !chunk->buffer.update(&m_vertices[0]))
+            chunk->vertices = m_vertices;
+    }
+
+    chunk->needUpdate = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::trimCache() const
+{
+    if (m_cached.size() <= m_cacheSize)
+        return;
+
+    // Sort the cached chunks from the most to the least recently drawn
+    std::vector<std::pair<Uint64, std::size_t> > chunks;
+    chunks.reserve(m_cached.size());
+    for (std::vector<std::size_t>::const_iterator it = m_cached.begin(); it != m_cached.end(); ++it)
+        chunks.push_back(std::make_pair(m_chunks[*it]->lastFrame, *it));
+    std::sort(chunks.begin(), chunks.end(), std::greater<std::pair<Uint64, std::size_t> >());
+
+    // Release the oldest ones, but never the ones drawn in the current frame
+    m_cached.clear();
+    for (std::size_t i = 0; i < chunks.size(); ++i)
+    {
+        if ((i < m_cacheSize) || (chunks[i].first == m_frame))
+        {
+            m_cached.push_back(chunks[i].second);
+        }
+        else
+        {
+            delete m_chunks[chunks[i].second];
+            m_chunks[chunks[i].second] = NULL;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::releaseChunks()
+{
+    for (std::vector<std::size_t>::const_iterator it = m_cached.begin(); it != m_cached.end(); ++it)
+    {
+        delete m_chunks[*it];
+        m_chunks[*it] = NULL;
+    }
+    m_cached.clear();
+}
+
+} // namespace sf
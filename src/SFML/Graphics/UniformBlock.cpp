@@ -0,0 +1,274 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/UniformBlock.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+
+namespace
+{
+    // Binding points assigned to the block names so far
+    typedef std::map<std::string, unsigned int> BindingPointTable;
+    BindingPointTable bindingPoints;
+    sf::Mutex bindingPointsMutex;
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+UniformBlock::UniformBlock() :
+m_name        (),
+m_bindingPoint(0),
+m_buffer      (0),
+m_data        (),
+m_dirtyBegin  (0),
+m_dirtyEnd    (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+UniformBlock::~UniformBlock()
+{
+    if (m_buffer)
+    {
+        ensureGlContext();
+
+        GLuint buffer = static_cast<GLuint>(m_buffer);
+        glCheck(glDeleteBuffersARB(1, &buffer));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool UniformBlock::create(const std::string& name, std::size_t size)
+{
+    // Check if uniform blocks are supported
+    if (!isAvailable())
+    {
+        err() << "Failed to create uniform block \"" << name << "\": your system doesn't support uniform buffer objects" << std::endl;
+        return false;
+    }
+
+    // Check the parameters
+    if (size == 0)
+    {
+        err() << "Failed to create uniform block \"" << name << "\": invalid size (" << size << ")" << std::endl;
+        return false;
+    }
+
+    ensureGlContext();
+
+    // Check the binding point against the limits of the system
+    unsigned int bindingPoint = getBindingPoint(name);
+    GLint maxBindings = 0;
+    glCheck(glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindings));
+    if (bindingPoint >= static_cast<unsigned int>(maxBindings))
+    {
+        err() << "Failed to create uniform block \"" << name << "\": the maximum number of uniform blocks ("
+              << maxBindings << ") has been reached" << std::endl;
+        return false;
+    }
+
+    // Create the OpenGL buffer if it doesn't exist yet
+    if (!m_buffer)
+    {
+        GLuint buffer;
+        glCheck(glGenBuffersARB(1, &buffer));
+        m_buffer = static_cast<unsigned int>(buffer);
+    }
+
+    // Allocate the storage, initialized to zero
+    m_data.assign(size, 0);
+    glCheck(glBindBufferARB(GL_UNIFORM_BUFFER, m_buffer));
+    glCheck(glBufferDataARB(GL_UNIFORM_BUFFER, size, &m_data[0], GL_DYNAMIC_DRAW_ARB));
+    glCheck(glBindBufferARB(GL_UNIFORM_BUFFER, 0));
+
+    m_name         = name;
+    m_bindingPoint = bindingPoint;
+    m_dirtyBegin   = 0;
+    m_dirtyEnd     = 0;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void UniformBlock::setData(std::size_t offset, const void* data, std::size_t size)
+{
+    if (!data || (size == 0) || (offset + size > m_data.size()))
+        return;
+
+    // Nothing to do if the values didn't change
+    if (std::memcmp(&m_data[offset], data, size) == 0)
+        return;
+
+    std::memcpy(&m_data[offset], data, size);
+
+    // Extend the range of bytes to upload
+    if (m_dirtyBegin == m_dirtyEnd)
+    {
+        m_dirtyBegin = offset;
+        m_dirtyEnd   = offset + size;
+    }
+    else
+    {
+        m_dirtyBegin = std::min(m_dirtyBegin, offset);
+        m_dirtyEnd   = std::max(m_dirtyEnd, offset + size);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void UniformBlock::setParameter(std::size_t offset, float x)
+{
+    setData(offset, &x, sizeof(x));
+}
+
+
+////////////////////////////////////////////////////////////
+void UniformBlock::setParameter(std::size_t offset, const Vector2f& vector)
+{
+    float values[2] = {vector.x, vector.y};
+    setData(offset, values, sizeof(values));
+}
+
+
+////////////////////////////////////////////////////////////
+void UniformBlock::setParameter(std::size_t offset, const Vector3f& vector)
+{
+    float values[3] = {vector.x, vector.y, vector.z};
+    setData(offset, values, sizeof(values));
+}
+
+
+////////////////////////////////////////////////////////////
+void UniformBlock::setParameter(std::size_t offset, const Color& color)
+{
+    float values[4] = {color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f};
+    setData(offset, values, sizeof(values));
+}
+
+
+////////////////////////////////////////////////////////////
+void UniformBlock::setParameter(std::size_t offset, const Transform& transform)
+{
+    setData(offset, transform.getMatrix(), 16 * sizeof(float));
+}
+
+
+////////////////////////////////////////////////////////////
+const std::string& UniformBlock::getName() const
+{
+    return m_name;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t UniformBlock::getSize() const
+{
+    return m_data.size();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int UniformBlock::getBindingPoint() const
+{
+    return m_bindingPoint;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int UniformBlock::getNativeHandle() const
+{
+    return m_buffer;
+}
+
+
+////////////////////////////////////////////////////////////
+void UniformBlock::bind(const UniformBlock* block)
+{
+    ensureGlContext();
+
+    if (block && block->m_buffer)
+    {
+        block->upload();
+        glCheck(glBindBufferBase(GL_UNIFORM_BUFFER, block->m_bindingPoint, block->m_buffer));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int UniformBlock::getBindingPoint(const std::string& name)
+{
+    Lock lock(bindingPointsMutex);
+
+    BindingPointTable::const_iterator it = bindingPoints.find(name);
+    if (it != bindingPoints.end())
+        return it->second;
+
+    unsigned int bindingPoint = static_cast<unsigned int>(bindingPoints.size());
+    bindingPoints.insert(std::make_pair(name, bindingPoint));
+
+    return bindingPoint;
+}
+
+
+////////////////////////////////////////////////////////////
+bool UniformBlock::isAvailable()
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    return GLEW_ARB_uniform_buffer_object != 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void UniformBlock::upload() const
+{
+    if (m_dirtyBegin == m_dirtyEnd)
+        return;
+
+    glCheck(glBindBufferARB(GL_UNIFORM_BUFFER, m_buffer));
+    glCheck(glBufferSubDataARB(GL_UNIFORM_BUFFER, m_dirtyBegin, m_dirtyEnd - m_dirtyBegin, &m_data[m_dirtyBegin]));
+
+    m_dirtyBegin = 0;
+    m_dirtyEnd   = 0;
+}
+
+} // namespace sf
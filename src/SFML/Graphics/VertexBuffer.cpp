@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <vector>
+
+
+namespace
+{
+    // Convert a usage hint to its OpenGL equivalent
+    GLenum usageToGlEnum(sf::VertexBuffer::Usage usage)
+    {
+        switch (usage)
+        {
+            case sf::VertexBuffer::Static :  return GL_STATIC_DRAW_ARB;
+            case sf::VertexBuffer::Dynamic : return GL_DYNAMIC_DRAW_ARB;
+            default :                        return GL_STREAM_DRAW_ARB;
+        }
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+VertexBuffer::VertexBuffer() :
+m_buffer       (0),
+m_size         (0),
+m_primitiveType(Points),
+m_usage        (Stream)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+VertexBuffer::VertexBuffer(PrimitiveType type, Usage usage) :
+m_buffer       (0),
+m_size         (0),
+m_primitiveType(type),
+m_usage        (usage)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+VertexBuffer::VertexBuffer(const VertexBuffer& copy) :
+Drawable       (),
+GlResource     (),
+m_buffer       (0),
+m_size         (0),
+m_primitiveType(copy.m_primitiveType),
+m_usage        (copy.m_usage)
+{
+    if (copy.m_buffer && create(copy.m_size))
+    {
+        if (GLEW_ARB_copy_buffer)
+        {
+            // Copy the contents directly in the graphics card memory
+            glCheck(glBindBufferARB(GL_COPY_READ_BUFFER, copy.m_buffer));
+            glCheck(glBindBufferARB(GL_COPY_WRITE_BUFFER, m_buffer));
+            glCheck(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(Vertex) * m_size));
+            glCheck(glBindBufferARB(GL_COPY_READ_BUFFER, 0));
+            glCheck(glBindBufferARB(GL_COPY_WRITE_BUFFER, 0));
+        }
+        else
+        {
+            // Read the contents back and upload them again
+            std::vector<Vertex> vertices(m_size);
+            glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, copy.m_buffer));
+            glCheck(glGetBufferSubDataARB(GL_ARRAY_BUFFER_ARB, 0, sizeof(Vertex) * m_size, &vertices[0]));
+            glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0));
+            update(&vertices[0]);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+VertexBuffer::~VertexBuffer()
+{
+    // Destroy the OpenGL buffer
+    if (m_buffer)
+    {
+        ensureGlContext();
+
+        GLuint buffer = static_cast<GLuint>(m_buffer);
+        glCheck(glDeleteBuffersARB(1, &buffer));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool VertexBuffer::create(unsigned int vertexCount)
+{
+    if (!isAvailable())
+    {
+        err() << "Failed to create vertex buffer: your system doesn't support vertex buffer objects" << std::endl;
+        return false;
+    }
+
+    ensureGlContext();
+
+    // Create the OpenGL buffer if it doesn't exist yet
+    if (!m_buffer)
+    {
+        GLuint buffer;
+        glCheck(glGenBuffersARB(1, &buffer));
+        m_buffer = static_cast<unsigned int>(buffer);
+        if (!m_buffer)
+        {
+            err() << "Failed to create vertex buffer (failed to generate the buffer object)" << std::endl;
+            return false;
+        }
+    }
+
+    // Allocate the storage
+    glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffer));
+    glCheck(glBufferDataARB(GL_ARRAY_BUFFER_ARB, sizeof(Vertex) * vertexCount, NULL, usageToGlEnum(m_usage)));
+    glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0));
+
+    m_size = vertexCount;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool VertexBuffer::update(const Vertex* vertices)
+{
+    return update(vertices, m_size, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+bool VertexBuffer::update(const Vertex* vertices, unsigned int vertexCount, unsigned int offset)
+{
+    // Nothing to upload?
+    if (!vertices || (vertexCount == 0))
+        return true;
+
+    // A resize is only allowed when the whole buffer is specified
+    if (offset + vertexCount > m_size)
+    {
+        if (offset != 0)
+        {
+            err() << "Failed to update vertex buffer (range " << offset << "-" << offset + vertexCount
+                  << " is out of the buffer, which contains " << m_size << " vertices)" << std::endl;
+            return false;
+        }
+
+        if (!create(vertexCount))
+            return false;
+    }
+
+    if (!m_buffer)
+        return false;
+
+    ensureGlContext();
+
+    glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffer));
+
+    if ((offset == 0) && (vertexCount == m_size))
+    {
+        // The whole buffer is replaced: specifying a new storage lets the driver
+        // allocate it elsewhere instead of waiting for pending draws to finish
+        glCheck(glBufferDataARB(GL_ARRAY_BUFFER_ARB, sizeof(Vertex) * m_size, vertices, usageToGlEnum(m_usage)));
+    }
+    else
+    {
+        // Only upload the requested range
+        glCheck(glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, sizeof(Vertex) * offset, sizeof(Vertex) * vertexCount, vertices));
+    }
+
+    glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0));
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int VertexBuffer::getVertexCount() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+void VertexBuffer::setPrimitiveType(PrimitiveType type)
+{
+    m_primitiveType = type;
+}
+
+
+////////////////////////////////////////////////////////////
+PrimitiveType VertexBuffer::getPrimitiveType() const
+{
+    return m_primitiveType;
+}
+
+
+////////////////////////////////////////////////////////////
+void VertexBuffer::setUsage(Usage usage)
+{
+    m_usage = usage;
+}
+
+
+////////////////////////////////////////////////////////////
+VertexBuffer::Usage VertexBuffer::getUsage() const
+{
+    return m_usage;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int VertexBuffer::getNativeHandle() const
+{
+    return m_buffer;
+}
+
+
+////////////////////////////////////////////////////////////
+VertexBuffer& VertexBuffer::operator =(const VertexBuffer& right)
+{
+    VertexBuffer temp(right);
+
+    std::swap(m_buffer,        temp.m_buffer);
+    std::swap(m_size,          temp.m_size);
+    std::swap(m_primitiveType, temp.m_primitiveType);
+    std::swap(m_usage,         temp.m_usage);
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+bool VertexBuffer::isAvailable()
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    return GLEW_ARB_vertex_buffer_object != 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void VertexBuffer::draw(RenderTarget& target, RenderStates states) const
+{
+    if (m_buffer && m_size)
+        target.draw(*this, states);
+}
+
+} // namespace sf
@@ -172,241 +172,22 @@ public :
     virtual bool loadFromStream(InputStream& vertexShaderStream, InputStream& geometryShaderStream, InputStream& fragmentShaderStream);
 
     ////////////////////////////////////////////////////////////
-    /// \brief Change a float parameter of the shader
+    /// \brief Change parameters of the shader
     ///
-    /// \a name is the name of the variable to change in the shader.
-    /// The corresponding parameter in the shader must be a float
-    /// (float GLSL type).
+    /// The parameters are handled by sf::Shader, which caches
+    /// their locations and uploads their values when the
+    /// program is bound; see sf::Shader::setParameter.
     ///
-    /// Example:
-    /// \code
-    /// uniform float myparam; // this is the variable in the shader
-    /// \endcode
-    /// \code
-    /// shader.setParameter("myparam", 5.2f);
-    /// \endcode
-    ///
-    /// \param name Name of the parameter in the shader
-    /// \param x    Value to assign
-    ///
-    ////////////////////////////////////////////////////////////
-    void setParameter(const std::string& name, float x);
-
-    ////////////////////////////////////////////////////////////
-    /// \brief Change a 2-components vector parameter of the shader
-    ///
-    /// \a name is the name of the variable to change in the shader.
-    /// The corresponding parameter in the shader must be a 2x1 vector
-    /// (vec2 GLSL type).
-    ///
-    /// Example:
-    /// \code
-    /// uniform vec2 myparam; // this is the variable in the shader
-    /// \endcode
-    /// \code
-    /// shader.setParameter("myparam", 5.2f, 6.0f);
-    /// \endcode
-    ///
-    /// \param name Name of the parameter in the shader
-    /// \param x    First component of the value to assign
-    /// \param y    Second component of the value to assign
-    ///
-    ////////////////////////////////////////////////////////////
-    void setParameter(const std::string& name, float x, float y);
-
-    ////////////////////////////////////////////////////////////
-    /// \brief Change a 3-components vector parameter of the shader
-    ///
-    /// \a name is the name of the variable to change in the shader.
-    /// The corresponding parameter in the shader must be a 3x1 vector
-    /// (vec3 GLSL type).
-    ///
-    /// Example:
-    /// \code
-    /// uniform vec3 myparam; // this is the variable in the shader
-    /// \endcode
-    /// \code
-    /// shader.setParameter("myparam", 5.2f, 6.0f, -8.1f);
-    /// \endcode
-    ///
-    /// \param name Name of the parameter in the shader
-    /// \param x    First component of the value to assign
-    /// \param y    Second component of the value to assign
-    /// \param z    Third component of the value to assign
-    ///
-    ////////////////////////////////////////////////////////////
-    void setParameter(const std::string& name, float x, float y, float z);
-
-    ////////////////////////////////////////////////////////////
-    /// \brief Change a 4-components vector parameter of the shader
-    ///
-    /// \a name is the name of the variable to change in the shader.
-    /// The corresponding parameter in the shader must be a 4x1 vector
-    /// (vec4 GLSL type).
-    ///
-    /// Example:
-    /// \code
-    /// uniform vec4 myparam; // this is the variable in the shader
-    /// \endcode
-    /// \code
-    /// shader.setParameter("myparam", 5.2f, 6.0f, -8.1f, 0.4f);
-    /// \endcode
-    ///
-    /// \param name Name of the parameter in the shader
-    /// \param x    First component of the value to assign
-    /// \param y    Second component of the value to assign
-    /// \param z    Third component of the value to assign
-    /// \param w    Fourth component of the value to assign
-    ///
-    ////////////////////////////////////////////////////////////
-    void setParameter(const std::string& name, float x, float y, float z, float w);
-
     ////////////////////////////////////////////////////////////
-    /// \brief Change a 2-components vector parameter of the shader
-    ///
-    /// \a name is the name of the variable to change in the shader.
-    /// The corresponding parameter in the shader must be a 2x1 vector
-    /// (vec2 GLSL type).
-    ///
-    /// Example:
-    /// \code
-    /// uniform vec2 myparam; // this is the variable in the shader
-    /// \endcode
-    /// \code
-    /// shader.setParameter("myparam", sf::Vector2f(5.2f, 6.0f));
-    /// \endcode
-    ///
-    /// \param name   Name of the parameter in the shader
-    /// \param vector Vector to assign
-    ///
-    ////////////////////////////////////////////////////////////
-    void setParameter(const std::string& name, const Vector2f& vector);
+    using Shader::setParameter;
 
     ////////////////////////////////////////////////////////////
-    /// \brief Change a 3-components vector parameter of the shader
-    ///
-    /// \a name is the name of the variable to change in the shader.
-    /// The corresponding parameter in the shader must be a 3x1 vector
-    /// (vec3 GLSL type).
-    ///
-    /// Example:
-    /// \code
-    /// uniform vec3 myparam; // this is the variable in the shader
-    /// \endcode
-    /// \code
-    /// shader.setParameter("myparam", sf::Vector3f(5.2f, 6.0f, -8.1f));
-    /// \endcode
-    ///
-    /// \param name   Name of the parameter in the shader
-    /// \param vector Vector to assign
-    ///
-    ////////////////////////////////////////////////////////////
-    void setParameter(const std::string& name, const Vector3f& vector);
-
-    ////////////////////////////////////////////////////////////
-    /// \brief Change a color parameter of the shader
-    ///
-    /// \a name is the name of the variable to change in the shader.
-    /// The corresponding parameter in the shader must be a 4x1 vector
-    /// (vec4 GLSL type).
-    ///
-    /// It is important to note that the components of the color are
-    /// normalized before being passed to the shader. Therefore,
-    /// they are converted from range [0 .. 255] to range [0 .. 1].
-    /// For example, a sf::Color(255, 125, 0, 255) will be transformed
-    /// to a vec4(1.0, 0.5, 0.0, 1.0) in the shader.
-    ///
-    /// Example:
-    /// \code
-    /// uniform vec4 color; // this is the variable in the shader
-    /// \endcode
-    /// \code
-    /// shader.setParameter("color", sf::Color(255, 128, 0, 255));
-    /// \endcode
-    ///
-    /// \param name  Name of the parameter in the shader
-    /// \param color Color to assign
-    ///
-    ////////////////////////////////////////////////////////////
-    void setParameter(const std::string& name, const Color& color);
-
-    ////////////////////////////////////////////////////////////
-    /// \brief Change a matrix parameter of the shader
-    ///
-    /// \a name is the name of the variable to change in the shader.
-    /// The corresponding parameter in the shader must be a 4x4 matrix
-    /// (mat4 GLSL type).
-    ///
-    /// Example:
-    /// \code
-    /// uniform mat4 matrix; // this is the variable in the shader
-    /// \endcode
-    /// \code
-    /// sf::Transform transform;
-    /// transform.translate(5, 10);
-    /// shader.setParameter("matrix", transform);
-    /// \endcode
-    ///
-    /// \param name      Name of the parameter in the shader
-    /// \param transform Transform to assign
-    ///
-    ////////////////////////////////////////////////////////////
-    void setParameter(const std::string& name, const sf::Transform& transform);
-
-    ////////////////////////////////////////////////////////////
-    /// \brief Change a texture parameter of the shader
-    ///
-    /// \a name is the name of the variable to change in the shader.
-    /// The corresponding parameter in the shader must be a 2D texture
-    /// (sampler2D GLSL type).
-    ///
-    /// Example:
-    /// \code
-    /// uniform sampler2D the_texture; // this is the variable in the shader
-    /// \endcode
-    /// \code
-    /// sf::Texture texture;
-    /// ...
-    /// shader.setParameter("the_texture", texture);
-    /// \endcode
-    /// It is important to note that \a texture must remain alive as long
-    /// as the shader uses it, no copy is made internally.
-    ///
-    /// To use the texture of the object being draw, which cannot be
-    /// known in advance, you can pass the special value
-    /// sf::Shader::CurrentTexture:
-    /// \code
-    /// shader.setParameter("the_texture", sf::Shader::CurrentTexture).
-    /// \endcode
-    ///
-    /// \param name    Name of the texture in the shader
-    /// \param texture Texture to assign
-    ///
-    ////////////////////////////////////////////////////////////
-    void setParameter(const std::string& name, const Texture& texture);
-
-    ////////////////////////////////////////////////////////////
-    /// \brief Change a texture parameter of the shader
-    ///
-    /// This overload maps a shader texture variable to the
-    /// texture of the object being drawn, which cannot be
-    /// known in advance. The second argument must be
-    /// sf::Shader::CurrentTexture.
-    /// The corresponding parameter in the shader must be a 2D texture
-    /// (sampler2D GLSL type).
-    ///
-    /// Example:
-    /// \code
-    /// uniform sampler2D current; // this is the variable in the shader
-    /// \endcode
-    /// \code
-    /// shader.setParameter("current", sf::Shader::CurrentTexture);
-    /// \endcode
+    /// \brief Get the handle of a parameter of the shader
     ///
-    /// \param name Name of the texture in the shader
+    /// See sf::Shader::getUniformHandle.
     ///
     ////////////////////////////////////////////////////////////
-    void setParameter(const std::string& name, CurrentTextureType);
+    using Shader::getUniformHandle;
 };
 
 } // namespace sf
@@ -326,6 +326,9 @@ bool Window::setActive(bool active) const
 ////////////////////////////////////////////////////////////
 void Window::display()
 {
+    // Let derived classes finish their rendering
+    onDisplay();
+
     // Display the backbuffer on screen
     if (setActive())
         m_context->display();
@@ -360,6 +363,20 @@ void Window::onResize()
 }
 
 
+////////////////////////////////////////////////////////////
+void Window::onDisplay()
+{
+    // Nothing by default
+}
+
+
+////////////////////////////////////////////////////////////
+void Window::onCapture()
+{
+    // Nothing by default
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Window::filterEvent(const Event& event)
 {